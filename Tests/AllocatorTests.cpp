@@ -0,0 +1,270 @@
+//Checks TLSFAllocator against a reference map of live ranges and times allocate/free churn,
+//then grows and compacts LinearAllocator pools while handles into them are live. Exits with 0 when every check passes.
+
+#include "../Wiley/Core/TLSFAllocator.h"
+#include "../Wiley/Core/Allocator.h"
+
+#include <map>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+
+namespace {
+
+	int failures = 0;
+
+	void Fail(const char* test, const char* what)
+	{
+		std::cout << "[FAIL] " << test << ": " << what << std::endl;
+		failures++;
+	}
+
+	struct LiveRange
+	{
+		uint32_t size;
+		Wiley::TLSFAllocator::Allocation allocation;
+	};
+
+	/// <summary>
+	///		Random allocate/free traffic with occasional growth. Every allocation must lie inside the capacity,
+	///		not overlap its neighbours and report its size, and every free must succeed exactly once.
+	/// </summary>
+	void TestRandomTraffic()
+	{
+		constexpr int kIterations = 500000;
+		constexpr uint32_t kMaxSize = 300;
+
+		Wiley::TLSFAllocator tlsf(100000);
+		std::map<uint32_t, LiveRange> live;
+		std::mt19937 rng(7);
+
+		for (int i = 0; i < kIterations; i++)
+		{
+			if (live.empty() || rng() % 2)
+			{
+				const uint32_t size = 1 + rng() % kMaxSize;
+				const Wiley::TLSFAllocator::Allocation allocation = tlsf.Allocate(size);
+				if (!allocation.IsValid())
+					continue;
+
+				const uint32_t offset = allocation.offset;
+				auto next = live.lower_bound(offset);
+				if (offset + size > tlsf.GetCapacity())
+					Fail("RandomTraffic", "allocation ends past the capacity");
+				if (next != live.end() && offset + size > next->first)
+					Fail("RandomTraffic", "allocation overlaps the next live range");
+				if (next != live.begin() && std::prev(next)->first + std::prev(next)->second.size > offset)
+					Fail("RandomTraffic", "allocation overlaps the previous live range");
+				if (tlsf.GetAllocationSize(allocation) != size)
+					Fail("RandomTraffic", "allocation reports the wrong size");
+
+				live[offset] = { size, allocation };
+			}
+			else
+			{
+				auto victim = std::next(live.begin(), rng() % live.size());
+				if (!tlsf.Free(victim->second.allocation))
+					Fail("RandomTraffic", "freeing a live allocation failed");
+				if (tlsf.Free(victim->second.allocation))
+					Fail("RandomTraffic", "double free was accepted");
+				live.erase(victim);
+			}
+
+			if (i % 100000 == 0)
+				tlsf.Grow(tlsf.GetCapacity() + 1000);
+		}
+
+		if (tlsf.GetAllocationCount() != live.size())
+			Fail("RandomTraffic", "allocation count drifted");
+
+		for (const auto& [offset, range] : live)
+			tlsf.Free(range.allocation);
+
+		//Everything merged back into one block, so the whole tail can be given up.
+		const Wiley::TLSFAllocator::Stats stats = tlsf.GetStats();
+		if (stats.used != 0 || stats.freeBlockCount != 1)
+			Fail("RandomTraffic", "free blocks did not merge back into one");
+		if (!tlsf.Shrink(50000) || tlsf.GetCapacity() != 50000)
+			Fail("RandomTraffic", "shrinking an empty allocator failed");
+	}
+
+	void BenchmarkChurn()
+	{
+		constexpr size_t kLiveCount = 4096;
+		constexpr int kRounds = 256;
+
+		Wiley::TLSFAllocator tlsf(8000000);
+		std::vector<Wiley::TLSFAllocator::Allocation> allocations(kLiveCount);
+		std::mt19937 rng(11);
+
+		for (auto& allocation : allocations)
+			allocation = tlsf.Allocate(1 + rng() % 1024);
+
+		const auto start = std::chrono::steady_clock::now();
+		for (int round = 0; round < kRounds; round++)
+		{
+			for (size_t i = round % 2; i < kLiveCount; i += 2)
+			{
+				tlsf.Free(allocations[i]);
+				allocations[i] = tlsf.Allocate(1 + rng() % 1024);
+			}
+		}
+		const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		const size_t operations = static_cast<size_t>(kRounds) * (kLiveCount / 2);
+		std::cout << "TLSF churn: " << operations / milliseconds << " free+allocate pairs/ms, fragmentation "
+			<< tlsf.GetStats().GetFragmentation() << std::endl;
+	}
+
+
+	//Stand-in for a vertex: big enough that a corrupted copy shows up, trivially copyable so Compact can move it.
+	struct PoolElement
+	{
+		uint32_t owner;
+		uint32_t position;
+		float payload[6];
+	};
+
+	struct LiveHandle
+	{
+		Wiley::PoolHandle handle;
+		uint32_t owner;
+		uint32_t count;
+	};
+
+	void FillBlock(Wiley::MemoryBlock<PoolElement> block, uint32_t owner)
+	{
+		for (uint32_t i = 0; i < block.size(); i++)
+			block[i] = { owner, i, { static_cast<float>(owner) } };
+	}
+
+	bool CheckBlocks(const Wiley::LinearAllocator<PoolElement>& pool, const std::vector<LiveHandle>& live)
+	{
+		for (const LiveHandle& entry : live) {
+			if (!pool.IsAlive(entry.handle))
+				return false;
+
+			const Wiley::MemoryBlock<PoolElement> block = pool.Resolve(entry.handle);
+			if (block.size() != entry.count)
+				return false;
+			for (uint32_t i = 0; i < block.size(); i++)
+				if (block[i].owner != entry.owner || block[i].position != i || block[i].payload[0] != static_cast<float>(entry.owner))
+					return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	///		Starts a pool far too small for the frame, so allocations made while earlier handles are live force it to grow.
+	///		Every live handle must resolve to its own contents after each growth, after frees in the middle and after Compact,
+	///		and handles freed along the way must stay dead once their slot is reused.
+	/// </summary>
+	void TestHandleGrowth(const char* test, Wiley::LinearAllocator<PoolElement>& pool)
+	{
+		constexpr uint32_t kHandleCount = 2000;
+		constexpr uint32_t kMaxCount = 200;
+
+		if (!pool.Initialize()) {
+			Fail(test, "pool failed to initialize");
+			return;
+		}
+
+		std::mt19937 rng(13);
+		std::vector<LiveHandle> live;
+		std::vector<Wiley::PoolHandle> freed;
+		size_t growthCount = 0;
+
+		for (uint32_t owner = 0; owner < kHandleCount; owner++)
+		{
+			const size_t capacity = pool.GetCapacity();
+			const uint32_t count = 1 + rng() % kMaxCount;
+			const Wiley::PoolHandle handle = pool.AllocateHandle(count);
+			if (!handle.IsValid()) {
+				Fail(test, "allocation failed instead of growing the pool");
+				return;
+			}
+			FillBlock(pool.Resolve(handle), owner);
+			live.push_back({ handle, owner, count });
+
+			if (pool.GetCapacity() != capacity) {
+				growthCount++;
+				if (!CheckBlocks(pool, live)) {
+					Fail(test, "a live handle lost its contents when the pool grew");
+					return;
+				}
+			}
+
+			//Free every third block so growth and reuse interleave with holes in the pool.
+			if (owner % 3 == 2) {
+				const size_t victim = rng() % live.size();
+				if (!pool.Deallocate(live[victim].handle)) {
+					Fail(test, "freeing a live handle failed");
+					return;
+				}
+				freed.push_back(live[victim].handle);
+				live.erase(live.begin() + victim);
+			}
+		}
+
+		if (growthCount == 0)
+			Fail(test, "the pool never grew, the test is not exercising growth");
+		if (!CheckBlocks(pool, live))
+			Fail(test, "a live handle lost its contents");
+		if (std::any_of(freed.begin(), freed.end(), [&pool](Wiley::PoolHandle handle) { return pool.IsAlive(handle); }))
+			Fail(test, "a freed handle is alive again after its slot was reused");
+
+		if (!pool.Compact())
+			Fail(test, "compacting a handle-only pool failed");
+		if (!CheckBlocks(pool, live))
+			Fail(test, "a live handle lost its contents when the pool was compacted");
+
+		size_t liveElements = 0;
+		for (const LiveHandle& entry : live)
+			liveElements += entry.count;
+		if (pool.GetReach() != liveElements * sizeof(PoolElement))
+			Fail(test, "compacting left holes below the top of the pool");
+	}
+
+	/// <summary>
+	///		The vertex, index and submesh pools reserve their maximum up front because they sit in fixed-size upload heaps.
+	///		Loads a scene's worth of submeshes into a growable pool one handle at a time and prints its capacity
+	///		next to the fixed MAX_SUBMESH_COUNT reservation for the same element type.
+	/// </summary>
+	void ReportReservation()
+	{
+		constexpr uint32_t kFixedReservation = 100'000;
+		constexpr uint32_t kSceneSubMeshCount = 2'000;
+
+		Wiley::LinearAllocator<PoolElement> pool(64);
+		pool.Initialize();
+		for (uint32_t i = 0; i < kSceneSubMeshCount; i++)
+			if (!pool.AllocateHandle(1).IsValid())
+				Fail("Reservation", "allocation failed instead of growing the pool");
+
+		std::cout << "Growable pool: " << pool.GetCapacity() << " bytes for " << kSceneSubMeshCount << " submeshes, fixed reservation: "
+			<< static_cast<size_t>(kFixedReservation) * sizeof(PoolElement) << " bytes" << std::endl;
+	}
+
+}
+
+int main()
+{
+	TestRandomTraffic();
+	BenchmarkChurn();
+
+	{
+		Wiley::LinearAllocator<PoolElement> heapPool(64);
+		TestHandleGrowth("HeapHandleGrowth", heapPool);
+
+		Wiley::LinearAllocator<PoolElement> virtualPool(64, 1 << 20, Wiley::MemoryTag::General);
+		TestHandleGrowth("VirtualHandleGrowth", virtualPool);
+	}
+	ReportReservation();
+
+	std::cout << (failures == 0 ? "All allocator checks passed." : "Allocator checks failed.") << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+//Posts DeferredEvents from pool workers and plain threads at once and checks what Dispatch delivers:
+//every event exactly once in per-producer order, and each payload once when coalescing. Exits with 0 when every check passes.
+
+#include "../Wiley/Core/DeferredEvent.h"
+#include "../Wiley/Core/ThreadPool.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+
+	constexpr uint32_t kWorkerProducerCount = 32;
+	constexpr uint32_t kExternalProducerCount = 4;
+	constexpr uint32_t kProducerCount = kWorkerProducerCount + kExternalProducerCount;
+	constexpr uint32_t kPostsPerProducer = 5000;
+
+	int failures = 0;
+
+	void Fail(const char* test, const char* what)
+	{
+		std::cout << "[FAIL] " << test << ": " << what << std::endl;
+		failures++;
+	}
+
+	struct Posted
+	{
+		uint32_t producer;
+		uint32_t sequence;
+	};
+
+	/// <summary>
+	///		Runs produce(producer) on kWorkerProducerCount pool tasks and kExternalProducerCount std::threads,
+	///		calling dispatch on this thread the whole time so Dispatch races with Post. Returns once every producer is done.
+	/// </summary>
+	template<typename Produce, typename DispatchFn>
+	void RunProducers(Produce&& produce, DispatchFn&& dispatch)
+	{
+		Wiley::TaskCounter counter;
+		for (uint32_t producer = 0; producer < kWorkerProducerCount; producer++)
+			Wiley::ThreadPool::GetThreadPool().Submit([&produce, producer]() { produce(producer); }, counter);
+
+		std::atomic<uint32_t> externalDone{ 0 };
+		std::vector<std::thread> threads;
+		for (uint32_t producer = kWorkerProducerCount; producer < kProducerCount; producer++)
+			threads.emplace_back([&produce, &externalDone, producer]() {
+				produce(producer);
+				externalDone++;
+			});
+
+		while (!counter.IsDone() || externalDone.load() != kExternalProducerCount)
+			dispatch();
+
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	void TestExactDelivery()
+	{
+		Wiley::DeferredEvent<Posted> event;
+
+		std::vector<uint32_t> deliveredCount(kProducerCount, 0);
+		std::vector<uint32_t> nextSequence(kProducerCount, 0);
+		bool outOfOrder = false;
+		event.AddLambda([&](const Posted& posted) {
+			deliveredCount[posted.producer]++;
+			if (posted.sequence != nextSequence[posted.producer])
+				outOfOrder = true;
+			nextSequence[posted.producer] = posted.sequence + 1;
+		});
+
+		size_t dispatched = 0;
+		RunProducers([&event](uint32_t producer) {
+			for (uint32_t sequence = 0; sequence < kPostsPerProducer; sequence++)
+				event.Post({ producer, sequence });
+		}, [&]() { dispatched += event.Dispatch(); });
+
+		//Whatever was posted after the last Dispatch inside the loop.
+		dispatched += event.Dispatch();
+
+		if (dispatched != static_cast<size_t>(kProducerCount) * kPostsPerProducer)
+			Fail("ExactDelivery", "Dispatch did not report every posted event exactly once");
+		for (uint32_t producer = 0; producer < kProducerCount; producer++) {
+			if (deliveredCount[producer] != kPostsPerProducer) {
+				Fail("ExactDelivery", "a producer's events were lost or delivered twice");
+				break;
+			}
+		}
+		if (outOfOrder)
+			Fail("ExactDelivery", "a producer's events were delivered out of posting order");
+		if (event.Dispatch() != 0)
+			Fail("ExactDelivery", "a second Dispatch delivered events again");
+	}
+
+	void TestCoalesce()
+	{
+		constexpr uint32_t kDistinctCount = 1000;
+
+		Wiley::DeferredEvent<uint32_t, true> event;
+
+		std::vector<uint32_t> deliveredCount(kDistinctCount, 0);
+		std::vector<uint32_t> delivered;
+		event.AddLambda([&](const uint32_t& id) {
+			deliveredCount[id]++;
+			delivered.push_back(id);
+		});
+
+		//Every producer marks every id dirty several times, from both kinds of thread.
+		RunProducers([&event](uint32_t producer) {
+			for (uint32_t i = 0; i < kPostsPerProducer; i++)
+				event.Post((producer + i) % kDistinctCount);
+		}, []() {});
+
+		const size_t dispatched = event.Dispatch();
+
+		if (dispatched != kDistinctCount)
+			Fail("Coalesce", "Dispatch did not drop duplicates down to one event per payload");
+		for (uint32_t id = 0; id < kDistinctCount; id++) {
+			if (deliveredCount[id] != 1) {
+				Fail("Coalesce", "a payload was not delivered exactly once");
+				break;
+			}
+		}
+		for (size_t i = 1; i < delivered.size(); i++) {
+			if (delivered[i - 1] >= delivered[i]) {
+				Fail("Coalesce", "coalesced events were not delivered in sorted order");
+				break;
+			}
+		}
+	}
+
+	void TestPostDuringDispatch()
+	{
+		Wiley::DeferredEvent<uint32_t> event;
+
+		uint32_t deliveredCount = 0;
+		event.AddLambda([&](const uint32_t& depth) {
+			deliveredCount++;
+			if (depth == 0)
+				event.Post(1);
+		});
+
+		event.Post(0);
+		if (event.Dispatch() != 1 || deliveredCount != 1)
+			Fail("PostDuringDispatch", "an event posted by a listener was delivered in the same Dispatch");
+		if (event.Dispatch() != 1 || deliveredCount != 2)
+			Fail("PostDuringDispatch", "an event posted by a listener was not delivered by the next Dispatch");
+	}
+
+}
+
+int main()
+{
+	Wiley::ThreadPool::GetThreadPool().Initialize();
+	std::cout << "Workers: " << Wiley::ThreadPool::GetThreadPool().GetWorkerCount() << std::endl;
+
+	TestExactDelivery();
+	TestCoalesce();
+	TestPostDuringDispatch();
+
+	Wiley::ThreadPool::GetThreadPool().Shutdown();
+
+	std::cout << (failures == 0 ? "All deferred event checks passed." : "Deferred event checks failed.") << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+//Checks FlatHashMap against std::unordered_map under random insert/erase/lookup traffic
+//and checks probe lengths stay near what linear probing predicts. Exits with 0 when every check passes.
+
+#include "../Wiley/Core/FlatHashMap.h"
+
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+	int failures = 0;
+
+	void Fail(const char* test, const char* what)
+	{
+		std::cout << "[FAIL] " << test << ": " << what << std::endl;
+		failures++;
+	}
+
+	template<typename Map, typename Reference>
+	bool SameContents(const Map& map, const Reference& reference)
+	{
+		if (map.size() != reference.size())
+			return false;
+
+		size_t visited = 0;
+		for (const auto& [key, value] : map) {
+			const auto it = reference.find(key);
+			if (it == reference.end() || it->second != value)
+				return false;
+			visited++;
+		}
+		return visited == reference.size();
+	}
+
+	/// <summary>
+	///		Mixed traffic over a key range small enough that most operations hit existing keys,
+	///		so erase has to shift runs back and inserts land in slots freed that way. Every result is compared with std::unordered_map.
+	/// </summary>
+	void TestRandomized()
+	{
+		constexpr int kOperationCount = 1'000'000;
+		constexpr uint64_t kKeyRange = 50'000;
+
+		Wiley::FlatHashMap<uint64_t, uint64_t> map;
+		std::unordered_map<uint64_t, uint64_t> reference;
+		std::mt19937_64 rng(17);
+
+		for (int i = 0; i < kOperationCount; i++)
+		{
+			const uint64_t key = rng() % kKeyRange;
+			const uint64_t value = rng();
+
+			switch (rng() % 6)
+			{
+			case 0: {
+				const bool inserted = map.try_emplace(key, value).second;
+				if (inserted != reference.try_emplace(key, value).second)
+					Fail("Randomized", "try_emplace disagreed about whether the key was new");
+				break;
+			}
+			case 1:
+				map.insert_or_assign(key, value);
+				reference.insert_or_assign(key, value);
+				break;
+			case 2:
+				map[key] += value;
+				reference[key] += value;
+				break;
+			case 3:
+			case 4:
+				if (map.erase(key) != reference.erase(key))
+					Fail("Randomized", "erase disagreed about whether the key existed");
+				break;
+			case 5: {
+				const auto it = map.find(key);
+				const auto expected = reference.find(key);
+				if ((it == map.end()) != (expected == reference.end()) || map.contains(key) != (expected != reference.end()))
+					Fail("Randomized", "find or contains disagreed about whether the key existed");
+				else if (it != map.end() && it->second != expected->second)
+					Fail("Randomized", "find returned the wrong value");
+				break;
+			}
+			}
+
+			if (failures)
+				return;
+
+			if (i % 100'000 == 0) {
+				if (!SameContents(map, reference)) {
+					Fail("Randomized", "contents drifted from std::unordered_map");
+					return;
+				}
+
+				//Copies and moves must carry every entry over.
+				Wiley::FlatHashMap<uint64_t, uint64_t> copy(map);
+				Wiley::FlatHashMap<uint64_t, uint64_t> moved(std::move(copy));
+				if (!SameContents(moved, reference))
+					Fail("Randomized", "a copied and moved map lost entries");
+			}
+		}
+
+		if (!SameContents(map, reference))
+			Fail("Randomized", "contents drifted from std::unordered_map");
+
+		map.clear();
+		if (!map.empty() || map.begin() != map.end() || map.contains(0))
+			Fail("Randomized", "clear left entries behind");
+	}
+
+	/// <summary>
+	///		Mean displacement of a successful lookup under linear probing at load factor alpha, (1 / (1 - alpha) - 1) / 2.
+	/// </summary>
+	float ExpectedProbeLength(float loadFactor)
+	{
+		return 0.5f * (1.0f / (1.0f - loadFactor) - 1.0f);
+	}
+
+	template<typename Key>
+	void CheckProbeLength(const char* name, const std::vector<Key>& keys)
+	{
+		Wiley::FlatHashMap<Key, uint32_t> map;
+		for (const Key& key : keys)
+			map.try_emplace(key, 0u);
+
+		const float loadFactor = static_cast<float>(map.size()) / static_cast<float>(map.bucket_count());
+		const float expected = ExpectedProbeLength(loadFactor);
+		const float fresh = map.GetAverageProbeLength();
+
+		//Erase and reinsert half the keys over and over. Backward-shift deletion leaves no tombstones, so the table should look freshly built.
+		std::mt19937 rng(23);
+		for (int round = 0; round < 20; round++) {
+			for (size_t i = rng() % 2; i < keys.size(); i += 2)
+				map.erase(keys[i]);
+			for (size_t i = 0; i < keys.size(); i++)
+				map.try_emplace(keys[i], 0u);
+		}
+		const float churned = map.GetAverageProbeLength();
+
+		std::cout << "Probe length (" << name << "): " << fresh << " fresh, " << churned << " after churn, "
+			<< expected << " expected at load " << loadFactor << std::endl;
+
+		//A weak hash mixer clusters keys like these and blows well past the uniform-hash prediction.
+		if (fresh > 2.0f * expected + 0.5f)
+			Fail("ProbeLength", name);
+		if (churned > 1.5f * fresh + 0.25f)
+			Fail("ProbeLength", "probe length degraded under erase/insert churn");
+	}
+
+	void TestProbeLength()
+	{
+		constexpr size_t kKeyCount = 100'000;
+
+		//std::hash<uint64_t> is the identity, so these only spread out if FlatHashMap remixes them.
+		std::vector<uint64_t> sequential(kKeyCount);
+		std::vector<uint64_t> aligned(kKeyCount);
+		for (size_t i = 0; i < kKeyCount; i++) {
+			sequential[i] = i;
+			aligned[i] = i * 4096;
+		}
+
+		std::vector<Wiley::UUID> uuids(kKeyCount);
+		std::mt19937_64 rng(29);
+		for (Wiley::UUID& uuid : uuids)
+			uuid = { rng(), rng() };
+
+		CheckProbeLength("sequential integers", sequential);
+		CheckProbeLength("page-aligned integers", aligned);
+		CheckProbeLength("random UUIDs", uuids);
+	}
+
+}
+
+int main()
+{
+	TestRandomized();
+	TestProbeLength();
+
+	std::cout << (failures == 0 ? "All flat hash map checks passed." : "Flat hash map checks failed.") << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+//Runs a frame loop over a FrameAllocator and checks the arenas stop going to the heap once every frame slot has seen the largest frame.
+//Exits with 0 when every check passes.
+
+#include "../Wiley/Core/FrameAllocator.h"
+
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+	constexpr uint32_t kFramesInFlight = 3;
+	constexpr int kFrameCount = 1000;
+
+	//Small blocks so the largest frame needs several of them and the merge on Reset has something to do.
+	constexpr size_t kBlockSize = 16 * 1024;
+
+	constexpr size_t kMaxIndexCount = 20000;
+	constexpr size_t kMaxMatrixCount = 2000;
+
+	int failures = 0;
+
+	void Fail(const char* test, const char* what)
+	{
+		std::cout << "[FAIL] " << test << ": " << what << std::endl;
+		failures++;
+	}
+
+	struct Matrix
+	{
+		float m[16];
+	};
+
+	size_t Sum(const std::vector<size_t>& counts)
+	{
+		size_t sum = 0;
+		for (size_t count : counts)
+			sum += count;
+		return sum;
+	}
+
+	/// <summary>
+	///		Fills two FrameVectors without reserving, so they grow and leave their old storage behind like real per-frame scratch lists.
+	///		Interleaving the pushes means overlapping allocations would corrupt the values read back at the end.
+	/// </summary>
+	bool FillFrame(Wiley::FrameArena& arena, size_t indexCount, size_t matrixCount)
+	{
+		Wiley::FrameVector<uint32_t> indices{ Wiley::FrameStlAllocator<uint32_t>(arena) };
+		Wiley::FrameVector<Matrix> matrices{ Wiley::FrameStlAllocator<Matrix>(arena) };
+
+		for (size_t i = 0; i < std::max(indexCount, matrixCount); i++) {
+			if (i < indexCount)
+				indices.push_back(static_cast<uint32_t>(i));
+			if (i < matrixCount)
+				matrices.push_back({ { static_cast<float>(i) } });
+		}
+
+		for (size_t i = 0; i < indexCount; i++)
+			if (indices[i] != i)
+				return false;
+		for (size_t i = 0; i < matrixCount; i++)
+			if (matrices[i].m[0] != static_cast<float>(i))
+				return false;
+		return true;
+	}
+
+	void TestSteadyFrameLoop()
+	{
+		Wiley::FrameAllocator allocator;
+		allocator.Initialize(kFramesInFlight, kBlockSize);
+		std::mt19937 rng(5);
+
+		//Heap allocations so far, per frame slot. Reset can allocate too, so a slot is read after its BeginFrame.
+		std::vector<size_t> slotCounts(kFramesInFlight, 0);
+
+		//Warm-up: every frame slot sees the largest frame twice, once to grow its blocks and once to run on the merged block.
+		constexpr int kWarmupFrames = 2 * kFramesInFlight;
+
+		size_t warmCount = 0;
+		for (int frame = 0; frame < kFrameCount; frame++)
+		{
+			if (frame == kWarmupFrames)
+				warmCount = Sum(slotCounts);
+
+			allocator.BeginFrame(frame);
+			Wiley::FrameArena& arena = allocator.GetArena();
+			if (arena.GetUsed() != 0) {
+				Fail("SteadyFrameLoop", "BeginFrame did not reset the arena");
+				return;
+			}
+
+			const bool largest = frame < kWarmupFrames;
+			const size_t indexCount = largest ? kMaxIndexCount : rng() % (kMaxIndexCount + 1);
+			const size_t matrixCount = largest ? kMaxMatrixCount : rng() % (kMaxMatrixCount + 1);
+
+			if (!FillFrame(arena, indexCount, matrixCount)) {
+				Fail("SteadyFrameLoop", "frame allocations overlapped");
+				return;
+			}
+
+			slotCounts[frame % kFramesInFlight] = arena.GetBlockAllocationCount();
+		}
+
+		const size_t finalCount = Sum(slotCounts);
+		std::cout << "Block allocations: " << warmCount << " after warm-up, " << finalCount << " after " << kFrameCount << " frames" << std::endl;
+
+		if (warmCount <= kFramesInFlight)
+			Fail("SteadyFrameLoop", "the largest frame fit in one block, the test is not exercising growth");
+		if (finalCount != warmCount)
+			Fail("SteadyFrameLoop", "the arenas kept allocating after warm-up");
+	}
+
+}
+
+int main()
+{
+	TestSteadyFrameLoop();
+
+	std::cout << (failures == 0 ? "All frame allocator checks passed." : "Frame allocator checks failed.") << std::endl;
+	return failures == 0 ? 0 : 1;
+}
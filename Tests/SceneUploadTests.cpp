@@ -0,0 +1,216 @@
+//Runs the transform and mesh filter update without a renderer and reports the bytes ComputeSceneDrawPass would copy per frame
+//when 0%, 1% and 100% of the mesh filters move. Checks that static frames upload nothing. Exits with 0 when every check passes.
+
+#include "../Wiley/Scene/Systems/TransformSystem.h"
+#include "../Wiley/Scene/MeshFilterTracker.h"
+#include "../Wiley/Scene/Component.h"
+#include "../Wiley/Core/DirtyRangeTracker.h"
+#include "../Wiley/Core/ThreadPool.h"
+
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+	constexpr size_t kMeshFilterCount = 20'000;
+	constexpr uint32_t kMaxSubMeshesPerFilter = 4;
+
+	constexpr int kFrameCount = 100;
+
+	int failures = 0;
+
+	void Fail(const char* test, const char* what)
+	{
+		std::cout << "[FAIL] " << test << ": " << what << std::endl;
+		failures++;
+	}
+
+	struct FrameUpload
+	{
+		uint64_t meshFilterBytes = 0;
+		uint64_t subMeshBytes = 0;
+		size_t rangeCount = 0;
+	};
+
+	/// <summary>
+	///		The scene state ComputeSceneDrawPass uploads from: mesh filters with their transforms, and the sub-mesh array they index into.
+	///		Frame runs the same steps as a scene frame, TransformSystem then MeshFilterSystem's write, then consumes the dirty ranges
+	///		the way the pass does.
+	/// </summary>
+	struct UploadScene
+	{
+		UploadScene()
+		{
+			tracker.Connect(registry, kMeshFilterCount);
+
+			std::mt19937 rng(37);
+			uint32_t subMeshOffset = 0;
+			entities.reserve(kMeshFilterCount);
+			for (size_t i = 0; i < kMeshFilterCount; i++)
+			{
+				const entt::entity entity = registry.create();
+				entities.push_back(entity);
+				registry.emplace<Wiley::TransformComponent>(entity);
+
+				Wiley::MeshFilterComponent meshFilter;
+				meshFilter.subMeshCount = 1 + rng() % kMaxSubMeshesPerFilter;
+				meshFilter.subMeshDataOffset = subMeshOffset;
+				subMeshOffset += meshFilter.subMeshCount;
+				registry.emplace<Wiley::MeshFilterComponent>(entity, meshFilter);
+			}
+
+			subMeshData.resize(subMeshOffset);
+			subMeshDataDirty.Resize(subMeshOffset);
+		}
+
+		FrameUpload Frame()
+		{
+			transformSystem.Update(registry);
+			tracker.WriteChangedTransforms(transformSystem.GetChangedEntities(), subMeshData.data(), subMeshDataDirty);
+
+			FrameUpload upload;
+			ranges.clear();
+			upload.meshFilterBytes = tracker.ConsumeUploadRanges(ranges);
+			upload.subMeshBytes = subMeshDataDirty.Consume(ranges, sizeof(Wiley::SubMeshData));
+			upload.rangeCount = ranges.size();
+			return upload;
+		}
+
+		uint64_t GetFullUploadBytes()const
+		{
+			return kMeshFilterCount * sizeof(Wiley::MeshFilterComponent) + subMeshData.size() * sizeof(Wiley::SubMeshData);
+		}
+
+		bool SubMeshDataMatchesTransforms()
+		{
+			for (entt::entity entity : entities)
+			{
+				const Wiley::MeshFilterComponent& meshFilter = registry.get<Wiley::MeshFilterComponent>(entity);
+				const Wiley::TransformComponent& transform = registry.get<Wiley::TransformComponent>(entity);
+				for (uint32_t i = 0; i < meshFilter.subMeshCount; i++)
+					if (std::memcmp(&subMeshData[meshFilter.subMeshDataOffset + i].modelMatrix, &transform.modelMatrix, sizeof(transform.modelMatrix)) != 0)
+						return false;
+			}
+			return true;
+		}
+
+		entt::registry registry;
+		Wiley::MeshFilterTracker tracker;
+		Wiley::TransformSystem transformSystem{ nullptr };
+
+		std::vector<entt::entity> entities;
+		std::vector<Wiley::SubMeshData> subMeshData;
+		Wiley::DirtyRangeTracker subMeshDataDirty;
+		std::vector<Wiley::DirtyRange> ranges;
+	};
+
+	/// <summary>
+	///		Moves fraction of the mesh filters and returns how many sub-mesh slots that has to rewrite.
+	/// </summary>
+	uint64_t MoveEntities(UploadScene& scene, double fraction, std::mt19937& rng)
+	{
+		std::vector<bool> moved(scene.entities.size(), false);
+		const size_t moverCount = static_cast<size_t>(static_cast<double>(scene.entities.size()) * fraction);
+
+		std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+		for (size_t i = 0; i < moverCount; i++)
+		{
+			const size_t index = (moverCount == scene.entities.size()) ? i : rng() % scene.entities.size();
+			scene.registry.get<Wiley::TransformComponent>(scene.entities[index]).SetPosition({ distribution(rng), distribution(rng), distribution(rng) });
+			moved[index] = true;
+		}
+
+		uint64_t subMeshCount = 0;
+		for (size_t i = 0; i < moved.size(); i++)
+			if (moved[i])
+				subMeshCount += scene.registry.get<Wiley::MeshFilterComponent>(scene.entities[i]).subMeshCount;
+		return subMeshCount;
+	}
+
+	void TestFirstFrame(UploadScene& scene)
+	{
+		//New mesh filters and transforms are dirty, the first frame uploads everything once.
+		const FrameUpload upload = scene.Frame();
+		if (upload.meshFilterBytes + upload.subMeshBytes != scene.GetFullUploadBytes())
+			Fail("FirstFrame", "the first frame did not upload every mesh filter and sub-mesh exactly once");
+		if (upload.rangeCount != 2)
+			Fail("FirstFrame", "a fully dirty buffer was not coalesced into one range");
+	}
+
+	void BenchmarkMovers(UploadScene& scene)
+	{
+		constexpr double kFractions[] = { 0.0, 0.01, 1.0 };
+
+		std::mt19937 rng(41);
+		for (double fraction : kFractions)
+		{
+			const char* test = fraction == 0.0 ? "Static" : (fraction == 1.0 ? "AllMoving" : "OnePercent");
+
+			uint64_t totalBytes = 0;
+			size_t totalRanges = 0;
+			for (int frame = 0; frame < kFrameCount; frame++)
+			{
+				const uint64_t movedSubMeshes = MoveEntities(scene, fraction, rng);
+				const FrameUpload upload = scene.Frame();
+				totalBytes += upload.meshFilterBytes + upload.subMeshBytes;
+				totalRanges += upload.rangeCount;
+
+				//Moving changes world matrices only, the MeshFilterComponents themselves stay put on the GPU.
+				if (upload.meshFilterBytes != 0) {
+					Fail(test, "moving entities re-uploaded mesh filter components");
+					break;
+				}
+				//Ranges may swallow a few clean slots between dirty ones, never miss a dirty one.
+				const uint64_t movedBytes = movedSubMeshes * sizeof(Wiley::SubMeshData);
+				if (upload.subMeshBytes < movedBytes || (movedBytes == 0 && upload.subMeshBytes != 0)) {
+					Fail(test, "the sub-mesh upload does not cover exactly the moved entities");
+					break;
+				}
+			}
+
+			if (!scene.SubMeshDataMatchesTransforms())
+				Fail(test, "a sub-mesh slot does not hold its entity's world matrix");
+
+			const double bytesPerFrame = static_cast<double>(totalBytes) / kFrameCount;
+			std::cout << "Upload, " << fraction * 100.0 << "% moving: " << static_cast<uint64_t>(bytesPerFrame) << " bytes per frame in "
+				<< static_cast<double>(totalRanges) / kFrameCount << " ranges (" << 100.0 * bytesPerFrame / static_cast<double>(scene.GetFullUploadBytes())
+				<< "% of the " << scene.GetFullUploadBytes() << " byte full upload)" << std::endl;
+
+			if (fraction == 1.0 && totalBytes != kFrameCount * scene.subMeshData.size() * sizeof(Wiley::SubMeshData))
+				Fail(test, "moving everything did not upload every sub-mesh");
+		}
+	}
+
+	void TestComponentPatch(UploadScene& scene)
+	{
+		//Editing a mesh filter without moving it re-uploads that one component and no sub-mesh data.
+		scene.registry.patch<Wiley::MeshFilterComponent>(scene.entities[kMeshFilterCount / 2], [](Wiley::MeshFilterComponent& meshFilter) {
+			meshFilter.padding = 1;
+		});
+		const FrameUpload upload = scene.Frame();
+		if (upload.meshFilterBytes != sizeof(Wiley::MeshFilterComponent) || upload.subMeshBytes != 0)
+			Fail("ComponentPatch", "patching one mesh filter did not upload exactly that component");
+	}
+
+}
+
+int main()
+{
+	Wiley::ThreadPool::GetThreadPool().Initialize();
+	std::cout << "Workers: " << Wiley::ThreadPool::GetThreadPool().GetWorkerCount() << std::endl;
+
+	{
+		UploadScene scene;
+		TestFirstFrame(scene);
+		BenchmarkMovers(scene);
+		TestComponentPatch(scene);
+	}
+
+	Wiley::ThreadPool::GetThreadPool().Shutdown();
+
+	std::cout << (failures == 0 ? "All scene upload checks passed." : "Scene upload checks failed.") << std::endl;
+	return failures == 0 ? 0 : 1;
+}
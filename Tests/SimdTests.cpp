@@ -0,0 +1,313 @@
+//Checks that every SimdPath of the batch kernels agrees with the scalar path and with a straightforward reference.
+//Exits with 0 when every check passes. Paths the CPU cannot run are reported and skipped.
+
+#include "../Wiley/Core/SimdSupport.h"
+#include "../Wiley/Core/TransformBatch.h"
+#include "../Wiley/Core/FrustumCulling.h"
+
+#include <DirectXMath.h>
+
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <random>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+
+using namespace DirectX;
+
+namespace {
+
+	constexpr Wiley::SimdPath kPaths[] = { Wiley::SimdPath::Scalar, Wiley::SimdPath::SSE, Wiley::SimdPath::AVX };
+	constexpr const char* kPathNames[] = { "scalar", "sse", "avx" };
+
+	int failures = 0;
+
+	void Fail(const char* test, const char* path, const char* what)
+	{
+		std::cout << "[FAIL] " << test << " (" << path << "): " << what << std::endl;
+		failures++;
+	}
+
+	struct TransformData
+	{
+		std::vector<float> streams[9];
+
+		Wiley::TransformStreams GetStreams()const
+		{
+			return {
+				streams[0].data(), streams[1].data(), streams[2].data(),
+				streams[3].data(), streams[4].data(), streams[5].data(),
+				streams[6].data(), streams[7].data(), streams[8].data()
+			};
+		}
+	};
+
+	/// <summary>
+	///		TransformSystem's per-entity composition before it was batched, which every path must reproduce.
+	/// </summary>
+	XMFLOAT4X4 ComposeReference(const TransformData& data, size_t i)
+	{
+		const XMMATRIX scaling = XMMatrixScaling(data.streams[6][i], data.streams[7][i], data.streams[8][i]);
+		const XMMATRIX rotation = XMMatrixRotationX(XMConvertToRadians(data.streams[3][i]))
+			* XMMatrixRotationY(XMConvertToRadians(data.streams[4][i]))
+			* XMMatrixRotationZ(XMConvertToRadians(data.streams[5][i]));
+		const XMMATRIX translation = XMMatrixTranslation(data.streams[0][i], data.streams[1][i], data.streams[2][i]);
+
+		XMFLOAT4X4 result;
+		XMStoreFloat4x4(&result, XMMatrixTranspose(translation * rotation * scaling));
+		return result;
+	}
+
+	void TestComposeTransforms()
+	{
+		//Odd so the SIMD paths finish with a scalar remainder.
+		constexpr size_t kCount = 10007;
+		constexpr double kTolerance = 1e-5;
+
+		std::mt19937 rng(22);
+		std::uniform_real_distribution<float> position(-1000.0f, 1000.0f), rotation(-720.0f, 720.0f), scale(0.01f, 10.0f);
+
+		TransformData data;
+		for (auto& stream : data.streams)
+			stream.resize(kCount);
+		for (size_t i = 0; i < kCount; i++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				data.streams[k][i] = position(rng);
+				data.streams[3 + k][i] = rotation(rng);
+				data.streams[6 + k][i] = scale(rng);
+			}
+		}
+
+		//Quadrant boundaries, large angles and a mirrored scale.
+		const float edges[] = { 0.0f, 90.0f, -90.0f, 180.0f, -180.0f, 270.0f, 360.0f, 45.0f, 1e5f, -1e5f, 0.0001f };
+		constexpr size_t kEdgeCount = std::size(edges);
+		for (size_t k = 0; k < kEdgeCount; k++)
+		{
+			data.streams[3][k] = edges[k];
+			data.streams[4][k] = edges[(k + 3) % kEdgeCount];
+			data.streams[5][k] = edges[(k + 7) % kEdgeCount];
+			data.streams[6][k] = -1.5f;
+		}
+
+		std::vector<XMFLOAT4X4> scalar(kCount);
+		Wiley::ComposeTransforms(Wiley::SimdPath::Scalar, data.GetStreams(), kCount, scalar.data());
+
+		double maxError = 0.0;
+		for (size_t i = 0; i < kCount; i++)
+		{
+			const XMFLOAT4X4 reference = ComposeReference(data, i);
+
+			double magnitude = 1e-6;
+			for (int r = 0; r < 4; r++)
+				for (int c = 0; c < 4; c++)
+					magnitude = std::max(magnitude, static_cast<double>(std::fabs(reference.m[r][c])));
+
+			for (int r = 0; r < 4; r++)
+				for (int c = 0; c < 4; c++)
+					maxError = std::max(maxError, std::fabs(static_cast<double>(scalar[i].m[r][c]) - reference.m[r][c]) / magnitude);
+		}
+		if (maxError > kTolerance)
+			Fail("ComposeTransforms", "scalar", "differs from DirectXMath");
+
+		for (size_t p = 1; p < std::size(kPaths); p++)
+		{
+			if (!Wiley::IsSimdPathSupported(kPaths[p])) {
+				std::cout << "[SKIP] ComposeTransforms (" << kPathNames[p] << ")" << std::endl;
+				continue;
+			}
+
+			std::vector<XMFLOAT4X4> result(kCount);
+			Wiley::ComposeTransforms(kPaths[p], data.GetStreams(), kCount, result.data());
+
+			//Same arithmetic in every lane, so anything but an exact match is a bug in the kernel.
+			if (std::memcmp(result.data(), scalar.data(), kCount * sizeof(XMFLOAT4X4)) != 0)
+				Fail("ComposeTransforms", kPathNames[p], "not bit-identical to the scalar path");
+		}
+
+		std::cout << "ComposeTransforms: max relative error against DirectXMath " << maxError << std::endl;
+	}
+
+	struct Box
+	{
+		XMFLOAT3 min, max;
+		XMFLOAT4X4 modelMatrix;
+	};
+
+	/// <summary>
+	///		Brute-force visibility in double: transforms the 8 corners into a world AABB and tests its 8 corners against every clip plane.
+	///		Returns 1 visible, -1 culled and 0 when the box is within rounding of a plane, where float paths may go either way.
+	/// </summary>
+	int CullReference(const Box& box, const XMFLOAT4X4& viewProjection)
+	{
+		constexpr double kEpsilon = 1e-5;
+
+		double low[3] = { DBL_MAX, DBL_MAX, DBL_MAX }, high[3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+		for (int corner = 0; corner < 8; corner++)
+		{
+			const double local[3] = {
+				(corner & 1) ? box.max.x : box.min.x,
+				(corner & 2) ? box.max.y : box.min.y,
+				(corner & 4) ? box.max.z : box.min.z
+			};
+			for (int j = 0; j < 3; j++)
+			{
+				const auto& m = box.modelMatrix.m;
+				const double world = m[j][0] * local[0] + m[j][1] * local[1] + m[j][2] * local[2] + m[j][3];
+				low[j] = std::min(low[j], world);
+				high[j] = std::max(high[j], world);
+			}
+		}
+
+		//Row-vector clip = p * VP, so plane coefficient i of clip component k is VP[i][k].
+		const auto& vp = viewProjection.m;
+		double planes[6][4];
+		for (int i = 0; i < 4; i++)
+		{
+			planes[0][i] = static_cast<double>(vp[i][3]) + vp[i][0];
+			planes[1][i] = static_cast<double>(vp[i][3]) - vp[i][0];
+			planes[2][i] = static_cast<double>(vp[i][3]) + vp[i][1];
+			planes[3][i] = static_cast<double>(vp[i][3]) - vp[i][1];
+			planes[4][i] = vp[i][2];
+			planes[5][i] = static_cast<double>(vp[i][3]) - vp[i][2];
+		}
+
+		const double reach = std::max({ std::fabs(low[0]), std::fabs(high[0]), std::fabs(low[1]), std::fabs(high[1]), std::fabs(low[2]), std::fabs(high[2]) });
+
+		int result = 1;
+		for (const auto& plane : planes)
+		{
+			const double length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+
+			double best = -DBL_MAX;
+			for (int corner = 0; corner < 8; corner++)
+			{
+				const double x = (corner & 1) ? high[0] : low[0];
+				const double y = (corner & 2) ? high[1] : low[1];
+				const double z = (corner & 4) ? high[2] : low[2];
+				best = std::max(best, (plane[0] * x + plane[1] * y + plane[2] * z + plane[3]) / length);
+			}
+
+			const double tolerance = kEpsilon * (1.0 + std::fabs(plane[3] / length) + reach);
+			if (best < -tolerance)
+				return -1;
+			if (best < tolerance)
+				result = 0;
+		}
+		return result;
+	}
+
+	XMFLOAT4X4 RandomModelMatrix(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<float> position(-400.0f, 400.0f), angle(-XM_PI, XM_PI), scale(0.2f, 4.0f);
+
+		const XMMATRIX model = XMMatrixScaling(scale(rng), scale(rng), scale(rng))
+			* XMMatrixRotationZ(angle(rng)) * XMMatrixRotationY(angle(rng)) * XMMatrixRotationX(angle(rng))
+			* XMMatrixTranslation(position(rng), position(rng) * 0.25f, position(rng));
+
+		//Stored transposed like TransformComponent::modelMatrix.
+		XMFLOAT4X4 result;
+		XMStoreFloat4x4(&result, XMMatrixTranspose(model));
+		return result;
+	}
+
+	void TestCullBounds()
+	{
+		constexpr int kCameraCount = 6;
+		//A default AABB has min > max until a mesh fills it in. Those boxes must never be culled.
+		constexpr size_t kUnboundedIndex = 7;
+
+		std::mt19937 rng(25);
+		std::uniform_real_distribution<float> extent(0.1f, 6.0f), offset(-3.0f, 3.0f);
+
+		for (int camera = 0; camera < kCameraCount; camera++)
+		{
+			const size_t count = 10007 + camera;
+
+			std::vector<Box> boxes(count);
+			for (Box& box : boxes)
+			{
+				const float cx = offset(rng), cy = offset(rng), cz = offset(rng);
+				box.min = { cx - extent(rng), cy - extent(rng), cz - extent(rng) };
+				box.max = { cx + extent(rng), cy + extent(rng), cz + extent(rng) };
+				box.modelMatrix = RandomModelMatrix(rng);
+			}
+			boxes[kUnboundedIndex].min = { FLT_MAX, FLT_MAX, FLT_MAX };
+			boxes[kUnboundedIndex].max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+			const XMMATRIX view = XMMatrixTranslation(-10.0f * camera, -2.0f, 5.0f * camera)
+				* XMMatrixRotationY(camera * 1.1f) * XMMatrixRotationX((camera - 2) * 0.2f);
+			const XMMATRIX projection = (camera == kCameraCount - 1)
+				? XMMatrixOrthographicLH(300.0f, 200.0f, 0.1f, 500.0f)
+				: XMMatrixPerspectiveFovLH(0.8f + 0.1f * camera, 16.0f / 9.0f, 0.1f, 300.0f + 100.0f * camera);
+			const XMMATRIX viewProjection = XMMatrixMultiply(view, projection);
+
+			XMFLOAT4X4 viewProjectionValues;
+			XMStoreFloat4x4(&viewProjectionValues, viewProjection);
+
+			Wiley::PackedBounds bounds;
+			bounds.Resize(count);
+			for (size_t i = 0; i < count; i++)
+				bounds.SetBounds(i, boxes[i].min, boxes[i].max, boxes[i].modelMatrix);
+
+			const Wiley::FrustumPlanes frustum = Wiley::ExtractFrustumPlanes(viewProjection);
+
+			std::vector<uint32_t> scalar(count);
+			scalar.resize(Wiley::CullBounds(Wiley::SimdPath::Scalar, frustum, bounds, scalar.data()));
+
+			std::vector<bool> visible(count, false);
+			for (uint32_t index : scalar)
+				visible[index] = true;
+
+			if (!std::is_sorted(scalar.begin(), scalar.end()))
+				Fail("CullBounds", "scalar", "visible indices are out of order");
+			if (!visible[kUnboundedIndex])
+				Fail("CullBounds", "scalar", "culled a box without bounds");
+
+			size_t mismatches = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				if (i == kUnboundedIndex)
+					continue;
+
+				const int reference = CullReference(boxes[i], viewProjectionValues);
+				if (reference != 0 && (reference > 0) != visible[i])
+					mismatches++;
+			}
+			if (mismatches > 0)
+				Fail("CullBounds", "scalar", "disagrees with the brute-force reference");
+
+			for (size_t p = 1; p < std::size(kPaths); p++)
+			{
+				if (!Wiley::IsSimdPathSupported(kPaths[p])) {
+					if (camera == 0)
+						std::cout << "[SKIP] CullBounds (" << kPathNames[p] << ")" << std::endl;
+					continue;
+				}
+
+				std::vector<uint32_t> result(count);
+				result.resize(Wiley::CullBounds(kPaths[p], frustum, bounds, result.data()));
+				if (result != scalar)
+					Fail("CullBounds", kPathNames[p], "visible list differs from the scalar path");
+			}
+
+			std::cout << "CullBounds camera " << camera << ": " << scalar.size() << " of " << count << " visible" << std::endl;
+		}
+	}
+
+}
+
+int main()
+{
+	std::cout << "Widest SIMD path: " << kPathNames[static_cast<size_t>(Wiley::GetSimdPath())] << std::endl;
+
+	TestComposeTransforms();
+	TestCullBounds();
+
+	std::cout << (failures == 0 ? "All SIMD checks passed." : "SIMD checks failed.") << std::endl;
+	return failures == 0 ? 0 : 1;
+}
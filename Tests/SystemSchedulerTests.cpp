@@ -0,0 +1,199 @@
+//Registers stub systems with overlapping and disjoint SystemAccess sets and checks the edges SystemScheduler builds
+//and that every system runs once, after everything it depends on. Exits with 0 when every check passes.
+
+#include "../Wiley/Scene/Systems/SystemScheduler.h"
+#include "../Wiley/Core/ThreadPool.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <functional>
+
+namespace {
+
+	//Each schedule is run this many times so ordering bugs that depend on which worker finishes last get a chance to show.
+	constexpr int kRunCount = 2000;
+
+	int failures = 0;
+
+	void Fail(const char* test, const char* what)
+	{
+		std::cout << "[FAIL] " << test << ": " << what << std::endl;
+		failures++;
+	}
+
+	//Stand-ins for components, only their EnTT type ids matter.
+	struct Position {};
+	struct Velocity {};
+	struct Health {};
+
+	/// <summary>
+	///		Records the order systems ran in during one Run. Every system stamps the next value of a shared sequence
+	///		and counts how often it ran, so a test can check both ordering and that each system ran exactly once.
+	/// </summary>
+	struct RunLog
+	{
+		explicit RunLog(size_t systemCount)
+			:order(std::make_unique<std::atomic<uint32_t>[]>(systemCount)), runs(std::make_unique<std::atomic<uint32_t>[]>(systemCount)), systemCount(systemCount)
+		{
+		}
+
+		void Reset()
+		{
+			sequence.store(0);
+			for (size_t i = 0; i < systemCount; i++) {
+				order[i].store(0);
+				runs[i].store(0);
+			}
+		}
+
+		void Record(size_t system)
+		{
+			order[system].store(sequence.fetch_add(1) + 1);
+			runs[system].fetch_add(1);
+		}
+
+		bool RanBefore(size_t before, size_t after)const { return order[before].load() < order[after].load(); }
+
+		bool AllRanOnce(size_t count)const
+		{
+			for (size_t i = 0; i < count; i++)
+				if (runs[i].load() != 1)
+					return false;
+			return true;
+		}
+
+		std::atomic<uint32_t> sequence{ 0 };
+		std::unique_ptr<std::atomic<uint32_t>[]> order;
+		std::unique_ptr<std::atomic<uint32_t>[]> runs;
+		size_t systemCount;
+	};
+
+	/// <summary>
+	///		A system that declares whatever access it was built with and only records itself in the log when it runs.
+	/// </summary>
+	class StubSystem : public Wiley::ISystem {
+	public:
+		using Declare = std::function<void(Wiley::SystemAccess&)>;
+
+		StubSystem(const char* name, size_t index, RunLog& log, Declare declare)
+			:ISystem(nullptr), name(name), index(index), log(log), declare(std::move(declare))
+		{
+
+		}
+		virtual void OnUpdate(float dt)override { log.Record(index); }
+		virtual void DeclareAccess(Wiley::SystemAccess& access)const override { declare(access); }
+		virtual const char* GetName()const override { return name; }
+	private:
+		const char* name;
+		size_t index;
+		RunLog& log;
+		Declare declare;
+	};
+
+	bool SameDependencies(const Wiley::SystemScheduler& scheduler, size_t index, const std::vector<uint32_t>& expected)
+	{
+		return scheduler.GetDependencies(index) == expected;
+	}
+
+	/// <summary>
+	///		Runs the scheduler kRunCount times and checks every system ran once per Run and after each of its dependencies.
+	/// </summary>
+	void CheckRunOrder(const char* test, Wiley::SystemScheduler& scheduler, RunLog& log, Wiley::ThreadPool& pool)
+	{
+		for (int run = 0; run < kRunCount; run++)
+		{
+			log.Reset();
+			scheduler.Run(0.016f, pool);
+
+			if (!log.AllRanOnce(scheduler.GetSystemCount())) {
+				Fail(test, "a system did not run exactly once");
+				return;
+			}
+			for (size_t index = 0; index < scheduler.GetSystemCount(); index++) {
+				for (uint32_t dependency : scheduler.GetDependencies(index)) {
+					if (!log.RanBefore(dependency, index)) {
+						Fail(test, "a system ran before one of its dependencies");
+						return;
+					}
+				}
+			}
+		}
+	}
+
+	void TestEdges(Wiley::ThreadPool& pool)
+	{
+		namespace Resources = Wiley::SystemResources;
+		enum : size_t { kTransform, kInput, kMeshFilter, kBounds, kMovement, kCamera, kChangeListener, kHealth, kSystemCount };
+
+		RunLog log(kSystemCount);
+		Wiley::SystemScheduler scheduler;
+		auto add = [&](const char* name, size_t index, StubSystem::Declare declare) {
+			scheduler.AddSystem(std::make_unique<StubSystem>(name, index, log, std::move(declare)));
+		};
+
+		add("Transform", kTransform, [](Wiley::SystemAccess& access) { access.Write<Position>().WriteResource(Resources::ChangedTransforms); });
+		add("Input", kInput, [](Wiley::SystemAccess& access) { access.Read<Velocity>(); });
+		add("MeshFilter", kMeshFilter, [](Wiley::SystemAccess& access) { access.Read<Position>().ReadResource(Resources::ChangedTransforms); });
+		add("Bounds", kBounds, [](Wiley::SystemAccess& access) { access.Read<Position>(); });
+		add("Movement", kMovement, [](Wiley::SystemAccess& access) { access.Write<Velocity>().ReadResource(Resources::Camera); });
+		add("Camera", kCamera, [](Wiley::SystemAccess& access) { access.WriteResource(Resources::Camera); });
+		add("ChangeListener", kChangeListener, [](Wiley::SystemAccess& access) { access.ReadResource(Resources::ChangedTransforms); });
+		add("Health", kHealth, [](Wiley::SystemAccess& access) { access.Write<Health>(); });
+
+		//Dependencies are filled in by the first Run.
+		CheckRunOrder("Edges", scheduler, log, pool);
+
+		//A writer orders everything after it that touches the same component or resource, readers of the same thing stay unordered.
+		if (!SameDependencies(scheduler, kTransform, {}) || !SameDependencies(scheduler, kInput, {}))
+			Fail("Edges", "a system with nothing earlier to conflict with got a dependency");
+		if (!SameDependencies(scheduler, kMeshFilter, { kTransform }))
+			Fail("Edges", "a component and resource reader was not ordered after their writer");
+		if (!SameDependencies(scheduler, kBounds, { kTransform }))
+			Fail("Edges", "two readers of the same component were ordered against each other");
+		if (!SameDependencies(scheduler, kMovement, { kInput }))
+			Fail("Edges", "a component writer was not ordered after an earlier reader");
+		if (!SameDependencies(scheduler, kCamera, { kMovement }))
+			Fail("Edges", "a resource writer was not ordered after an earlier reader");
+		if (!SameDependencies(scheduler, kChangeListener, { kTransform }))
+			Fail("Edges", "a resource-only reader was not ordered after the resource's writer");
+		if (!SameDependencies(scheduler, kHealth, {}))
+			Fail("Edges", "a system with disjoint access got a dependency");
+	}
+
+	void TestAddAfterRun(Wiley::ThreadPool& pool)
+	{
+		enum : size_t { kWriter, kReader, kLateWriter, kSystemCount };
+
+		RunLog log(kSystemCount);
+		Wiley::SystemScheduler scheduler;
+		scheduler.AddSystem(std::make_unique<StubSystem>("Writer", kWriter, log, [](Wiley::SystemAccess& access) { access.Write<Position>(); }));
+		scheduler.AddSystem(std::make_unique<StubSystem>("Reader", kReader, log, [](Wiley::SystemAccess& access) { access.Read<Position>(); }));
+		CheckRunOrder("AddAfterRun", scheduler, log, pool);
+
+		//Registering another system rebuilds the graph on the next Run, the newcomer goes after everything it conflicts with.
+		scheduler.AddSystem(std::make_unique<StubSystem>("LateWriter", kLateWriter, log, [](Wiley::SystemAccess& access) { access.Write<Position>(); }));
+		CheckRunOrder("AddAfterRun", scheduler, log, pool);
+
+		if (!SameDependencies(scheduler, kReader, { kWriter }) || !SameDependencies(scheduler, kLateWriter, { kWriter, kReader }))
+			Fail("AddAfterRun", "the graph was not rebuilt with the new system's edges");
+	}
+
+}
+
+int main()
+{
+	Wiley::ThreadPool pool;
+	pool.Initialize();
+	std::cout << "Workers: " << pool.GetWorkerCount() << std::endl;
+
+	TestEdges(pool);
+	TestAddAfterRun(pool);
+
+	pool.Shutdown();
+
+	std::cout << (failures == 0 ? "All system scheduler checks passed." : "System scheduler checks failed.") << std::endl;
+	return failures == 0 ? 0 : 1;
+}
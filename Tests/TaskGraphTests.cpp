@@ -0,0 +1,240 @@
+//Checks TaskGraph ordering on diamond, fan-out and fan-in graphs and measures the scheduling cost per node.
+//Exits with 0 when every check passes.
+
+#include "../Wiley/Core/TaskGraph.h"
+#include "../Wiley/Core/ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+
+	//Each shape is launched this many times so ordering bugs that depend on which worker finishes last get a chance to show.
+	constexpr int kLaunchCount = 2000;
+
+	int failures = 0;
+
+	void Fail(const char* test, const char* what)
+	{
+		std::cout << "[FAIL] " << test << ": " << what << std::endl;
+		failures++;
+	}
+
+	/// <summary>
+	///		Records the order nodes ran in during one launch. Every node stamps the next value of a shared sequence
+	///		and counts how often it ran, so a test can check both ordering and that each node ran exactly once.
+	/// </summary>
+	struct RunLog
+	{
+		explicit RunLog(size_t nodeCount)
+			:order(std::make_unique<std::atomic<uint32_t>[]>(nodeCount)), runs(std::make_unique<std::atomic<uint32_t>[]>(nodeCount)), nodeCount(nodeCount)
+		{
+		}
+
+		void Reset()
+		{
+			sequence.store(0);
+			for (size_t i = 0; i < nodeCount; i++) {
+				order[i].store(0);
+				runs[i].store(0);
+			}
+		}
+
+		Wiley::TaskGraph::Job Record(size_t node)
+		{
+			return [this, node]() {
+				order[node].store(sequence.fetch_add(1) + 1);
+				runs[node].fetch_add(1);
+			};
+		}
+
+		bool RanBefore(size_t before, size_t after)const { return order[before].load() < order[after].load(); }
+
+		bool AllRanOnce()const
+		{
+			for (size_t i = 0; i < nodeCount; i++)
+				if (runs[i].load() != 1)
+					return false;
+			return true;
+		}
+
+		std::atomic<uint32_t> sequence{ 0 };
+		std::unique_ptr<std::atomic<uint32_t>[]> order;
+		std::unique_ptr<std::atomic<uint32_t>[]> runs;
+		size_t nodeCount;
+	};
+
+	void TestDiamond(Wiley::ThreadPool& pool)
+	{
+		enum : size_t { kTop, kLeft, kRight, kBottom, kNodeCount };
+
+		RunLog log(kNodeCount);
+		Wiley::TaskGraph graph;
+		const auto top = graph.AddNode(log.Record(kTop), "Top");
+		const auto left = graph.AddNode(log.Record(kLeft), "Left");
+		const auto right = graph.AddNode(log.Record(kRight), "Right");
+		const auto bottom = graph.AddNode(log.Record(kBottom), "Bottom");
+		graph.AddEdges(top, { left, right });
+		graph.AddEdges({ left, right }, bottom);
+
+		for (int launch = 0; launch < kLaunchCount; launch++)
+		{
+			log.Reset();
+			graph.Run(pool);
+
+			if (!log.AllRanOnce()) {
+				Fail("Diamond", "a node did not run exactly once");
+				return;
+			}
+			if (!log.RanBefore(kTop, kLeft) || !log.RanBefore(kTop, kRight) || !log.RanBefore(kLeft, kBottom) || !log.RanBefore(kRight, kBottom)) {
+				Fail("Diamond", "a node ran before one of its dependencies");
+				return;
+			}
+		}
+	}
+
+	void TestFanOut(Wiley::ThreadPool& pool)
+	{
+		constexpr size_t kChildCount = 64;
+
+		RunLog log(kChildCount + 1);
+		Wiley::TaskGraph graph;
+		const auto root = graph.AddNode(log.Record(0), "Root");
+
+		std::vector<Wiley::TaskGraph::NodeID> children;
+		for (size_t i = 1; i <= kChildCount; i++)
+			children.push_back(graph.AddNode(log.Record(i)));
+		graph.AddEdges(root, children);
+
+		for (int launch = 0; launch < kLaunchCount; launch++)
+		{
+			log.Reset();
+			graph.Run(pool);
+
+			if (!log.AllRanOnce()) {
+				Fail("FanOut", "a node did not run exactly once");
+				return;
+			}
+			for (size_t i = 1; i <= kChildCount; i++) {
+				if (!log.RanBefore(0, i)) {
+					Fail("FanOut", "a child ran before the root");
+					return;
+				}
+			}
+		}
+	}
+
+	void TestFanIn(Wiley::ThreadPool& pool)
+	{
+		constexpr size_t kParentCount = 64;
+		constexpr size_t kSink = kParentCount;
+
+		RunLog log(kParentCount + 1);
+		Wiley::TaskGraph graph;
+
+		std::vector<Wiley::TaskGraph::NodeID> parents;
+		for (size_t i = 0; i < kParentCount; i++)
+			parents.push_back(graph.AddNode(log.Record(i)));
+		graph.AddEdges(parents, graph.AddNode(log.Record(kSink), "Sink"));
+
+		for (int launch = 0; launch < kLaunchCount; launch++)
+		{
+			log.Reset();
+			graph.Run(pool);
+
+			//The sink is the continuation: whichever parent finishes last must start it, and only that one.
+			if (!log.AllRanOnce()) {
+				Fail("FanIn", "a node did not run exactly once");
+				return;
+			}
+			for (size_t i = 0; i < kParentCount; i++) {
+				if (!log.RanBefore(i, kSink)) {
+					Fail("FanIn", "the sink ran before one of its parents");
+					return;
+				}
+			}
+		}
+	}
+
+	void TestCycle(Wiley::ThreadPool& pool)
+	{
+		bool ran = false;
+		Wiley::TaskGraph graph;
+		const auto a = graph.AddNode([&ran]() { ran = true; });
+		const auto b = graph.AddNode([&ran]() { ran = true; });
+		graph.AddEdge(a, b);
+		graph.AddEdge(b, a);
+
+		const Wiley::TaskGraphHandle handle = graph.Launch(pool);
+		if (!handle.IsDone() || ran)
+			Fail("Cycle", "a cyclic graph was launched");
+	}
+
+	/// <summary>
+	///		Launches graphs of empty jobs so the time is all scheduling: dependency counting, continuations and submission.
+	///		A wide graph (one root, many children, one sink) spreads across workers. A chain is the worst case for continuations.
+	/// </summary>
+	void BenchmarkOverhead(Wiley::ThreadPool& pool)
+	{
+		constexpr size_t kNodeCount = 4096;
+		constexpr int kRepeats = 50;
+
+		Wiley::TaskGraph wide;
+		{
+			const auto root = wide.AddNode([]() {});
+			const auto sink = wide.AddNode([]() {});
+			for (size_t i = 2; i < kNodeCount; i++) {
+				const auto node = wide.AddNode([]() {});
+				wide.AddEdge(root, node);
+				wide.AddEdge(node, sink);
+			}
+		}
+
+		Wiley::TaskGraph chain;
+		{
+			Wiley::TaskGraph::NodeID previous = chain.AddNode([]() {});
+			for (size_t i = 1; i < kNodeCount; i++) {
+				const auto node = chain.AddNode([]() {});
+				chain.AddEdge(previous, node);
+				previous = node;
+			}
+		}
+
+		const std::pair<const char*, Wiley::TaskGraph*> graphs[] = { { "wide", &wide }, { "chain", &chain } };
+		for (const auto& [name, graph] : graphs)
+		{
+			//The first launch validates the graph, keep it out of the timing.
+			graph->Run(pool);
+
+			const auto start = std::chrono::steady_clock::now();
+			for (int repeat = 0; repeat < kRepeats; repeat++)
+				graph->Run(pool);
+			const double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+			std::cout << "TaskGraph " << name << ": " << nanoseconds / (static_cast<double>(kRepeats) * kNodeCount) << " ns per node" << std::endl;
+		}
+	}
+
+}
+
+int main()
+{
+	Wiley::ThreadPool pool;
+	pool.Initialize();
+	std::cout << "Workers: " << pool.GetWorkerCount() << std::endl;
+
+	TestDiamond(pool);
+	TestFanOut(pool);
+	TestFanIn(pool);
+	TestCycle(pool);
+	BenchmarkOverhead(pool);
+
+	pool.Shutdown();
+
+	std::cout << (failures == 0 ? "All task graph checks passed." : "Task graph checks failed.") << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+//Times TransformSystem on 100k entities when 1% of them move against recomputing every matrix,
+//and checks the incremental result matches a full recompute. Exits with 0 when every check passes.
+
+#include "../Wiley/Scene/Systems/TransformSystem.h"
+#include "../Wiley/Scene/Component.h"
+#include "../Wiley/Core/ThreadPool.h"
+
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+
+	//Groups of one parent and kChildrenPerGroup children, so a moved parent drags its children along like a real scene graph.
+	constexpr size_t kGroupCount = 10'000;
+	constexpr size_t kChildrenPerGroup = 9;
+	constexpr size_t kEntityCount = kGroupCount * (kChildrenPerGroup + 1);
+
+	constexpr int kFrameCount = 100;
+
+	int failures = 0;
+
+	void Fail(const char* test, const char* what)
+	{
+		std::cout << "[FAIL] " << test << ": " << what << std::endl;
+		failures++;
+	}
+
+	DirectX::XMFLOAT3 RandomVector(std::mt19937& rng, float low, float high)
+	{
+		std::uniform_real_distribution<float> distribution(low, high);
+		return { distribution(rng), distribution(rng), distribution(rng) };
+	}
+
+	/// <summary>
+	///		kGroupCount parents with their children, linked the way Scene::SetParent links them. Parents come first in each group.
+	/// </summary>
+	std::vector<entt::entity> BuildScene(entt::registry& registry, std::mt19937& rng)
+	{
+		std::vector<entt::entity> entities;
+		entities.reserve(kEntityCount);
+
+		for (size_t group = 0; group < kGroupCount; group++)
+		{
+			const entt::entity parent = registry.create();
+			entities.push_back(parent);
+			registry.emplace<Wiley::HierarchyComponent>(parent);
+
+			for (size_t i = 0; i < kChildrenPerGroup; i++)
+			{
+				const entt::entity child = registry.create();
+				entities.push_back(child);
+
+				Wiley::HierarchyComponent& parentNode = registry.get<Wiley::HierarchyComponent>(parent);
+				Wiley::HierarchyComponent childNode;
+				childNode.parent = parent;
+				childNode.nextSibling = parentNode.firstChild;
+				childNode.depth = parentNode.depth + 1;
+				if (parentNode.firstChild != entt::null)
+					registry.get<Wiley::HierarchyComponent>(parentNode.firstChild).prevSibling = child;
+				parentNode.firstChild = child;
+				registry.emplace<Wiley::HierarchyComponent>(child, childNode);
+			}
+		}
+
+		for (entt::entity entity : entities)
+		{
+			Wiley::TransformComponent& transform = registry.emplace<Wiley::TransformComponent>(entity);
+			transform.position = RandomVector(rng, -100.0f, 100.0f);
+			transform.rotation = RandomVector(rng, -3.14f, 3.14f);
+			transform.scale = RandomVector(rng, 0.5f, 2.0f);
+		}
+		return entities;
+	}
+
+	/// <summary>
+	///		Moves fraction of the entities and returns how many world matrices that has to change: the movers plus the children of moved parents.
+	/// </summary>
+	size_t MoveEntities(entt::registry& registry, const std::vector<entt::entity>& entities, double fraction, std::mt19937& rng)
+	{
+		std::vector<bool> changed(entities.size(), false);
+		const size_t moverCount = static_cast<size_t>(static_cast<double>(entities.size()) * fraction);
+
+		for (size_t i = 0; i < moverCount; i++)
+		{
+			const size_t index = (moverCount == entities.size()) ? i : rng() % entities.size();
+			registry.get<Wiley::TransformComponent>(entities[index]).SetPosition(RandomVector(rng, -100.0f, 100.0f));
+
+			changed[index] = true;
+			if (index % (kChildrenPerGroup + 1) == 0)
+				for (size_t child = 1; child <= kChildrenPerGroup; child++)
+					changed[index + child] = true;
+		}
+
+		size_t changedCount = 0;
+		for (bool entityChanged : changed)
+			changedCount += entityChanged ? 1 : 0;
+		return changedCount;
+	}
+
+	std::vector<DirectX::XMFLOAT4X4> SnapshotMatrices(entt::registry& registry, const std::vector<entt::entity>& entities)
+	{
+		std::vector<DirectX::XMFLOAT4X4> matrices;
+		matrices.reserve(entities.size());
+		for (entt::entity entity : entities)
+			matrices.push_back(registry.get<Wiley::TransformComponent>(entity).modelMatrix);
+		return matrices;
+	}
+
+	/// <summary>
+	///		Runs kFrameCount frames moving fraction of the entities each frame. Returns the mean milliseconds per update.
+	///		Every frame the system must report exactly the movers and their children as changed.
+	/// </summary>
+	double TimeFrames(const char* test, Wiley::TransformSystem& system, entt::registry& registry,
+		const std::vector<entt::entity>& entities, double fraction, std::mt19937& rng)
+	{
+		double totalMs = 0.0;
+		for (int frame = 0; frame < kFrameCount; frame++)
+		{
+			const size_t expectedChanged = MoveEntities(registry, entities, fraction, rng);
+
+			const auto start = std::chrono::steady_clock::now();
+			system.Update(registry);
+			totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			if (system.GetChangedEntities().size() != expectedChanged) {
+				Fail(test, "the changed entity count does not match the movers and their children");
+				break;
+			}
+		}
+		return totalMs / kFrameCount;
+	}
+
+	void BenchmarkMovers()
+	{
+		entt::registry registry;
+		std::mt19937 rng(31);
+		const std::vector<entt::entity> entities = BuildScene(registry, rng);
+
+		Wiley::TransformSystem system(nullptr);
+
+		//New transforms start dirty, the first update builds every matrix.
+		system.Update(registry);
+		if (system.GetChangedEntities().size() != entities.size())
+			Fail("Initial", "the first update did not build every matrix");
+
+		const double incrementalMs = TimeFrames("OnePercent", system, registry, entities, 0.01, rng);
+		const std::vector<DirectX::XMFLOAT4X4> incremental = SnapshotMatrices(registry, entities);
+
+		const double fullMs = TimeFrames("FullRecompute", system, registry, entities, 1.0, rng);
+
+		std::cout << "TransformSystem, " << entities.size() << " entities: " << incrementalMs << " ms with 1% moving, "
+			<< fullMs << " ms recomputing all (" << fullMs / incrementalMs << "x)" << std::endl;
+
+		//Rebuild every matrix from the positions the incremental frames left behind and compare.
+		registry.clear();
+		std::mt19937 replay(31);
+		const std::vector<entt::entity> replayed = BuildScene(registry, replay);
+		Wiley::TransformSystem reference(nullptr);
+		reference.Update(registry);
+		for (int frame = 0; frame < kFrameCount; frame++)
+			MoveEntities(registry, replayed, 0.01, replay);
+		for (entt::entity entity : replayed)
+			registry.get<Wiley::TransformComponent>(entity).MarkDirty();
+		reference.Update(registry);
+
+		const std::vector<DirectX::XMFLOAT4X4> recomputed = SnapshotMatrices(registry, replayed);
+		for (size_t i = 0; i < recomputed.size(); i++)
+		{
+			for (int row = 0; row < 4; row++)
+				for (int column = 0; column < 4; column++)
+					if (std::fabs(incremental[i].m[row][column] - recomputed[i].m[row][column]) > 1e-3f * (1.0f + std::fabs(recomputed[i].m[row][column]))) {
+						Fail("Correctness", "an incrementally updated matrix differs from a full recompute");
+						return;
+					}
+		}
+	}
+
+}
+
+int main()
+{
+	Wiley::ThreadPool::GetThreadPool().Initialize();
+	std::cout << "Workers: " << Wiley::ThreadPool::GetThreadPool().GetWorkerCount() << std::endl;
+
+	BenchmarkMovers();
+
+	Wiley::ThreadPool::GetThreadPool().Shutdown();
+
+	std::cout << (failures == 0 ? "All transform system checks passed." : "Transform system checks failed.") << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -3,6 +3,10 @@
 
 #include "Utils.h"
 #include "defines.h"
+#include "TLSFAllocator.h"
+#include "FlatHashMap.h"
+#include "MemoryTracker.h"
+#include "VirtualMemory.h"
 
 #include "Tracy/tracy/Tracy.hpp"
 
@@ -11,57 +15,54 @@
 #include <stdint.h>
 #include <iostream>
 #include <vector>
-#include <set>
 #include <span>
+#include <algorithm>
+#include <type_traits>
+#include <cstring>
 
 namespace Wiley {
 
 	template<typename T>
 	using MemoryBlock = std::span<T>;
 
+	/// <summary>
+	///		Index into a LinearAllocator's handle table plus the generation of the slot when it was handed out.
+	///		Unlike a MemoryBlock it stays valid when the pool grows or is compacted. Resolve it again after either.
+	/// </summary>
+	struct PoolHandle {
+		static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+		uint32_t index = kInvalidIndex;
+		uint32_t generation = 0;
+
+		bool IsValid()const { return index != kInvalidIndex; }
+		bool operator==(const PoolHandle& other)const = default;
+	};
+
 	//This struct is a generic representation of a memory block and is used by the freelist to make it indepent of where the memory sits incase of reallocations.
 	struct MemoryBlockRaw {
 		uint32_t offset;
 		uint32_t size; //byte size
 	};
 
+	/// <summary>
+	///		Pool of T backed by memory it mallocs itself, a reserved virtual range it commits on demand,
+	///		or memory it has no control over (e.g. a mapped upload heap).
+	///		Ranges are handed out by a TLSFAllocator in element units, so allocating and freeing are O(1) regardless of fragmentation.
+	///		The top pointer is the end of the highest live allocation, which is how much of the pool needs copying to the GPU.
+	///		Live blocks, and the backing memory when the pool owns it, are reported to the MemoryTracker under the pool's tag.
+	///		Blocks handed out as spans are invalidated when the pool grows. Blocks that must survive growth or Compact() use AllocateHandle.
+	///		A handle keeps its block's TLSF metadata in its slot. Spans only carry a pointer, so their metadata is looked up by offset,
+	///		which costs memory per live span rather than per element of capacity.
+	/// </summary>
 	template<typename T>
 	class LinearAllocator {
-		class FreeList {
-		public:
-			struct SpanCompare {
-				bool operator()(const MemoryBlockRaw& a, const MemoryBlockRaw& b) const {
-					return a.offset < b.offset;
-				}
-			};
-
-			void Optimize() {
-				if (freelist.size() < 2) return;
-
-				std::set<MemoryBlockRaw, SpanCompare> merged;
-				auto it = freelist.begin();
-				MemoryBlockRaw current = *it;
-				++it;
-				
-				while (it != freelist.end()) {
-					uint32_t currentEnd = current.offset + current.size;
-					if (currentEnd == it->offset) {
-						current = MemoryBlockRaw(current.offset, current.size + it->size);
-					}
-					else {
-						merged.insert(current);
-						current = *it;
-					}
-					++it;
-				}
-				merged.insert(current);
-				freelist = std::move(merged);
-			}
-
-			std::set<MemoryBlockRaw, SpanCompare> freelist;
-		};
-
 	public:
+		enum class Backing {
+			Heap,		//malloc'd and grown with realloc
+			External,	//memory we do not own, e.g. a mapped upload heap
+			Virtual		//reserved address space committed on demand
+		};
 
 		using value_type = T;
 		using pointer = T*;
@@ -69,12 +70,11 @@ namespace Wiley {
 		using reference = T&;
 		using const_reference = T const&;
 
-		LinearAllocator(uint32_t nElement)
+		LinearAllocator(uint32_t nElement, MemoryTag tag = MemoryTag::General)
 			:nElement(nElement), capacity(sizeof(T)* nElement), used(0),
-			elementSize(sizeof(T))
+			elementSize(sizeof(T)), backing(Backing::Heap), maxElement(UINT32_MAX), tag(tag), ranges(nElement)
 		{
 			basePtr = nullptr;
-			topPtr = nullptr;
 
 			_init = false;
 		};
@@ -82,17 +82,29 @@ namespace Wiley {
 		//This constructor is to be used to manager memory pools we have no control over allocation of. 
 		//Example GPU Upload Heap memory
 
-		LinearAllocator(uint32_t nElement, void* uploadHeapPtr)
+		LinearAllocator(uint32_t nElement, void* uploadHeapPtr, MemoryTag tag = MemoryTag::General)
 			:nElement(nElement), capacity(sizeof(T) * nElement), used(0),
-			elementSize(sizeof(T))
+			elementSize(sizeof(T)), backing(Backing::External), maxElement(nElement), tag(tag), ranges(nElement)
 		{
 			basePtr = uploadHeapPtr;
-			topPtr = uploadHeapPtr;
 
 			_init = true;
 		}
 
+		//Reserves address space for maxElement elements and commits nElement of them on Initialize.
+		//Growing commits more pages in place, so unlike a heap pool its pointers stay valid, and Trim gives unused pages back.
+
+		LinearAllocator(uint32_t nElement, uint32_t maxElement, MemoryTag tag)
+			:nElement(nElement), capacity(sizeof(T) * nElement), used(0),
+			elementSize(sizeof(T)), backing(Backing::Virtual), maxElement(maxElement), tag(tag), ranges(nElement)
+		{
+			basePtr = nullptr;
+
+			_init = false;
+		}
+
 		~LinearAllocator() {
+			Reset();
 			Free();
 		}
 
@@ -103,108 +115,125 @@ namespace Wiley {
 				return false;
 			}
 
-			basePtr = malloc(capacity);
-
-			TracyAllocN(basePtr, capacity, "LinearAllocation");
-
-			topPtr = basePtr;
+			if (backing == Backing::Virtual) {
+				if (virtualMemory.Reserve(sizeof(T) * static_cast<size_t>(maxElement)) && virtualMemory.Commit(capacity))
+					basePtr = virtualMemory.GetBasePtr();
+			}
+			else {
+				basePtr = malloc(capacity);
+				TracyAllocN(basePtr, capacity, "LinearAllocation");
+			}
 
 			if (basePtr == nullptr) {
 				std::cout << "Failed allocate memory." << std::endl;
 				return false;
 			}
 
+			gMemoryTracker.RecordReserve(tag, capacity);
 			_init = true;
 			return true;
 		}
 
+		/// <summary>
+		///		Grows the pool to nElement. Existing blocks keep their indices but heap pools invalidate their pointers.
+		///		Virtual pools grow in place up to their reservation. Pools over memory we do not own cannot grow.
+		/// </summary>
 		bool Reallocate(uint32_t nElement)
 		{
-			uint32_t oldTopPtrOffset = (T*)topPtr - (T*)basePtr;
+			if (backing == Backing::External)
+				return false;
+
+			if (backing == Backing::Virtual) {
+				nElement = std::min(nElement, maxElement);
+				if (nElement <= this->nElement || !virtualMemory.Commit(sizeof(T) * nElement))
+					return false;
+
+				gMemoryTracker.RecordReserve(tag, (sizeof(T) * nElement) - capacity);
+
+				this->nElement = nElement;
+				capacity = (sizeof(T) * nElement);
+				ranges.Grow(nElement);
+				return true;
+			}
 
 			void *newBasePtr = realloc(basePtr, elementSize * nElement);
 			if (!newBasePtr)
 				return false;
 
+			TracyFreeN(basePtr, "LinearAllocation");
 			basePtr = newBasePtr;
-			topPtr = (T*)basePtr + oldTopPtrOffset;
+			TracyAllocN(basePtr, elementSize * nElement, "LinearAllocation");
+
+			gMemoryTracker.RecordReserve(tag, (sizeof(T) * nElement) - capacity);
 
 			this->nElement = nElement;
 			capacity = (sizeof(T) * nElement);
+			ranges.Grow(nElement);
 
 			return true;
 		}
 
 		void Free() {
-			free(basePtr);
-			TracyFreeN(basePtr, "LinearAllocation");
+			if (backing == Backing::External || !basePtr)
+				return;
+
+			gMemoryTracker.RecordRelease(tag, capacity);
+			if (backing == Backing::Virtual) {
+				virtualMemory.Release();
+			}
+			else {
+				free(basePtr);
+				TracyFreeN(basePtr, "LinearAllocation");
+			}
+			basePtr = nullptr;
 		}
 
-		[[nodiscard]] MemoryBlock<T> Allocate(uint32_t nElement) {
-			size_t reqSize = nElement * elementSize;
+		/// <summary>
+		///		Virtual pools only. Decommits the pages past the highest live block, keeping at least minElement elements.
+		/// </summary>
+		void Trim(uint32_t minElement = 0) {
+			if (backing != Backing::Virtual || !basePtr)
+				return;
 
-			for (auto it = freelist.freelist.begin(); it != freelist.freelist.end(); ++it) {
-				if (it->size >= reqSize) {
-					uint32_t ptr = it->offset;
-					if (it->size == reqSize) {
-						freelist.freelist.erase(it);
-					}
-					else {
-						MemoryBlockRaw modified = MemoryBlockRaw(it->offset + reqSize, it->size - reqSize);
-						freelist.freelist.erase(it);
-						freelist.freelist.insert(modified);
-					}
-					return MemoryBlock<T>((T*)basePtr + ptr, static_cast<uint32_t>(reqSize));
-				}
-			}
+			const size_t pageSize = VirtualMemoryRange::GetPageSize();
+			const size_t keepBytes = std::max<size_t>(GetReach(), sizeof(T) * static_cast<size_t>(minElement));
+			const uint32_t keepElement = static_cast<uint32_t>(std::min<size_t>(
+				(keepBytes + pageSize - 1) / pageSize * pageSize / sizeof(T), nElement));
 
-			if (used + reqSize > capacity) {
-				if (!Reallocate(this->nElement + (2 * nElement))) {
-					WILEY_DEBUGBREAK;
-					std::cout << "Not enough memory for allocation." << std::endl;
-					return { (T*)topPtr, 0 };
-				}
-			}
+			if (keepElement >= nElement || !ranges.Shrink(keepElement))
+				return;
+
+			virtualMemory.Decommit(sizeof(T) * keepElement);
+			gMemoryTracker.RecordRelease(tag, capacity - (sizeof(T) * keepElement));
 
-			void* returnPtr = topPtr;
-			topPtr = (uint8_t*)topPtr + reqSize;
-			used += reqSize;
-			MemoryBlock<T> returnSpan((T*)returnPtr, static_cast<uint32_t>(nElement));
-			return returnSpan;
+			nElement = keepElement;
+			capacity = sizeof(T) * keepElement;
 		}
 
-		[[nodiscard]] bool Deallocate(pointer blockPtr, uint32_t nElement)
-		{
-			if (blockPtr > topPtr) {
-				std::cout << "Attempting to free invalid memory block." << std::endl;
-				return false;
-			}
+		[[nodiscard]] MemoryBlock<T> Allocate(uint32_t nElement) {
+			const TLSFAllocator::Allocation allocation = AllocateRange(nElement);
+			if (!allocation.IsValid())
+				return { (T*)GetTopPtr(), 0 };
 
-			if ((blockPtr + (nElement * elementSize)) == topPtr) {
-				topPtr = topPtr - (nElement * elementSize);
-				return true;
-			}
+			spanAllocations.insert_or_assign(allocation.offset, allocation.metadata);
+			return MemoryBlock<T>((T*)basePtr + allocation.offset, nElement);
+		}
 
-			MemoryBlock<T> freeBlock(blockPtr, nElement);
-			freelist.freelist.insert(freeBlock);
-			freelist.Optimize();
+		[[nodiscard]] bool Deallocate(pointer blockPtr, uint32_t nElement)
+		{
+			return Deallocate(MemoryBlock<T>(blockPtr, nElement));
 		}
 
 		[[nodiscard]] bool Deallocate(MemoryBlock<T> block)
 		{
-			if (block.data() > topPtr) {
+			const auto allocation = (block.data() >= (T*)basePtr && block.data() < (T*)GetTopPtr()) ? spanAllocations.find(GetIndex(block)) : spanAllocations.end();
+			if (allocation == spanAllocations.end() || !FreeRange({ allocation->first, allocation->second }, block.size_bytes())) {
 				std::cout << "Attempting to free invalid memory block." << std::endl;
 				return false;
 			}
 
-			if ((uint8_t*)(block.data() + block.size()) == topPtr){
-				topPtr = (T*)topPtr - (nElement * elementSize);
-				return true;
-			}
-
-			MemoryBlockRaw blkRaw(block.data() - basePtr, block.size_bytes());
-			freelist.freelist.insert(blkRaw);
-			freelist.Optimize();
+			spanAllocations.erase(allocation);
+			return true;
 		}
 
 		[[nodiscard]] bool Deallocate(uint32_t index, uint32_t count) {
@@ -213,9 +242,110 @@ namespace Wiley {
 			return Deallocate(memBlk);
 		}
 
+		/// <summary>
+		///		Allocates a block addressed through a handle so it can survive Reallocate and Compact.
+		///		Returns an invalid handle when the allocation fails.
+		/// </summary>
+		[[nodiscard]] PoolHandle AllocateHandle(uint32_t nElement) {
+			const TLSFAllocator::Allocation allocation = AllocateRange(nElement);
+			if (!allocation.IsValid())
+				return {};
+
+			uint32_t slotIndex;
+			if (!freeHandleSlots.empty()) {
+				slotIndex = freeHandleSlots.back();
+				freeHandleSlots.pop_back();
+			}
+			else {
+				slotIndex = static_cast<uint32_t>(handleSlots.size());
+				handleSlots.emplace_back();
+			}
+
+			HandleSlot& slot = handleSlots[slotIndex];
+			slot.offset = allocation.offset;
+			slot.metadata = allocation.metadata;
+			slot.count = nElement;
+			slot.alive = true;
+			return { slotIndex, slot.generation };
+		}
+
+		[[nodiscard]] bool Deallocate(PoolHandle handle) {
+			if (!IsAlive(handle)) {
+				std::cout << "Attempting to free a stale pool handle." << std::endl;
+				return false;
+			}
+
+			HandleSlot& slot = handleSlots[handle.index];
+			const bool result = FreeRange({ slot.offset, slot.metadata }, slot.count * elementSize);
+			ReleaseHandleSlot(handle.index);
+			return result;
+		}
+
+		[[nodiscard]] bool IsAlive(PoolHandle handle)const {
+			return handle.index < handleSlots.size() && handleSlots[handle.index].alive && handleSlots[handle.index].generation == handle.generation;
+		}
+
+		/// <summary>
+		///		The returned span is only valid until the pool grows or is compacted.
+		/// </summary>
+		[[nodiscard]] MemoryBlock<T> Resolve(PoolHandle handle)const {
+			ValidateHandle(handle);
+			const HandleSlot& slot = handleSlots[handle.index];
+			return MemoryBlock<T>((T*)basePtr + slot.offset, slot.count);
+		}
+
+		/// <summary>
+		///		Element index of the handle's block, e.g. for addressing it in a GPU copy of the pool.
+		/// </summary>
+		[[nodiscard]] uint32_t GetIndex(PoolHandle handle)const {
+			ValidateHandle(handle);
+			return handleSlots[handle.index].offset;
+		}
+
+		/// <summary>
+		///		Slides every block to the front of the pool so the free space becomes one block at the end.
+		///		Only possible when every live block was allocated through AllocateHandle, since raw spans cannot be patched.
+		/// </summary>
+		bool Compact() {
+			static_assert(std::is_trivially_copyable_v<T>, "LinearAllocator::Compact moves elements with memmove.");
+
+			std::vector<uint32_t> liveSlots;
+			liveSlots.reserve(handleSlots.size());
+			for (uint32_t i = 0; i < handleSlots.size(); i++)
+				if (handleSlots[i].alive)
+					liveSlots.push_back(i);
+
+			if (!spanAllocations.empty()) {
+				std::cout << "Cannot compact a pool that has blocks not owned by handles." << std::endl;
+				return false;
+			}
+
+			std::sort(liveSlots.begin(), liveSlots.end(), [this](uint32_t a, uint32_t b) {
+				return handleSlots[a].offset < handleSlots[b].offset;
+			});
+
+			ranges.Reset(nElement);
+			for (uint32_t slotIndex : liveSlots) {
+				HandleSlot& slot = handleSlots[slotIndex];
+				const TLSFAllocator::Allocation allocation = ranges.Allocate(slot.count);
+
+				//Blocks are visited in address order so the destination never overlaps a block that has not moved yet.
+				if (allocation.offset != slot.offset)
+					memmove((T*)basePtr + allocation.offset, (T*)basePtr + slot.offset, slot.count * elementSize);
+				slot.offset = allocation.offset;
+				slot.metadata = allocation.metadata;
+			}
+			return true;
+		}
+
 		void Reset(){
-			freelist.freelist.clear();
-			topPtr = basePtr;
+			gMemoryTracker.RecordFree(tag, used, ranges.GetAllocationCount());
+			ranges.Reset(nElement);
+			spanAllocations.clear();
+
+			for (uint32_t i = 0; i < handleSlots.size(); i++)
+				if (handleSlots[i].alive)
+					ReleaseHandleSlot(i);
 			used = 0;
 		}
 
@@ -224,7 +354,7 @@ namespace Wiley {
 			}
 
 			[[nodiscard]] void* GetTopPtr()const {
-				return topPtr;
+				return (T*)basePtr + ranges.GetReach();
 			}
 
 			[[nodiscard]] size_t GetMemoryUsed()const {
@@ -240,7 +370,7 @@ namespace Wiley {
 			}
 
 			[[nodiscard]] size_t GetReach()const {
-				return (uint8_t*)topPtr - (uint8_t*)basePtr;
+				return ranges.GetReach() * elementSize;
 			}
 
 			[[nodiscard]] uint32_t GetIndex(MemoryBlock<T> memBlk)const {
@@ -251,9 +381,62 @@ namespace Wiley {
 				return (T*)basePtr + index;
 			}
 
+			[[nodiscard]] TLSFAllocator::Stats GetStats()const {
+				return ranges.GetStats();
+			}
+
+		private:
+			struct HandleSlot {
+				uint32_t offset = 0;
+				uint32_t metadata = 0;
+				uint32_t count = 0;
+				uint32_t generation = 0;
+				bool alive = false;
+			};
+
+			TLSFAllocator::Allocation AllocateRange(uint32_t nElement) {
+				TLSFAllocator::Allocation allocation = ranges.Allocate(nElement);
+
+				if (!allocation.IsValid()) {
+					if (!Reallocate(this->nElement + (2 * nElement)) || !(allocation = ranges.Allocate(nElement)).IsValid()) {
+						WILEY_DEBUGBREAK;
+						std::cout << "Not enough memory for allocation." << std::endl;
+						return {};
+					}
+				}
+
+				used += nElement * elementSize;
+				gMemoryTracker.RecordAlloc(tag, nElement * elementSize);
+				return allocation;
+			}
+
+			bool FreeRange(const TLSFAllocator::Allocation& allocation, size_t byteSize) {
+				if (!ranges.Free(allocation))
+					return false;
+
+				used -= byteSize;
+				gMemoryTracker.RecordFree(tag, byteSize);
+				return true;
+			}
+
+			void ReleaseHandleSlot(uint32_t slotIndex) {
+				HandleSlot& slot = handleSlots[slotIndex];
+				slot.alive = false;
+				slot.generation++;
+				freeHandleSlots.push_back(slotIndex);
+			}
+
+			void ValidateHandle(PoolHandle handle)const {
+#ifdef _DEBUG
+				if (!IsAlive(handle)) {
+					std::cout << "Resolving a stale pool handle." << std::endl;
+					WILEY_DEBUGBREAK;
+				}
+#endif
+			}
+
 		private:
 			void* basePtr;
-			void* topPtr;
 
 			uint32_t nElement;
 			size_t elementSize;
@@ -261,7 +444,17 @@ namespace Wiley {
 			size_t used;
 
 			bool _init;
-			FreeList freelist;
+			Backing backing;
+			uint32_t maxElement;
+			MemoryTag tag;
+			VirtualMemoryRange virtualMemory;
+			TLSFAllocator ranges;
+
+			std::vector<HandleSlot> handleSlots;
+			std::vector<uint32_t> freeHandleSlots;
+
+			//Element offset to TLSF metadata of every live block handed out as a span.
+			FlatHashMap<uint32_t, uint32_t> spanAllocations;
 	};
 
 }
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Delegate.h"
+#include "ThreadPool.h"
+
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace Wiley {
+
+	//Same access rules as DECLARE_EVENT: anyone can listen and Post from any thread, only the owner can Dispatch.
+#define DECLARE_DEFERRED_EVENT(name, owner, payload, coalesce)\
+	class name : public DeferredEvent<payload, coalesce>\
+	{\
+		private:\
+		friend class owner;\
+		using DeferredEvent<payload, coalesce>::Dispatch;\
+		using DeferredEvent<payload, coalesce>::Discard;\
+		using DeferredEvent<payload, coalesce>::Broadcast;\
+		using DeferredEvent<payload, coalesce>::RemoveAll;\
+		using DeferredEvent<payload, coalesce>::Remove;\
+	};
+
+	/// <summary>
+	///		Event that can be posted from any thread and is delivered later, on the thread that calls Dispatch.
+	///		Each ThreadPool worker appends to its own buffer and every other thread shares one, so posting from workers never contends.
+	///		Dispatch merges the buffers in a fixed order (non-worker threads first, then workers by index), keeping each thread's posting order.
+	///		With Coalesce the merged events are sorted and duplicates dropped, so "entity X is dirty" posted ten times is delivered once
+	///		and the order no longer depends on which thread posted first. Payloads then need operator< and operator==.
+	///		Listeners are added and removed on the dispatching thread like any MultiCastDelegate.
+	/// </summary>
+	template<typename Payload, bool Coalesce = false>
+	class DeferredEvent : public MultiCastDelegate<const Payload&>
+	{
+	public:
+		DeferredEvent()
+			:bufferCount(std::max<size_t>(gThreadPool.GetWorkerCount(), std::thread::hardware_concurrency()) + 1),
+			buffers(std::make_unique<Buffer[]>(bufferCount))
+		{
+		}
+
+		DeferredEvent(const DeferredEvent&) = delete;
+		DeferredEvent& operator=(const DeferredEvent&) = delete;
+
+		void Post(const Payload& payload)
+		{
+			Buffer& buffer = GetThreadBuffer();
+			std::lock_guard<std::mutex> lock(buffer.mutex);
+			buffer.events.push_back(payload);
+		}
+
+		void Post(Payload&& payload)
+		{
+			Buffer& buffer = GetThreadBuffer();
+			std::lock_guard<std::mutex> lock(buffer.mutex);
+			buffer.events.push_back(std::move(payload));
+		}
+
+		/// <summary>
+		///		Delivers everything posted before the call. Events posted by listeners or other threads meanwhile wait for the next Dispatch.
+		///		Returns the number of events delivered.
+		/// </summary>
+		size_t Dispatch()
+		{
+			Merge();
+
+			for (const Payload& payload : merged)
+				this->Broadcast(payload);
+
+			const size_t count = merged.size();
+			merged.clear();
+			return count;
+		}
+
+		/// <summary>
+		///		Drops everything posted so far without delivering it.
+		/// </summary>
+		void Discard()
+		{
+			for (size_t i = 0; i < bufferCount; i++)
+			{
+				std::lock_guard<std::mutex> lock(buffers[i].mutex);
+				buffers[i].events.clear();
+			}
+		}
+
+	private:
+		struct alignas(64) Buffer
+		{
+			std::mutex mutex;
+			std::vector<Payload> events;
+		};
+
+		Buffer& GetThreadBuffer()
+		{
+			const int workerIndex = ThreadPool::GetWorkerIndex();
+			const size_t index = (workerIndex >= 0) ? static_cast<size_t>(workerIndex) + 1 : 0;
+			return buffers[(index < bufferCount) ? index : 0];
+		}
+
+		void Merge()
+		{
+			for (size_t i = 0; i < bufferCount; i++)
+			{
+				Buffer& buffer = buffers[i];
+				std::lock_guard<std::mutex> lock(buffer.mutex);
+				if (buffer.events.empty())
+					continue;
+
+				merged.insert(merged.end(), std::make_move_iterator(buffer.events.begin()), std::make_move_iterator(buffer.events.end()));
+				buffer.events.clear();
+			}
+
+			if constexpr (Coalesce)
+			{
+				std::sort(merged.begin(), merged.end());
+				merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+			}
+		}
+
+	private:
+		const size_t bufferCount;
+		std::unique_ptr<Buffer[]> buffers;
+
+		//Only touched by the dispatching thread. Kept around so steady-state dispatch does not allocate.
+		std::vector<Payload> merged;
+	};
+
+}
@@ -3,9 +3,13 @@
 
 #include "defines.h"
 
-#include <functional>
 #include <concepts>
 #include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <vector>
 
 namespace Wiley {
 
@@ -29,62 +33,106 @@ namespace Wiley {
 	};
 
 
+	//Bytes of inline storage in every Delegate. Enough for a pointer-to-member plus its instance on every ABI,
+	//or a lambda capturing four pointers. Larger callables fail to compile instead of falling back to the heap.
+	inline constexpr size_t kDelegateInlineSize = 4 * sizeof(void*);
+
 	template<typename...>
 	class Delegate;
 
-	template<typename DelegateType, typename _Func>
-	concept IsConstructibleToDelegateType = std::is_constructible_v<DelegateType, _Func>;
-
+	template<typename _Func, typename _Return, typename... Args>
+	concept IsBindableToDelegate =
+		std::is_invocable_r_v<_Return, std::decay_t<_Func>&, Args...> &&
+		sizeof(std::decay_t<_Func>) <= kDelegateInlineSize &&
+		alignof(std::decay_t<_Func>) <= alignof(std::max_align_t);
+
+	/// <summary>
+	///		Type-erased callable stored in place. Binding never allocates: the callable is constructed in a
+	///		kDelegateInlineSize buffer and called through one function pointer. Callables that are trivially
+	///		copyable (function pointers, member bindings, lambdas capturing references) are copied with memcpy.
+	/// </summary>
 	template<typename _Return, typename... Args>
 	class Delegate<_Return(Args...)>
 	{
 	public:
-		using DelegateType = std::function<_Return(Args...)>;
 		Delegate() = default;
-		Delegate(const Delegate&) = default;
-		~Delegate() = default;
+
+		Delegate(const Delegate& other) {
+			CopyFrom(other);
+		}
+
+		Delegate(Delegate&& other)noexcept {
+			MoveFrom(other);
+		}
+
+		Delegate& operator=(const Delegate& other) {
+			if (this != &other) {
+				Unbind();
+				CopyFrom(other);
+			}
+			return *this;
+		}
+
+		Delegate& operator=(Delegate&& other)noexcept {
+			if (this != &other) {
+				Unbind();
+				MoveFrom(other);
+			}
+			return *this;
+		}
+
+		~Delegate() {
+			Unbind();
+		}
 
 		template<typename _Func>
-			requires IsConstructibleToDelegateType<DelegateType, _Func>
+			requires IsBindableToDelegate<_Func, _Return, Args...>
 		void BindLambda(_Func&& funcPtr) {
-			callback = funcPtr;
+			Emplace(std::forward<_Func>(funcPtr));
 		}
 
 		void BindStatic(_Return(*funcPtr)(Args...)) {
-			callback = funcPtr;
+			Emplace(funcPtr);
 		}
 
 		template<typename T>
 		void BindMemberFunction(_Return(T::* memFunc)(Args...), T& instance) {
-			callback = [&instance, memFunc](Args&&... args) mutable -> _Return {return (instance.*memFunc)(std::forward<Args>(args)...); };
+			Emplace(MemberBinding<T, _Return(T::*)(Args...)>{ &instance, memFunc });
+		}
+
+		template<typename T>
+		void BindMemberFunction(_Return(T::* memFunc)(Args...)const, const T& instance) {
+			Emplace(MemberBinding<const T, _Return(T::*)(Args...)const>{ &instance, memFunc });
 		}
 
 		void Unbind() {
-			callback = nullptr;
+			if (manager)
+				manager(Operation::Destroy, storage, nullptr);
+
+			invoker = nullptr;
+			manager = nullptr;
 		}
 
 		_Return Execute(Args... args) const {
-			return callback(args...);
+			return invoker(storage, std::forward<Args>(args)...);
 		}
 
 		_Return ExecuteIfBound(Args... args) const {
-			return IsBound() ? callback(args...) : _Return();
+			return IsBound() ? invoker(storage, std::forward<Args>(args)...) : _Return();
 		}
 
 		bool IsBound() const {
-			return (callback != nullptr);
+			return (invoker != nullptr);
 		}
 
 		template<typename _Func>
-			requires IsConstructibleToDelegateType<DelegateType, _Func>
+			requires IsBindableToDelegate<_Func, _Return, Args...>
 		static Delegate CreateLambda(_Func&& funcPtr) {
 			Delegate delegate;
 			delegate.BindLambda(std::forward<_Func>(funcPtr));
 			return delegate;
 		}
 
-		template<typename _Func>
-			requires IsConstructibleToDelegateType<DelegateType, _Func>
 		static Delegate CreateStatic(_Return(*funcPtr)(Args...)) {
 			Delegate delegate;
 			delegate.BindStatic(funcPtr);
@@ -98,12 +146,97 @@ namespace Wiley {
 			return delegate;
 		}
 
+		template<typename T>
+		static Delegate CreateMemberFunction(_Return(T::* memFunc)(Args...)const, const T& instance) {
+			Delegate delegate;
+			delegate.BindMemberFunction(memFunc, instance);
+			return delegate;
+		}
+
 		_Return operator()(Args... args)const {
-			return callback(args...);
+			return invoker(storage, std::forward<Args>(args)...);
+		}
+
+	private:
+		enum class Operation {
+			Copy,
+			Move,
+			Destroy
+		};
+
+		using Invoker = _Return(*)(void*, Args&&...);
+		using Manager = void(*)(Operation, void*, void*);
+
+		template<typename T, typename _MemFunc>
+		struct MemberBinding {
+			T* instance;
+			_MemFunc memFunc;
+
+			_Return operator()(Args&&... args)const {
+				return (instance->*memFunc)(std::forward<Args>(args)...);
+			}
+		};
+
+		template<typename _Callable>
+		static _Return Invoke(void* storage, Args&&... args) {
+			return (*std::launder(reinterpret_cast<_Callable*>(storage)))(std::forward<Args>(args)...);
+		}
+
+		template<typename _Callable>
+		static void Manage(Operation op, void* dst, void* src) {
+			switch (op) {
+				case Operation::Copy:
+					new (dst) _Callable(*std::launder(reinterpret_cast<const _Callable*>(src)));
+					break;
+				case Operation::Move:
+					new (dst) _Callable(std::move(*std::launder(reinterpret_cast<_Callable*>(src))));
+					std::launder(reinterpret_cast<_Callable*>(src))->~_Callable();
+					break;
+				case Operation::Destroy:
+					std::launder(reinterpret_cast<_Callable*>(dst))->~_Callable();
+					break;
+			}
+		}
+
+		template<typename _Func>
+		void Emplace(_Func&& func) {
+			using _Callable = std::decay_t<_Func>;
+			static_assert(sizeof(_Callable) <= kDelegateInlineSize, "Callable is too large for the delegate's inline storage.");
+			static_assert(alignof(_Callable) <= alignof(std::max_align_t), "Callable is over-aligned for the delegate's inline storage.");
+
+			Unbind();
+			new (storage) _Callable(std::forward<_Func>(func));
+			invoker = &Invoke<_Callable>;
+			manager = std::is_trivially_copyable_v<_Callable> ? nullptr : &Manage<_Callable>;
+		}
+
+		void CopyFrom(const Delegate& other) {
+			if (other.manager)
+				other.manager(Operation::Copy, storage, other.storage);
+			else if (other.invoker)
+				std::memcpy(storage, other.storage, kDelegateInlineSize);
+
+			invoker = other.invoker;
+			manager = other.manager;
+		}
+
+		void MoveFrom(Delegate& other) {
+			if (other.manager)
+				other.manager(Operation::Move, storage, other.storage);
+			else if (other.invoker)
+				std::memcpy(storage, other.storage, kDelegateInlineSize);
+
+			invoker = other.invoker;
+			manager = other.manager;
+			other.invoker = nullptr;
+			other.manager = nullptr;
 		}
 
 	private:
-		DelegateType callback;
+		//Callables are invoked non-const like std::function does, so the storage stays writable from const Execute.
+		alignas(std::max_align_t) mutable std::byte storage[kDelegateInlineSize];
+		Invoker invoker = nullptr;
+		Manager manager = nullptr;
 	};
 
 
@@ -139,27 +272,30 @@ namespace Wiley {
 	};
 
 
+	/// <summary>
+	///		Listeners live in two parallel arrays: the handles that Remove scans and the inline delegates that Broadcast walks,
+	///		so a broadcast touches one contiguous block and no heap nodes.
+	///		Listeners may add or remove themselves (or others) from inside Broadcast. Removed slots are only marked dead and
+	///		skipped, and added listeners are held back, until the outermost Broadcast returns and the arrays are compacted.
+	/// </summary>
 	template<typename ...Args>
 	class MultiCastDelegate {
 		using DelegateType = Delegate<void(Args...)>;
-		using HandleDelegatePar = std::pair<DelegateHandle, DelegateType>;
 	public:
 		MultiCastDelegate() = default;
 		~MultiCastDelegate() = default;
 
-		WILEY_MAYBE_UNUSED DelegateHandle Add(DelegateType&& handle) {
-			delegatePool.emplace_back(DelegateHandle(0), std::forward<DelegateType>(handle));
-			return delegatePool.back().first;
+		WILEY_MAYBE_UNUSED DelegateHandle Add(DelegateType&& handler) {
+			return Insert(std::move(handler));
 		}
 
 		WILEY_MAYBE_UNUSED DelegateHandle Add(const DelegateType& handler) {
-			delegatePool.emplace_back(DelegateHandle(0), handler);
-			return delegatePool.back().first;
+			return Insert(DelegateType(handler));
 		}
 
 		template<typename _Func>
 		WILEY_MAYBE_UNUSED DelegateHandle AddLambda(_Func&& funcPtr) {
-			return Add(DelegateType::CreateLambda(funcPtr));
+			return Add(DelegateType::CreateLambda(std::forward<_Func>(funcPtr)));
 		}
 
 
@@ -175,17 +311,36 @@ namespace Wiley {
 
 		WILEY_MAYBE_UNUSED bool Remove(DelegateHandle& handle)
 		{
-			if (handle.IsValid())
+			if (!handle.IsValid())
+				return false;
+
+			for (size_t i = 0; i < handles.size(); ++i)
 			{
-				for (uint64_t i = 0; i < delegatePool.size(); ++i)
+				if (handles[i] == handle)
 				{
-					if (delegatePool[i].first == handle)
+					if (broadcastDepth > 0)
+					{
+						//The delegate may be the one executing, so it is only destroyed once the broadcast is over.
+						handles[i].Reset();
+						hasDeadSlots = true;
+					}
+					else
 					{
-						std::swap(delegatePool[i], delegatePool.back());
-						delegatePool.pop_back();
-						handle.Reset();
-						return true;
+						RemoveAt(i);
 					}
+					handle.Reset();
+					return true;
+				}
+			}
+
+			for (size_t i = 0; i < pendingHandles.size(); ++i)
+			{
+				if (pendingHandles[i] == handle)
+				{
+					pendingHandles.erase(pendingHandles.begin() + i);
+					pendingDelegates.erase(pendingDelegates.begin() + i);
+					handle.Reset();
+					return true;
 				}
 			}
 			return false;
@@ -193,32 +348,131 @@ namespace Wiley {
 
 		void RemoveAll()
 		{
-			delegatePool.clear();
+			pendingHandles.clear();
+			pendingDelegates.clear();
+
+			if (broadcastDepth > 0)
+			{
+				for (DelegateHandle& handle : handles)
+					handle.Reset();
+				hasDeadSlots = true;
+				return;
+			}
+
+			handles.clear();
+			delegates.clear();
 		}
 
 		void Broadcast(Args... args)
 		{
-			for (uint64_t i = 0; i < delegatePool.size(); ++i)
+			//Listeners added during this broadcast land in the pending arrays, so the count cannot change under us.
+			const size_t count = delegates.size();
+
+			broadcastDepth++;
+			for (size_t i = 0; i < count; ++i)
 			{
-				if (delegatePool[i].first.IsValid()) delegatePool[i].second.ExecuteIfBound(std::forward<Args>(args)...);
+				if (handles[i].IsValid()) delegates[i].ExecuteIfBound(args...);
 			}
+			broadcastDepth--;
+
+			if (broadcastDepth == 0)
+				FlushDeferred();
 		}
 
 		bool IsHandleBound(DelegateHandle const& handle) const
 		{
 			if (handle.IsValid())
 			{
-				for (uint64_t i = 0; i < delegatePool.size(); ++i)
+				for (size_t i = 0; i < handles.size(); ++i)
 				{
-					if (delegatePool[i].first == handle) return true;
+					if (handles[i] == handle) return true;
+				}
+				for (size_t i = 0; i < pendingHandles.size(); ++i)
+				{
+					if (pendingHandles[i] == handle) return true;
 				}
 			}
 			return false;
 		}
 
+		size_t GetListenerCount()const
+		{
+			size_t count = pendingHandles.size();
+			for (const DelegateHandle& handle : handles)
+				count += handle.IsValid() ? 1 : 0;
+			return count;
+		}
 
 	private:
-		std::vector<HandleDelegatePar> delegatePool;
+		DelegateHandle Insert(DelegateType&& handler)
+		{
+			DelegateHandle handle(0);
+			if (broadcastDepth > 0)
+			{
+				pendingHandles.push_back(handle);
+				pendingDelegates.push_back(std::move(handler));
+			}
+			else
+			{
+				handles.push_back(handle);
+				delegates.push_back(std::move(handler));
+			}
+			return handle;
+		}
+
+		void RemoveAt(size_t i)
+		{
+			if (i != handles.size() - 1)
+			{
+				handles[i] = handles.back();
+				delegates[i] = std::move(delegates.back());
+			}
+			handles.pop_back();
+			delegates.pop_back();
+		}
+
+		void FlushDeferred()
+		{
+			if (hasDeadSlots)
+			{
+				size_t write = 0;
+				for (size_t read = 0; read < handles.size(); ++read)
+				{
+					if (!handles[read].IsValid())
+						continue;
+
+					if (write != read)
+					{
+						handles[write] = handles[read];
+						delegates[write] = std::move(delegates[read]);
+					}
+					write++;
+				}
+				handles.resize(write);
+				delegates.resize(write);
+				hasDeadSlots = false;
+			}
+
+			if (!pendingHandles.empty())
+			{
+				handles.insert(handles.end(), pendingHandles.begin(), pendingHandles.end());
+				for (DelegateType& delegate : pendingDelegates)
+					delegates.push_back(std::move(delegate));
+
+				pendingHandles.clear();
+				pendingDelegates.clear();
+			}
+		}
+
+	private:
+		std::vector<DelegateHandle> handles;
+		std::vector<DelegateType> delegates;
+
+		std::vector<DelegateHandle> pendingHandles;
+		std::vector<DelegateType> pendingDelegates;
+
+		uint32_t broadcastDepth = 0;
+		bool hasDeadSlots = false;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "DirtyRangeTracker.h"
+
+#include <bit>
+#include <algorithm>
+
+namespace Wiley {
+
+	DirtyRangeTracker::DirtyRangeTracker(size_t elementCount)
+	{
+		Resize(elementCount);
+	}
+
+	void DirtyRangeTracker::Resize(size_t count)
+	{
+		elementCount = count;
+		wordCount = (count + kBitsPerWord - 1) / kBitsPerWord;
+		words = std::make_unique<std::atomic<uint64_t>[]>(wordCount);
+		for (size_t i = 0; i < wordCount; i++)
+			words[i].store(0, std::memory_order_relaxed);
+		isDirty.store(false, std::memory_order_release);
+	}
+
+	void DirtyRangeTracker::MarkDirty(size_t first, size_t count)
+	{
+		if (first >= elementCount || count == 0)
+			return;
+
+		const size_t last = std::min(first + count, elementCount);
+		size_t index = first;
+		while (index < last)
+		{
+			const size_t word = index / kBitsPerWord;
+			const size_t bit = index % kBitsPerWord;
+			const size_t bits = std::min(kBitsPerWord - bit, last - index);
+
+			const uint64_t mask = (bits == kBitsPerWord) ? ~uint64_t(0) : (((uint64_t(1) << bits) - 1) << bit);
+			words[word].fetch_or(mask, std::memory_order_relaxed);
+			index += bits;
+		}
+
+		isDirty.store(true, std::memory_order_release);
+	}
+
+	void DirtyRangeTracker::MarkAllDirty()
+	{
+		MarkDirty(0, elementCount);
+	}
+
+	uint64_t DirtyRangeTracker::Consume(std::vector<DirtyRange>& ranges, size_t elementSize, size_t mergeGap)
+	{
+		if (!isDirty.exchange(false, std::memory_order_acquire))
+			return 0;
+
+		uint64_t bytes = 0;
+		size_t runBegin = 0;
+		size_t runEnd = 0;
+		bool hasRun = false;
+
+		auto flush = [&]() {
+			const DirtyRange range{ uint64_t(runBegin) * elementSize, uint64_t(runEnd - runBegin) * elementSize };
+			ranges.push_back(range);
+			bytes += range.size;
+		};
+
+		for (size_t word = 0; word < wordCount; word++)
+		{
+			if (words[word].load(std::memory_order_relaxed) == 0)
+				continue;
+
+			uint64_t bits = words[word].exchange(0, std::memory_order_relaxed);
+			const size_t base = word * kBitsPerWord;
+			while (bits != 0)
+			{
+				const unsigned begin = static_cast<unsigned>(std::countr_zero(bits));
+				const unsigned length = static_cast<unsigned>(std::countr_one(bits >> begin));
+
+				const size_t first = base + begin;
+				if (hasRun && first - runEnd <= mergeGap) {
+					runEnd = first + length;
+				}
+				else {
+					if (hasRun)
+						flush();
+					runBegin = first;
+					runEnd = first + length;
+					hasRun = true;
+				}
+
+				if (begin + length >= kBitsPerWord)
+					break;
+				bits &= ~((uint64_t(1) << (begin + length)) - 1);
+			}
+		}
+
+		if (hasRun)
+			flush();
+		return bytes;
+	}
+
+}
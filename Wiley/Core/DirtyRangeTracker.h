@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Wiley {
+
+	/// <summary>
+	///		A byte range of a buffer, relative to its start.
+	/// </summary>
+	struct DirtyRange
+	{
+		uint64_t offset = 0;
+		uint64_t size = 0;
+	};
+
+	/// <summary>
+	///		Tracks which elements of a fixed-size array were written since the last Consume, one bit per element.
+	///		MarkDirty is lock-free and can be called from any thread. Consume turns the set bits into sorted, coalesced byte ranges
+	///		in a single pass, so no sorting is needed however the marks arrived.
+	///		Consume must not run concurrently with MarkDirty.
+	/// </summary>
+	class DirtyRangeTracker
+	{
+	public:
+		//Clean runs up to this long are merged into the surrounding ranges. One copy command costs more than a few redundant bytes.
+		static constexpr size_t kDefaultMergeGap = 4;
+
+		DirtyRangeTracker() = default;
+		explicit DirtyRangeTracker(size_t elementCount);
+
+		DirtyRangeTracker(const DirtyRangeTracker&) = delete;
+		DirtyRangeTracker& operator=(const DirtyRangeTracker&) = delete;
+
+		/// <summary>
+		///		Sets the number of tracked elements and clears every mark.
+		/// </summary>
+		void Resize(size_t elementCount);
+
+		/// <summary>
+		///		Marks [first, first + count). Elements past the end are ignored.
+		/// </summary>
+		void MarkDirty(size_t first, size_t count = 1);
+		void MarkAllDirty();
+
+		bool IsDirty()const { return isDirty.load(std::memory_order_acquire); }
+		size_t GetElementCount()const { return elementCount; }
+
+		/// <summary>
+		///		Appends the marked elements to ranges as byte ranges of elementSize each, in ascending order, then clears every mark.
+		///		Dirty runs separated by at most mergeGap clean elements come out as one range.
+		///		Returns the number of bytes appended.
+		/// </summary>
+		uint64_t Consume(std::vector<DirtyRange>& ranges, size_t elementSize, size_t mergeGap = kDefaultMergeGap);
+
+	private:
+		static constexpr size_t kBitsPerWord = 64;
+
+		std::unique_ptr<std::atomic<uint64_t>[]> words;
+		size_t wordCount = 0;
+		size_t elementCount = 0;
+		std::atomic<bool> isDirty{ false };
+	};
+
+}
@@ -0,0 +1,403 @@
+#pragma once
+
+#include "UUID.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <bit>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+#include <stdexcept>
+#include <tuple>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WILEY_FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Wiley {
+
+	/// <summary>
+	///		Open-addressing hash map with all keys and values in one array and a parallel array of one control byte per slot.
+	///		A control byte is either kEmpty or the top 7 bits of the slot's hash, so a lookup compares 16 candidates at a time
+	///		with one SSE2 compare and only touches the slots whose tag matches.
+	///		Probing is linear, which lets Erase shift the following entries back instead of leaving tombstones,
+	///		so the table never degrades under insert/erase churn and never needs a cleanup rehash.
+	///		Hashes are remixed with MulFold64, so std::hash specializations that return the key itself are fine.
+	///		Any insert or erase invalidates iterators and references.
+	/// </summary>
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class FlatHashMap
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = Value;
+		using value_type = std::pair<Key, Value>;
+		using size_type = size_t;
+
+		template<bool IsConst>
+		class Iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = FlatHashMap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+			using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+			using Map = std::conditional_t<IsConst, const FlatHashMap, FlatHashMap>;
+
+			Iterator() = default;
+			Iterator(Map* map, size_t index) :map(map), index(index) { SkipEmpty(); }
+
+			template<bool OtherConst>
+				requires (IsConst && !OtherConst)
+			Iterator(const Iterator<OtherConst>& other) :map(other.map), index(other.index) {}
+
+			reference operator*()const { return map->slots[index]; }
+			pointer operator->()const { return &map->slots[index]; }
+
+			Iterator& operator++() { index++; SkipEmpty(); return *this; }
+			Iterator operator++(int) { Iterator it = *this; ++(*this); return it; }
+
+			bool operator==(const Iterator& other)const { return index == other.index; }
+
+		private:
+			friend class FlatHashMap;
+			template<bool> friend class Iterator;
+
+			void SkipEmpty() {
+				while (map && index < map->capacity && map->control[index] == kEmpty)
+					index++;
+			}
+
+			Map* map = nullptr;
+			size_t index = 0;
+		};
+
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		FlatHashMap() = default;
+
+		explicit FlatHashMap(size_t expectedSize) { reserve(expectedSize); }
+
+		FlatHashMap(const FlatHashMap& other) { CopyFrom(other); }
+
+		FlatHashMap(FlatHashMap&& other)noexcept { Steal(other); }
+
+		FlatHashMap& operator=(const FlatHashMap& other) {
+			if (this != &other) {
+				Destroy();
+				CopyFrom(other);
+			}
+			return *this;
+		}
+
+		FlatHashMap& operator=(FlatHashMap&& other)noexcept {
+			if (this != &other) {
+				Destroy();
+				Steal(other);
+			}
+			return *this;
+		}
+
+		~FlatHashMap() { Destroy(); }
+
+		iterator begin() { return iterator(this, 0); }
+		iterator end() { return iterator(this, capacity); }
+		const_iterator begin()const { return const_iterator(this, 0); }
+		const_iterator end()const { return const_iterator(this, capacity); }
+
+		size_t size()const { return entryCount; }
+		bool empty()const { return entryCount == 0; }
+		size_t bucket_count()const { return capacity; }
+
+		iterator find(const Key& key) { return iterator(this, FindIndex(key)); }
+		const_iterator find(const Key& key)const { return const_iterator(this, FindIndex(key)); }
+		bool contains(const Key& key)const { return FindIndex(key) != capacity; }
+		size_t count(const Key& key)const { return contains(key) ? 1 : 0; }
+
+		Value& at(const Key& key) { return slots[FindExisting(key)].second; }
+		const Value& at(const Key& key)const { return slots[FindExisting(key)].second; }
+
+		Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+		{
+			const uint64_t hash = HashKey(key);
+			size_t index = FindIndex(key, hash);
+			if (index != capacity)
+				return { iterator(this, index), false };
+
+			if ((entryCount + 1) * kMaxLoadDenominator > capacity * kMaxLoadNumerator)
+				Rehash(capacity ? capacity * 2 : kGroupWidth);
+
+			index = FindEmpty(hash);
+			new (&slots[index]) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+			SetControl(index, GetTag(hash));
+			entryCount++;
+			return { iterator(this, index), true };
+		}
+
+		template<typename V>
+		std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value)
+		{
+			auto result = try_emplace(key, std::forward<V>(value));
+			if (!result.second)
+				result.first->second = std::forward<V>(value);
+			return result;
+		}
+
+		std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+
+		size_t erase(const Key& key)
+		{
+			const size_t index = FindIndex(key);
+			if (index == capacity)
+				return 0;
+
+			EraseAt(index);
+			return 1;
+		}
+
+		void erase(iterator it) { EraseAt(it.index); }
+
+		void clear()
+		{
+			for (size_t i = 0; i < capacity; i++) {
+				if (control[i] != kEmpty)
+					slots[i].~value_type();
+			}
+			if (capacity)
+				std::memset(control, kEmpty, capacity + kGroupWidth - 1);
+			entryCount = 0;
+		}
+
+		void reserve(size_t expectedSize)
+		{
+			size_t required = kGroupWidth;
+			while (required * kMaxLoadNumerator < expectedSize * kMaxLoadDenominator)
+				required *= 2;
+			if (required > capacity)
+				Rehash(required);
+		}
+
+		/// <summary>
+		///		Average number of slots between an entry and its ideal slot. 0 for a perfect hash.
+		///		Walks the whole table, meant for checking hash quality rather than per-frame use.
+		/// </summary>
+		float GetAverageProbeLength()const
+		{
+			if (entryCount == 0)
+				return 0.0f;
+
+			size_t total = 0;
+			for (size_t i = 0; i < capacity; i++) {
+				if (control[i] != kEmpty)
+					total += (i - (HashKey(slots[i].first) & (capacity - 1))) & (capacity - 1);
+			}
+			return static_cast<float>(total) / static_cast<float>(entryCount);
+		}
+
+	private:
+		static constexpr size_t kGroupWidth = 16;
+		static constexpr int8_t kEmpty = -128;
+		static constexpr size_t kMaxLoadNumerator = 7;
+		static constexpr size_t kMaxLoadDenominator = 8;
+
+		static uint64_t HashKey(const Key& key)
+		{
+			return MulFold64(static_cast<uint64_t>(Hash{}(key)), 0x9E3779B97F4A7C15ULL);
+		}
+
+		static int8_t GetTag(uint64_t hash) { return static_cast<int8_t>(hash >> 57); }
+
+		/// <summary>
+		///		Bit i is set for each of the 16 control bytes starting at index that equal tag.
+		///		The control array repeats its first kGroupWidth - 1 bytes past the end, so a group never wraps.
+		/// </summary>
+		uint32_t MatchGroup(size_t index, int8_t tag)const
+		{
+#ifdef WILEY_FLAT_HASH_SSE2
+			const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control + index));
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(tag))));
+#else
+			uint32_t mask = 0;
+			for (uint32_t i = 0; i < kGroupWidth; i++)
+				mask |= static_cast<uint32_t>(control[index + i] == tag) << i;
+			return mask;
+#endif
+		}
+
+		uint32_t MatchEmpty(size_t index)const
+		{
+#ifdef WILEY_FLAT_HASH_SSE2
+			//kEmpty is the only control value with the sign bit set.
+			const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control + index));
+			return static_cast<uint32_t>(_mm_movemask_epi8(group));
+#else
+			return MatchGroup(index, kEmpty);
+#endif
+		}
+
+		size_t FindIndex(const Key& key)const { return FindIndex(key, HashKey(key)); }
+
+		size_t FindExisting(const Key& key)const
+		{
+			const size_t index = FindIndex(key);
+			if (index == capacity)
+				throw std::out_of_range("FlatHashMap::at key not found");
+			return index;
+		}
+
+		size_t FindIndex(const Key& key, uint64_t hash)const
+		{
+			if (entryCount == 0)
+				return capacity;
+
+			const size_t mask = capacity - 1;
+			const int8_t tag = GetTag(hash);
+			size_t index = hash & mask;
+
+			//Linear probing keeps every slot between an entry's ideal slot and the entry full, so the first group with an empty slot ends the search.
+			while (true) {
+				for (uint32_t matches = MatchGroup(index, tag); matches; matches &= matches - 1) {
+					const size_t slot = (index + std::countr_zero(matches)) & mask;
+					if (KeyEqual{}(slots[slot].first, key))
+						return slot;
+				}
+
+				if (MatchEmpty(index))
+					return capacity;
+
+				index = (index + kGroupWidth) & mask;
+			}
+		}
+
+		size_t FindEmpty(uint64_t hash)const
+		{
+			const size_t mask = capacity - 1;
+			size_t index = hash & mask;
+			while (true) {
+				if (const uint32_t empties = MatchEmpty(index))
+					return (index + std::countr_zero(empties)) & mask;
+
+				index = (index + kGroupWidth) & mask;
+			}
+		}
+
+		void SetControl(size_t index, int8_t value)
+		{
+			control[index] = value;
+			if (index < kGroupWidth - 1)
+				control[capacity + index] = value;
+		}
+
+		/// <summary>
+		///		Backward-shift deletion: entries after the hole that would still be reachable from their ideal slot
+		///		through the hole move into it, until an empty slot is reached.
+		/// </summary>
+		void EraseAt(size_t hole)
+		{
+			const size_t mask = capacity - 1;
+			slots[hole].~value_type();
+
+			for (size_t next = (hole + 1) & mask; control[next] != kEmpty; next = (next + 1) & mask) {
+				const size_t ideal = HashKey(slots[next].first) & mask;
+				if (((next - ideal) & mask) < ((next - hole) & mask))
+					continue;
+
+				new (&slots[hole]) value_type(std::move(slots[next]));
+				slots[next].~value_type();
+				SetControl(hole, control[next]);
+				hole = next;
+			}
+
+			SetControl(hole, kEmpty);
+			entryCount--;
+		}
+
+		void Allocate(size_t newCapacity)
+		{
+			capacity = newCapacity;
+			slots = std::allocator<value_type>().allocate(capacity);
+			control = new int8_t[capacity + kGroupWidth - 1];
+			std::memset(control, kEmpty, capacity + kGroupWidth - 1);
+		}
+
+		void Rehash(size_t newCapacity)
+		{
+			value_type* oldSlots = slots;
+			int8_t* oldControl = control;
+			const size_t oldCapacity = capacity;
+
+			Allocate(newCapacity);
+
+			for (size_t i = 0; i < oldCapacity; i++) {
+				if (oldControl[i] == kEmpty)
+					continue;
+
+				const uint64_t hash = HashKey(oldSlots[i].first);
+				const size_t index = FindEmpty(hash);
+				new (&slots[index]) value_type(std::move(oldSlots[i]));
+				SetControl(index, GetTag(hash));
+				oldSlots[i].~value_type();
+			}
+
+			if (oldSlots) {
+				std::allocator<value_type>().deallocate(oldSlots, oldCapacity);
+				delete[] oldControl;
+			}
+		}
+
+		void CopyFrom(const FlatHashMap& other)
+		{
+			if (other.capacity == 0)
+				return;
+
+			Allocate(other.capacity);
+			for (size_t i = 0; i < capacity; i++) {
+				if (other.control[i] != kEmpty)
+					new (&slots[i]) value_type(other.slots[i]);
+			}
+			std::memcpy(control, other.control, capacity + kGroupWidth - 1);
+			entryCount = other.entryCount;
+		}
+
+		void Steal(FlatHashMap& other)
+		{
+			slots = std::exchange(other.slots, nullptr);
+			control = std::exchange(other.control, nullptr);
+			capacity = std::exchange(other.capacity, 0);
+			entryCount = std::exchange(other.entryCount, 0);
+		}
+
+		void Destroy()
+		{
+			if (!slots)
+				return;
+
+			clear();
+			std::allocator<value_type>().deallocate(slots, capacity);
+			delete[] control;
+			slots = nullptr;
+			control = nullptr;
+			capacity = 0;
+		}
+
+	private:
+		value_type* slots = nullptr;
+		int8_t* control = nullptr;
+		size_t capacity = 0;
+		size_t entryCount = 0;
+	};
+
+	template<typename Value>
+	using UUIDMap = FlatHashMap<UUID, Value>;
+
+}
@@ -0,0 +1,121 @@
+#include "FrameAllocator.h"
+
+#include <new>
+#include <memory>
+#include <algorithm>
+
+namespace Wiley
+{
+	FrameAllocator frameAllocator;
+
+	static constexpr size_t kBlockAlignment = 64;
+
+	FrameArena::FrameArena(size_t blockSize)
+		:blockSize(blockSize)
+	{
+	}
+
+	FrameArena::~FrameArena()
+	{
+		for (Block& block : blocks)
+			FreeBlock(block);
+	}
+
+	FrameArena::Block FrameArena::AllocateBlock(size_t size)
+	{
+		blockAllocationCount++;
+		return { static_cast<uint8_t*>(::operator new(size, std::align_val_t{ kBlockAlignment })), size };
+	}
+
+	void FrameArena::FreeBlock(Block& block)
+	{
+		::operator delete(block.data, std::align_val_t{ kBlockAlignment });
+		block.data = nullptr;
+	}
+
+	void* FrameArena::Allocate(size_t size, size_t alignment)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if (blocks.empty())
+			blocks.push_back(AllocateBlock(blockSize));
+
+		while (true)
+		{
+			Block& block = blocks[currentBlock];
+			const uintptr_t address = reinterpret_cast<uintptr_t>(block.data) + offset;
+			const size_t padding = (alignment - (address % alignment)) % alignment;
+
+			if (offset + padding + size <= block.size)
+			{
+				offset += padding + size;
+				used += padding + size;
+				peakUsed = std::max(peakUsed, used);
+				return block.data + offset - size;
+			}
+
+			//The tail of this block is wasted for the rest of the frame. Reset merges the blocks so it only happens while warming up.
+			used += block.size - offset;
+			offset = 0;
+
+			if (++currentBlock == blocks.size())
+				blocks.push_back(AllocateBlock(std::max(blockSize, size + alignment)));
+		}
+	}
+
+	void FrameArena::Reset()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		if (blocks.size() > 1)
+		{
+			size_t capacity = 0;
+			for (Block& block : blocks)
+			{
+				capacity += block.size;
+				FreeBlock(block);
+			}
+
+			blocks.clear();
+			blocks.push_back(AllocateBlock(capacity));
+		}
+
+		currentBlock = 0;
+		offset = 0;
+		used = 0;
+	}
+
+	size_t FrameArena::GetCapacity()const
+	{
+		size_t capacity = 0;
+		for (const Block& block : blocks)
+			capacity += block.size;
+		return capacity;
+	}
+
+	FrameAllocator::FrameAllocator()
+	{
+		arenas.push_back(std::make_unique<FrameArena>());
+	}
+
+	void FrameAllocator::Initialize(uint32_t framesInFlight, size_t blockSize)
+	{
+		arenas.clear();
+		for (uint32_t i = 0; i < std::max(framesInFlight, 1u); i++)
+			arenas.push_back(std::make_unique<FrameArena>(blockSize));
+
+		currentFrame = 0;
+	}
+
+	void FrameAllocator::BeginFrame(uint32_t frameIndex)
+	{
+		currentFrame = frameIndex % arenas.size();
+		arenas[currentFrame]->Reset();
+	}
+
+	FrameAllocator& FrameAllocator::GetFrameAllocator()
+	{
+		return frameAllocator;
+	}
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace Wiley {
+
+	/// <summary>
+	///		Bump allocator for scratch data that only lives for one frame. Nothing is freed individually, the whole arena is reset at once.
+	///		Blocks are kept across resets and merged into one once a frame has needed more than one, so a steady frame loop stops allocating.
+	/// </summary>
+	class FrameArena
+	{
+	public:
+		static constexpr size_t kDefaultBlockSize = 1024 * 1024;
+
+		explicit FrameArena(size_t blockSize = kDefaultBlockSize);
+		~FrameArena();
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		/// <summary>
+		///		Invalidates everything allocated since the last reset.
+		/// </summary>
+		void Reset();
+
+		size_t GetUsed()const { return used; }
+		size_t GetPeakUsed()const { return peakUsed; }
+		size_t GetCapacity()const;
+
+		/// <summary>
+		///		Number of times the arena went to the heap. Stays constant once the frame loop is steady.
+		/// </summary>
+		size_t GetBlockAllocationCount()const { return blockAllocationCount; }
+
+	private:
+		struct Block
+		{
+			uint8_t* data;
+			size_t size;
+		};
+
+		Block AllocateBlock(size_t size);
+		static void FreeBlock(Block& block);
+
+	private:
+		std::mutex mutex;
+
+		std::vector<Block> blocks;
+		size_t currentBlock = 0;
+		size_t offset = 0;
+
+		size_t blockSize;
+		size_t used = 0;
+		size_t peakUsed = 0;
+		size_t blockAllocationCount = 0;
+	};
+
+	/// <summary>
+	///		One FrameArena per frame in flight. BeginFrame is called once the GPU has retired the frame slot,
+	///		which resets that slot's arena and makes it the one GetArena() returns until the next frame.
+	/// </summary>
+	class FrameAllocator
+	{
+	public:
+		FrameAllocator();
+
+		void Initialize(uint32_t framesInFlight, size_t blockSize = FrameArena::kDefaultBlockSize);
+		void BeginFrame(uint32_t frameIndex);
+
+		FrameArena& GetArena() { return *arenas[currentFrame]; }
+		uint32_t GetFrameCount()const { return static_cast<uint32_t>(arenas.size()); }
+
+		static FrameAllocator& GetFrameAllocator();
+
+	private:
+		std::vector<std::unique_ptr<FrameArena>> arenas;
+		uint32_t currentFrame = 0;
+	};
+
+#define gFrameAllocator FrameAllocator::GetFrameAllocator()
+
+	/// <summary>
+	///		STL allocator over a FrameArena so containers can opt into per-frame storage.
+	///		deallocate is a no-op. Containers using it must not outlive the frame they were filled in.
+	/// </summary>
+	template<typename T>
+	class FrameStlAllocator
+	{
+	public:
+		using value_type = T;
+
+		FrameStlAllocator() noexcept
+			:arena(&gFrameAllocator.GetArena())
+		{
+		}
+
+		explicit FrameStlAllocator(FrameArena& arena) noexcept
+			:arena(&arena)
+		{
+		}
+
+		template<typename U>
+		FrameStlAllocator(const FrameStlAllocator<U>& other) noexcept
+			:arena(other.arena)
+		{
+		}
+
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T*, size_t) noexcept
+		{
+		}
+
+		template<typename U>
+		bool operator==(const FrameStlAllocator<U>& other)const noexcept { return arena == other.arena; }
+
+	private:
+		template<typename U>
+		friend class FrameStlAllocator;
+
+		FrameArena* arena;
+	};
+
+	template<typename T>
+	using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+}
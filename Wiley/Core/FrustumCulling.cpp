@@ -0,0 +1,221 @@
+#include "FrustumCulling.h"
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+namespace Wiley {
+
+	namespace {
+
+		//One lane per box. Kept in the same shape as the SIMD lanes so the kernel below is written once.
+		struct ScalarLanes
+		{
+			using Value = float;
+			using Mask = bool;
+			static constexpr size_t kWidth = 1;
+
+			static Value Load(const float* p) { return *p; }
+			static Value Set(float v) { return v; }
+			static Value Add(Value a, Value b) { return a + b; }
+			static Value Mul(Value a, Value b) { return a * b; }
+			static Mask LessThan(Value a, Value b) { return a < b; }
+			static Mask Or(Mask a, Mask b) { return a || b; }
+			static unsigned MoveMask(Mask mask) { return mask ? 1u : 0u; }
+		};
+
+#ifdef WILEY_SIMD_SSE
+		struct SSELanes
+		{
+			using Value = __m128;
+			using Mask = __m128;
+			static constexpr size_t kWidth = 4;
+
+			static Value Load(const float* p) { return _mm_loadu_ps(p); }
+			static Value Set(float v) { return _mm_set1_ps(v); }
+			static Value Add(Value a, Value b) { return _mm_add_ps(a, b); }
+			static Value Mul(Value a, Value b) { return _mm_mul_ps(a, b); }
+			static Mask LessThan(Value a, Value b) { return _mm_cmplt_ps(a, b); }
+			static Mask Or(Mask a, Mask b) { return _mm_or_ps(a, b); }
+			static unsigned MoveMask(Mask mask) { return static_cast<unsigned>(_mm_movemask_ps(mask)); }
+		};
+#endif
+
+#ifdef WILEY_SIMD_AVX
+		struct AVXLanes
+		{
+			using Value = __m256;
+			using Mask = __m256;
+			static constexpr size_t kWidth = 8;
+
+			static Value Load(const float* p) { return _mm256_loadu_ps(p); }
+			static Value Set(float v) { return _mm256_set1_ps(v); }
+			static Value Add(Value a, Value b) { return _mm256_add_ps(a, b); }
+			static Value Mul(Value a, Value b) { return _mm256_mul_ps(a, b); }
+			//Ordered compare, a NaN distance counts as inside like it does in the scalar lanes.
+			static Mask LessThan(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			static Mask Or(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+			static unsigned MoveMask(Mask mask) { return static_cast<unsigned>(_mm256_movemask_ps(mask)); }
+		};
+#endif
+
+		/// <summary>
+		///		Tests kWidth boxes per iteration against all six planes. A box is outside a plane when its center lies further behind it
+		///		than the box's projected radius, |n.x| * e.x + |n.y| * e.y + |n.z| * e.z.
+		/// </summary>
+		template<typename L>
+		size_t CullLanes(const FrustumPlanes& frustum, const PackedBounds& bounds, uint32_t* visible)
+		{
+			using V = typename L::Value;
+			using M = typename L::Mask;
+			constexpr size_t kPlanes = FrustumPlanes::kPlaneCount;
+
+			V normalX[kPlanes], normalY[kPlanes], normalZ[kPlanes], distance[kPlanes];
+			V absNormalX[kPlanes], absNormalY[kPlanes], absNormalZ[kPlanes];
+			for (size_t p = 0; p < kPlanes; p++)
+			{
+				const DirectX::XMFLOAT4& plane = frustum.planes[p];
+				normalX[p] = L::Set(plane.x);
+				normalY[p] = L::Set(plane.y);
+				normalZ[p] = L::Set(plane.z);
+				distance[p] = L::Set(plane.w);
+				absNormalX[p] = L::Set(std::fabs(plane.x));
+				absNormalY[p] = L::Set(std::fabs(plane.y));
+				absNormalZ[p] = L::Set(std::fabs(plane.z));
+			}
+			const V zero = L::Set(0.0f);
+
+			const float* centerX = bounds.GetCenterX();
+			const float* centerY = bounds.GetCenterY();
+			const float* centerZ = bounds.GetCenterZ();
+			const float* extentX = bounds.GetExtentX();
+			const float* extentY = bounds.GetExtentY();
+			const float* extentZ = bounds.GetExtentZ();
+
+			const size_t count = bounds.GetCount();
+			size_t written = 0;
+			for (size_t i = 0; i < count; i += L::kWidth)
+			{
+				//The streams are padded, so the last iteration may read past count. Those lanes are never written out.
+				const V cx = L::Load(centerX + i), cy = L::Load(centerY + i), cz = L::Load(centerZ + i);
+				const V ex = L::Load(extentX + i), ey = L::Load(extentY + i), ez = L::Load(extentZ + i);
+
+				M outside = L::LessThan(zero, zero);
+				for (size_t p = 0; p < kPlanes; p++)
+				{
+					const V dist = L::Add(L::Add(L::Add(L::Mul(normalX[p], cx), L::Mul(normalY[p], cy)), L::Mul(normalZ[p], cz)), distance[p]);
+					const V radius = L::Add(L::Add(L::Mul(absNormalX[p], ex), L::Mul(absNormalY[p], ey)), L::Mul(absNormalZ[p], ez));
+					outside = L::Or(outside, L::LessThan(L::Add(dist, radius), zero));
+				}
+
+				//Branch-free compaction: every lane is stored, only the inside ones advance the cursor.
+				const unsigned inside = ~L::MoveMask(outside);
+				const size_t lanes = std::min(L::kWidth, count - i);
+				for (size_t k = 0; k < lanes; k++)
+				{
+					visible[written] = static_cast<uint32_t>(i + k);
+					written += (inside >> k) & 1u;
+				}
+			}
+			return written;
+		}
+
+	}
+
+	FrustumPlanes ExtractFrustumPlanes(DirectX::FXMMATRIX viewProjection)
+	{
+		using namespace DirectX;
+
+		//Row-vector clip = p * M, so clip.k is p dotted with column k. Transposing puts the columns in rows.
+		const XMMATRIX columns = XMMatrixTranspose(viewProjection);
+		const XMVECTOR x = columns.r[0], y = columns.r[1], z = columns.r[2], w = columns.r[3];
+
+		const XMVECTOR planes[FrustumPlanes::kPlaneCount] = {
+			XMVectorAdd(w, x),		//-w <= x
+			XMVectorSubtract(w, x),	// x <= w
+			XMVectorAdd(w, y),		//-w <= y
+			XMVectorSubtract(w, y),	// y <= w
+			z,						// 0 <= z
+			XMVectorSubtract(w, z)	// z <= w
+		};
+
+		FrustumPlanes frustum;
+		for (size_t p = 0; p < FrustumPlanes::kPlaneCount; p++)
+			XMStoreFloat4(&frustum.planes[p], XMPlaneNormalize(planes[p]));
+		return frustum;
+	}
+
+	void PackedBounds::Resize(size_t newCount)
+	{
+		count = newCount;
+		const size_t padded = (newCount + kPadding - 1) / kPadding * kPadding;
+		for (std::vector<float>* stream : { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ })
+			stream->resize(padded, 0.0f);
+	}
+
+	void PackedBounds::SetBounds(size_t index, const DirectX::XMFLOAT3& min, const DirectX::XMFLOAT3& max, const DirectX::XMFLOAT4X4& modelMatrix)
+	{
+		if (min.x > max.x || min.y > max.y || min.z > max.z) {
+			SetUnbounded(index);
+			return;
+		}
+
+		const float c[3] = { (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f };
+		const float e[3] = { (max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f };
+
+		//modelMatrix is stored transposed, so row j maps a local point to world coordinate j.
+		//The transformed box's half-extent along j is the absolute row applied to the local half-extent.
+		const auto& m = modelMatrix.m;
+		float center[3], extent[3];
+		for (int j = 0; j < 3; j++)
+		{
+			center[j] = m[j][0] * c[0] + m[j][1] * c[1] + m[j][2] * c[2] + m[j][3];
+			extent[j] = std::fabs(m[j][0]) * e[0] + std::fabs(m[j][1]) * e[1] + std::fabs(m[j][2]) * e[2];
+		}
+
+		centerX[index] = center[0];
+		centerY[index] = center[1];
+		centerZ[index] = center[2];
+		extentX[index] = extent[0];
+		extentY[index] = extent[1];
+		extentZ[index] = extent[2];
+	}
+
+	void PackedBounds::SetUnbounded(size_t index)
+	{
+		//FLT_MAX rather than infinity, a zero normal component times infinity would make the radius NaN.
+		centerX[index] = centerY[index] = centerZ[index] = 0.0f;
+		extentX[index] = extentY[index] = extentZ[index] = FLT_MAX;
+	}
+
+	size_t CullBounds(const FrustumPlanes& frustum, const PackedBounds& bounds, uint32_t* visible)
+	{
+		return CullBounds(GetSimdPath(), frustum, bounds, visible);
+	}
+
+	size_t CullBounds(SimdPath path, const FrustumPlanes& frustum, const PackedBounds& bounds, uint32_t* visible)
+	{
+		if (!IsSimdPathSupported(path))
+			path = SimdPath::Scalar;
+
+		switch (path)
+		{
+#ifdef WILEY_SIMD_AVX
+		case SimdPath::AVX:
+		{
+			const size_t written = CullLanes<AVXLanes>(frustum, bounds, visible);
+			//Avoid the AVX to SSE transition penalty in whatever legacy SSE code runs next.
+			_mm256_zeroupper();
+			return written;
+		}
+#endif
+#ifdef WILEY_SIMD_SSE
+		case SimdPath::SSE:
+			return CullLanes<SSELanes>(frustum, bounds, visible);
+#endif
+		default:
+			return CullLanes<ScalarLanes>(frustum, bounds, visible);
+		}
+	}
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "SimdSupport.h"
+
+#include <DirectXMath.h>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Wiley {
+
+	/// <summary>
+	///		The six planes of a view frustum in world space, in the order left, right, bottom, top, near, far.
+	///		xyz is the unit normal pointing into the frustum and w the distance term, so a point p is inside when dot(xyz, p) + w >= 0 for all six.
+	/// </summary>
+	struct FrustumPlanes
+	{
+		static constexpr size_t kPlaneCount = 6;
+		DirectX::XMFLOAT4 planes[kPlaneCount];
+	};
+
+	/// <summary>
+	///		Extracts the frustum planes of a view-projection matrix in DirectXMath's row-vector form (XMMatrixMultiply(view, projection)).
+	///		Assumes the D3D clip volume, 0 <= z <= w. Works for perspective and orthographic projections alike.
+	/// </summary>
+	FrustumPlanes ExtractFrustumPlanes(DirectX::FXMMATRIX viewProjection);
+
+	/// <summary>
+	///		World-space bounding boxes as center and half-extent streams, one float per box in each.
+	///		The streams are padded to a multiple of 8 so the 8-wide kernel can load past the last box.
+	/// </summary>
+	class PackedBounds
+	{
+	public:
+		static constexpr size_t kPadding = 8;
+
+		/// <summary>
+		///		Sets the number of boxes. Existing boxes keep their values, new ones are a point at the origin until set.
+		/// </summary>
+		void Resize(size_t count);
+		size_t GetCount()const { return count; }
+
+		/// <summary>
+		///		Stores the world-space box enclosing the local box [min, max] under modelMatrix, in the layout TransformComponent::modelMatrix stores.
+		///		An inverted local box (min > max, what an AABB holds before anything is merged in) is stored as unbounded so it is never culled.
+		/// </summary>
+		void SetBounds(size_t index, const DirectX::XMFLOAT3& min, const DirectX::XMFLOAT3& max, const DirectX::XMFLOAT4X4& modelMatrix);
+		void SetUnbounded(size_t index);
+
+		DirectX::XMFLOAT3 GetCenter(size_t index)const { return { centerX[index], centerY[index], centerZ[index] }; }
+		DirectX::XMFLOAT3 GetExtent(size_t index)const { return { extentX[index], extentY[index], extentZ[index] }; }
+
+		const float* GetCenterX()const { return centerX.data(); }
+		const float* GetCenterY()const { return centerY.data(); }
+		const float* GetCenterZ()const { return centerZ.data(); }
+		const float* GetExtentX()const { return extentX.data(); }
+		const float* GetExtentY()const { return extentY.data(); }
+		const float* GetExtentZ()const { return extentZ.data(); }
+
+	private:
+		std::vector<float> centerX, centerY, centerZ;
+		std::vector<float> extentX, extentY, extentZ;
+		size_t count = 0;
+	};
+
+	/// <summary>
+	///		Writes the index of every box that is at least partly inside the frustum to visible, in ascending order, and returns how many were written.
+	///		visible must have room for bounds.GetCount() indices. A box is culled only when it lies entirely behind one plane,
+	///		so boxes near the frustum corners can pass; that is conservative, nothing visible is dropped.
+	///		Without a path the widest one GetSimdPath reports is used. An unsupported path falls back to scalar.
+	/// </summary>
+	size_t CullBounds(const FrustumPlanes& frustum, const PackedBounds& bounds, uint32_t* visible);
+	size_t CullBounds(SimdPath path, const FrustumPlanes& frustum, const PackedBounds& bounds, uint32_t* visible);
+
+}
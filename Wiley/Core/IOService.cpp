@@ -0,0 +1,159 @@
+#include "IOService.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace Wiley
+{
+	IOService ioService;
+
+	IOService::IOService()
+	{
+	}
+
+	IOService::~IOService()
+	{
+		Shutdown();
+	}
+
+	void IOService::Initialize(int nThreads, ThreadPool& computePool)
+	{
+		this->computePool = &computePool;
+		stop = false;
+
+		threads.reserve(nThreads);
+		for (int i = 0; i < nThreads; i++)
+			threads.emplace_back([this] { IOLoop(); });
+	}
+
+	void IOService::Shutdown()
+	{
+		if (threads.empty())
+			return;
+
+		{
+			std::unique_lock<std::mutex> lock(requestMutex);
+			stop = true;
+		}
+
+		requestCondition.notify_all();
+
+		for (auto& thread : threads)
+			if (thread.joinable())
+				thread.join();
+
+		threads.clear();
+	}
+
+	void IOService::IOLoop()
+	{
+		while (true)
+		{
+			Request request;
+			{
+				std::unique_lock<std::mutex> lock(requestMutex);
+				requestCondition.wait(lock, [this]() { return stop || !requests.empty(); });
+
+				if (requests.empty())
+					return;
+
+				request = std::move(requests.front());
+				requests.pop_front();
+			}
+
+			FileBuffer file = ReadFile(request.path);
+			Complete(request, file);
+		}
+	}
+
+	void IOService::Enqueue(Request&& request)
+	{
+		pendingReads++;
+
+		if (threads.empty())
+		{
+			FileBuffer file = ReadFile(request.path);
+			Complete(request, file);
+			return;
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(requestMutex);
+			requests.push_back(std::move(request));
+		}
+		requestCondition.notify_one();
+	}
+
+	void IOService::Complete(Request& request, FileBuffer& file)
+	{
+		if (!computePool)
+		{
+			request.callback(file);
+			pendingReads--;
+			return;
+		}
+
+		computePool->Submit([this, callback = std::move(request.callback), file = std::move(file)]() mutable {
+			callback(file);
+			pendingReads--;
+		}, request.priority);
+	}
+
+	void IOService::ReadAsync(const filespace::filepath& path, ReadCallback onComplete, ThreadPool::TaskPriority priority)
+	{
+		Enqueue({ path, std::move(onComplete), priority });
+	}
+
+	std::future<FileBuffer> IOService::Read(const filespace::filepath& path)
+	{
+		auto promise = std::make_shared<std::promise<FileBuffer>>();
+		std::future<FileBuffer> result = promise->get_future();
+
+		Enqueue({ path, [promise](FileBuffer& file) { promise->set_value(std::move(file)); }, ThreadPool::TaskPriority::High });
+
+		return result;
+	}
+
+	FileBuffer IOService::ReadBlocking(const filespace::filepath& path)
+	{
+		std::future<FileBuffer> result = Read(path);
+		if (computePool)
+			computePool->Wait(result);
+		return result.get();
+	}
+
+	FileBuffer IOService::ReadFile(const filespace::filepath& path)
+	{
+		FileBuffer file;
+		file.path = path;
+
+		std::ifstream stream(path, std::ios::binary | std::ios::ate);
+		if (!stream.is_open()) {
+			std::cout << "Failed to open file for read: " << path.string() << std::endl;
+			return file;
+		}
+
+		const std::streamsize size = stream.tellg();
+		if (size < 0) {
+			std::cout << "Failed to get the size of file: " << path.string() << std::endl;
+			return file;
+		}
+
+		file.bytes.resize(static_cast<size_t>(size));
+		stream.seekg(0, std::ios::beg);
+		if (size > 0 && !stream.read(reinterpret_cast<char*>(file.bytes.data()), size)) {
+			std::cout << "Failed to read file: " << path.string() << std::endl;
+			file.bytes.clear();
+			return file;
+		}
+
+		file.succeeded = true;
+		return file;
+	}
+
+	IOService& IOService::GetIOService()
+	{
+		return ioService;
+	}
+
+}
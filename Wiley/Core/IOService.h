@@ -0,0 +1,103 @@
+#pragma once
+#include "ThreadPool.h"
+#include "FileSpace.h"
+
+#include <span>
+#include <deque>
+#include <mutex>
+#include <future>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+namespace Wiley {
+
+	/// <summary>
+	///		Contents of a file read by the IOService. Check succeeded (or the bool conversion) before using the bytes.
+	/// </summary>
+	struct FileBuffer
+	{
+		filespace::filepath path;
+		std::vector<uint8_t> bytes;
+		bool succeeded = false;
+
+		std::span<const uint8_t> Span()const { return { bytes.data(), bytes.size() }; }
+		explicit operator bool()const { return succeeded; }
+	};
+
+	/// <summary>
+	///		Reads files on a small set of dedicated I/O threads so compute workers never block on the disk.
+	///		Completion callbacks are submitted to the compute ThreadPool, which is where decoding should happen.
+	///		When the service has not been initialized reads happen on the calling thread.
+	/// </summary>
+	class IOService
+	{
+	public:
+		using ReadCallback = std::function<void(FileBuffer& file)>;
+
+		IOService();
+		~IOService();
+
+		void Initialize(int nThreads = 2, ThreadPool& computePool = gThreadPool);
+
+		/// <summary>
+		///		Finishes every queued read and joins the I/O threads. Safe to call more than once.
+		///		Must run before the compute pool shuts down since completions are submitted to it.
+		/// </summary>
+		void Shutdown();
+
+		/// <summary>
+		///		Queues a read. onComplete runs on a compute worker with the file contents, or with succeeded == false if the read failed.
+		/// </summary>
+		void ReadAsync(const filespace::filepath& path, ReadCallback onComplete, ThreadPool::TaskPriority priority = ThreadPool::TaskPriority::Normal);
+
+		/// <summary>
+		///		Queues a read and returns a future for its contents.
+		///		The future is fulfilled from a compute task so threads helping the pool in Wait() are woken when it is ready.
+		/// </summary>
+		std::future<FileBuffer> Read(const filespace::filepath& path);
+
+		/// <summary>
+		///		Read() followed by helping the compute pool until the contents are available.
+		/// </summary>
+		FileBuffer ReadBlocking(const filespace::filepath& path);
+
+		/// <summary>
+		///		Reads a whole file on the calling thread.
+		/// </summary>
+		static FileBuffer ReadFile(const filespace::filepath& path);
+
+		size_t GetPendingReadCount()const { return pendingReads.load(); }
+
+		static IOService& GetIOService();
+
+	private:
+		struct Request
+		{
+			filespace::filepath path;
+			ReadCallback callback;
+			ThreadPool::TaskPriority priority;
+		};
+
+		void IOLoop();
+		void Enqueue(Request&& request);
+		void Complete(Request& request, FileBuffer& file);
+
+	private:
+		std::vector<std::thread> threads;
+		ThreadPool* computePool = nullptr;
+
+		std::mutex requestMutex;
+		std::condition_variable requestCondition;
+		std::deque<Request> requests;
+		bool stop = false;
+
+		std::atomic<size_t> pendingReads{ 0 };
+	};
+
+#define gIOService IOService::GetIOService()
+
+}
@@ -133,7 +133,7 @@ namespace Wiley
 
     void Input::Tick()
     {
-        ZoneScopedN("RenderContext::RenderContext");
+        TraceZoneN("RenderContext::RenderContext");
 
         if (deferred) {
             inputEvent.windowResizeEvent.Broadcast(deferredWidth, deferredHeight);
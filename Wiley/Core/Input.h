@@ -1,6 +1,6 @@
 #pragma once
 #include "Delegate.h"
-#include "Tracy/tracy/Tracy.hpp"
+#include "TracyWrapper.h"
 
 #include <stdint.h>
 #include <unordered_map>
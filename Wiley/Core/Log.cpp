@@ -1,12 +1,226 @@
 #include "log.h"
 
+#include <ctime>
+#include <iostream>
+
 namespace Wiley {
 
-	Log s_log;
+	Log::Log()
+		:records(std::make_unique<Record[]>(kRecordCount))
+	{
+		for (uint64_t i = 0; i < kRecordCount; i++)
+			records[i].sequence.store(i, std::memory_order_relaxed);
+
+		sinkThread = std::thread(&Log::SinkThread, this);
+	}
+
+	Log::~Log()
+	{
+		running.store(false, std::memory_order_release);
+		sinkSleeping.store(false, std::memory_order_seq_cst);
+		sinkSleeping.notify_one();
+		if (sinkThread.joinable())
+			sinkThread.join();
+	}
 
 	Log& Log::logger()
 	{
+		//Constructed on first use so the sink thread only exists once something logs.
+		static Log s_log;
 		return s_log;
 	}
 
+	void Log::setConsoleOutput(bool enabled)
+	{
+		std::lock_guard<std::mutex> lock(outputMutex);
+		consoleOutput = enabled;
+	}
+
+	bool Log::setLogFile(const std::filesystem::path& path)
+	{
+		std::lock_guard<std::mutex> lock(outputMutex);
+		if (file.is_open())
+			file.close();
+
+		if (path.empty())
+			return true;
+
+		file.open(path, std::ios::out | std::ios::trunc);
+		return file.is_open();
+	}
+
+	void Log::flush()
+	{
+		const uint64_t target = enqueuePosition.load(std::memory_order_acquire);
+
+		sinkSleeping.store(false, std::memory_order_seq_cst);
+		sinkSleeping.notify_one();
+
+		while (writtenPosition.load(std::memory_order_acquire) < target)
+			std::this_thread::yield();
+	}
+
+	Log::Stats Log::getStats()const
+	{
+		Stats stats{};
+		stats.written = written.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < dropped.size(); i++)
+			stats.dropped[i] = dropped[i].load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	/// <summary>
+	///		Bounded MPMC queue claim (Vyukov). A record is free for position p when its sequence equals p,
+	///		holds a published message when it equals p + 1, and the consumer hands it back for the next lap with p + kRecordCount.
+	/// </summary>
+	Log::Record* Log::AcquireRecord(uint64_t& position)
+	{
+		position = enqueuePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Record* record = GetRecord(position);
+			const uint64_t sequence = record->sequence.load(std::memory_order_acquire);
+			const int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+
+			if (difference == 0)
+			{
+				if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					return record;
+			}
+			else if (difference < 0)
+			{
+				return nullptr;
+			}
+			else
+			{
+				position = enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void Log::PublishRecord(Record* record, uint64_t position)
+	{
+		record->sequence.store(position + 1, std::memory_order_release);
+
+		//Pairs with the fence in SinkThread so either we see it going to sleep or it sees this record.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sinkSleeping.load(std::memory_order_relaxed))
+		{
+			sinkSleeping.store(false, std::memory_order_relaxed);
+			sinkSleeping.notify_one();
+		}
+	}
+
+	void Log::SinkThread()
+	{
+		std::string batch;
+		batch.reserve(64 * 1024);
+
+		while (true)
+		{
+			if (Drain(batch) > 0)
+				continue;
+
+			if (!running.load(std::memory_order_acquire))
+				break;
+
+			sinkSleeping.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			const uint64_t next = dequeuePosition.load(std::memory_order_relaxed);
+			const bool hasRecord = GetRecord(next)->sequence.load(std::memory_order_acquire) == next + 1;
+			if (!hasRecord && running.load(std::memory_order_acquire))
+				sinkSleeping.wait(true, std::memory_order_acquire);
+
+			sinkSleeping.store(false, std::memory_order_relaxed);
+		}
+	}
+
+	/// <summary>
+	///		Formats every published record into one batch and writes it with a single flush.
+	/// </summary>
+	size_t Log::Drain(std::string& batch)
+	{
+		batch.clear();
+		size_t count = 0;
+
+		uint64_t position = dequeuePosition.load(std::memory_order_relaxed);
+		while (true)
+		{
+			Record* record = GetRecord(position);
+			if (record->sequence.load(std::memory_order_acquire) != position + 1)
+				break;
+
+			const auto time = std::chrono::system_clock::time_point(std::chrono::system_clock::duration(record->timestamp));
+			const std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+			std::tm localTime;
+#ifdef _WIN32
+			localtime_s(&localTime, &seconds);
+#else
+			localtime_r(&seconds, &localTime);
+#endif
+			char timeString[16];
+			const size_t timeLength = std::strftime(timeString, sizeof(timeString), "%I:%M %p", &localTime);
+
+			batch.append(timeString, timeLength);
+			batch += kLogLevelStrings[static_cast<size_t>(record->level)];
+			batch += record->file;
+			batch += ':';
+			batch += std::to_string(record->line);
+			batch += ' ';
+
+			//A bad format string only throws here on the sink thread, so it must not take the process down with it.
+			const size_t messageStart = batch.size();
+			try {
+				record->format(record->args, record->fmt, batch);
+			}
+			catch (const std::format_error& e) {
+				batch.resize(messageStart);
+				batch += "[format error: ";
+				batch += e.what();
+				batch += "] ";
+				batch += record->fmt;
+			}
+			batch += '\n';
+
+			record->sequence.store(position + kRecordCount, std::memory_order_release);
+			position++;
+			count++;
+		}
+		dequeuePosition.store(position, std::memory_order_relaxed);
+
+		ReportDrops(batch);
+
+		if (!batch.empty())
+		{
+			std::lock_guard<std::mutex> lock(outputMutex);
+			if (consoleOutput)
+				std::cout.write(batch.data(), batch.size()).flush();
+			if (file.is_open())
+				file.write(batch.data(), batch.size()).flush();
+		}
+
+		written.fetch_add(count, std::memory_order_relaxed);
+		writtenPosition.store(position, std::memory_order_release);
+		return count;
+	}
+
+	void Log::ReportDrops(std::string& batch)
+	{
+		for (size_t i = 0; i < dropped.size(); i++)
+		{
+			const uint64_t total = dropped[i].load(std::memory_order_relaxed);
+			if (total == reportedDrops[i])
+				continue;
+
+			batch += kLogLevelStrings[static_cast<size_t>(LogLevel::WARNING)];
+			batch += " log ring full, dropped ";
+			batch += std::to_string(total - reportedDrops[i]);
+			batch += ' ';
+			batch += kLogLevelStrings[i];
+			batch += " messages\n";
+			reportedDrops[i] = total;
+		}
+	}
+
 }
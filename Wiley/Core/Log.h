@@ -1,21 +1,77 @@
-﻿#pragma once
-#include "Timer.h"
+#pragma once
 
 #include <array>
+#include <atomic>
+#include <algorithm>
 #include <string>
-#include <print>
-#include <iostream>
+#include <format>
+#include <tuple>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
 #include <string_view>
+#include <filesystem>
 
 namespace Wiley {
 
+#define WILEY_LOG_LEVEL_FATAL   0
+#define WILEY_LOG_LEVEL_ERROR   1
+#define WILEY_LOG_LEVEL_WARNING 2
+#define WILEY_LOG_LEVEL_INFO    3
+#define WILEY_LOG_LEVEL_DEBUG   4
+
+	//Levels above this are compiled out entirely, including their arguments. Override it in the project's preprocessor definitions.
+#ifndef WILEY_LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define WILEY_LOG_MIN_LEVEL WILEY_LOG_LEVEL_DEBUG
+#else
+#define WILEY_LOG_MIN_LEVEL WILEY_LOG_LEVEL_INFO
+#endif
+#endif
+
+#define WILEY_LOG_FATAL(fmt,...)  Log::fatal(__FILE__, __LINE__, fmt, ##__VA_ARGS__)
+
+#if WILEY_LOG_MIN_LEVEL >= WILEY_LOG_LEVEL_ERROR
+#define WILEY_LOG_ERROR(fmt,...)  Log::error(__FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#else
+#define WILEY_LOG_ERROR(fmt,...)  ((void)0)
+#endif
+
+#if WILEY_LOG_MIN_LEVEL >= WILEY_LOG_LEVEL_WARNING
+#define WILEY_LOG_WARN(fmt, ...)  Log::warn(__FILE__,  __LINE__, fmt, ##__VA_ARGS__)
+#else
+#define WILEY_LOG_WARN(fmt, ...)  ((void)0)
+#endif
+
+#if WILEY_LOG_MIN_LEVEL >= WILEY_LOG_LEVEL_INFO
 #define WILEY_LOG_INFO(fmt, ...)  Log::info(__FILE__,  __LINE__, fmt, ##__VA_ARGS__)
+#else
+#define WILEY_LOG_INFO(fmt, ...)  ((void)0)
+#endif
+
+#if WILEY_LOG_MIN_LEVEL >= WILEY_LOG_LEVEL_DEBUG
 #define WILEY_LOG_DEBUG(fmt,...)  Log::debug(__FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define WILEY_LOG_WARN(fmt, ...)  Log::warn(__FILE__,  __LINE__, fmt, ##__VA_ARGS__)
-#define WILEY_LOG_ERROR(fmt,...)  Log::error(__FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define WILEY_LOG_FATAL(fmt,...)  Log::fatal(__FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#else
+#define WILEY_LOG_DEBUG(fmt,...)  ((void)0)
+#endif
 
 
+	/// <summary>
+	///		Asynchronous logger. A log call copies its arguments in binary form into a fixed-size record of a lock-free
+	///		multi-producer ring and returns. A sink thread formats the records and writes them to the console and the log file.
+	///		Strings are copied into the record (truncated if the record is full), trivially copyable arguments are stored as-is
+	///		and anything else is formatted on the calling thread. The format string and file name must outlive the call, which
+	///		string literals from the WILEY_LOG_* macros do.
+	///		When the ring is full new messages are dropped and counted, and the sink reports the count once it catches up.
+	///		FATAL messages wait until everything logged before them has been written.
+	/// </summary>
 	class Log
 	{
 	public:
@@ -28,85 +84,240 @@ namespace Wiley {
 			DEBUG,  //Just temp debug stuff
 		};
 
-		std::array <std::string_view, 5> kLogLevelStrings{ "[FATAL]:","[ERROR]:","[WARNING]:","[INFO]:","[DEBUG]:" };
+		static constexpr std::array <std::string_view, 5> kLogLevelStrings{ "[FATAL]:","[ERROR]:","[WARNING]:","[INFO]:","[DEBUG]:" };
 
-		void setLogLevel(LogLevel level) { mLogLevel = level; }
+		static constexpr size_t kRecordCount = 4096;
+		static constexpr size_t kRecordSize = 256;
+
+		struct Stats
+		{
+			uint64_t written = 0;
+			std::array<uint64_t, 5> dropped{};
+		};
+
+		Log();
+		~Log();
+
+		Log(const Log&) = delete;
+		Log& operator=(const Log&) = delete;
+
+		void setLogLevel(LogLevel level) { mLogLevel.store(level, std::memory_order_relaxed); }
+
+		void setConsoleOutput(bool enabled);
+
+		/// <summary>
+		///		Also writes to the given file, truncating it. An empty path closes the current file.
+		/// </summary>
+		bool setLogFile(const std::filesystem::path& path);
+
+		/// <summary>
+		///		Blocks until everything logged before the call has been written.
+		/// </summary>
+		void flush();
+
+		Stats getStats()const;
 
 		static Log& logger();
+
 		/// @brief base logging function
 		template <typename... Args>
-		void log(LogLevel level, const std::string& file, int line, const std::string& fmt, Args&&... args)
+		void log(LogLevel level, const char* file, int line, const char* fmt, Args&&... args)
 		{
-			if (level > mLogLevel)
-				return;
-
-			// Get timestamp
-			std::string t;
-			WILEY_SYS_TIME(t);
+			static_assert((FixedSize<Stored<Args>>() + ... + 0) <= kArgBytes, "Too many arguments to fit in one log record.");
 
-			std::string formattLogLeveledMessage;
+			if (level > mLogLevel.load(std::memory_order_relaxed))
+				return;
 
-#if __cplusplus >= 202002L
-			// ✅ C++20 and newer: use {} placeholders
-			if constexpr (sizeof...(args) > 0)
+			const size_t levelIndex = static_cast<size_t>(level);
+			uint64_t position;
+			Record* record = AcquireRecord(position);
+			if (!record)
 			{
-				formattLogLeveledMessage = std::vformat(fmt, std::make_format_args(std::forward<Args>(args)...));
-			}
-			else
-			{
-				formattLogLeveledMessage = fmt;
-			}
-#else
-			// ✅ Pre-C++20: fallback to printf-style formatting (%s, %d, etc.)
-			if constexpr (sizeof...(args) > 0)
-			{
-				char buffer[4096];
-				std::snprintf(buffer, sizeof(buffer), fmt.c_str(), std::forward<Args>(args)...);
-				formattLogLeveledMessage = buffer;
-			}
-			else
-			{
-				formattLogLeveledMessage = fmt;
+				dropped[levelIndex].fetch_add(1, std::memory_order_relaxed);
+				return;
 			}
-#endif
 
-			std::string logLevelString = kLogLevelStrings[(int)level].data();
-			std::string finalMessage = t + logLevelString + file + ":" + std::to_string(line) + " " + formattLogLeveledMessage + "\n";
+			record->level = level;
+			record->line = line;
+			record->file = file;
+			record->fmt = fmt;
+			record->timestamp = std::chrono::system_clock::now().time_since_epoch().count();
+			record->format = &FormatRecord<Stored<Args>...>;
 
-			std::cout << finalMessage.c_str() << std::endl;
+			std::byte* cursor = record->args;
+			size_t stringBudget = kArgBytes - (FixedSize<Stored<Args>>() + ... + 0);
+			(Encode<Args>(cursor, stringBudget, args), ...);
+
+			PublishRecord(record, position);
+
+			if (level == LogLevel::FATAL)
+				flush();
 		}
 
 
 		template <typename... Args>
-		static void fatal(const std::string& file, int line, const std::string& fmt, Args&&... args)
+		static void fatal(const char* file, int line, const char* fmt, Args&&... args)
 		{
 			logger().log(LogLevel::FATAL, file, line, fmt, std::forward<Args>(args)...);
 		}
 
 		template <typename... Args>
-		static void error(const std::string& file, int line, const std::string& fmt, Args&&... args)
+		static void error(const char* file, int line, const char* fmt, Args&&... args)
 		{
 			logger().log(LogLevel::ERROR, file, line, fmt, std::forward<Args>(args)...);
 		}
 
 		template <typename... Args>
-		static void warn(const std::string& file, int line, const std::string& fmt, Args&&... args)
+		static void warn(const char* file, int line, const char* fmt, Args&&... args)
 		{
 			logger().log(LogLevel::WARNING, file, line, fmt, std::forward<Args>(args)...);
 		}
 
 		template <typename... Args>
-		static void info(const std::string& file, int line, const std::string& fmt, Args&&... args)
+		static void info(const char* file, int line, const char* fmt, Args&&... args)
 		{
 			logger().log(LogLevel::INFO, file, line, fmt, std::forward<Args>(args)...);
 		}
 
 		template <typename... Args>
-		static void debug(const std::string& file, int line, const std::string& fmt, Args&&... args)
+		static void debug(const char* file, int line, const char* fmt, Args&&... args)
 		{
 			logger().log(LogLevel::DEBUG, file, line, fmt, std::forward<Args>(args)...);
 		}
 
-		LogLevel mLogLevel = LogLevel::DEBUG;
+	private:
+		using FormatFn = void(*)(const std::byte* args, const char* fmt, std::string& out);
+
+		struct RecordHeader
+		{
+			std::atomic<uint64_t> sequence;
+			LogLevel level;
+			int line;
+			const char* file;
+			const char* fmt;
+			int64_t timestamp;
+			FormatFn format;
+		};
+
+		static constexpr size_t kArgBytes = kRecordSize - sizeof(RecordHeader);
+
+		struct alignas(64) Record : RecordHeader
+		{
+			std::byte args[kArgBytes];
+		};
+
+		template<typename T>
+		static constexpr bool IsStringLike = std::is_convertible_v<const std::decay_t<T>&, std::string_view>;
+
+		//How an argument is kept in a record: strings as a length-prefixed copy, trivially copyable values as raw bytes,
+		//and everything else pre-formatted into a string.
+		template<typename T>
+		using Stored = std::conditional_t<IsStringLike<T> || !std::is_trivially_copyable_v<std::decay_t<T>>, std::string_view, std::decay_t<T>>;
+
+		template<typename S>
+		static constexpr size_t FixedSize()
+		{
+			if constexpr (std::is_same_v<S, std::string_view>)
+				return sizeof(uint16_t);
+			else
+				return sizeof(S);
+		}
+
+		template<typename T>
+		static void Encode(std::byte*& cursor, size_t& stringBudget, const T& value)
+		{
+			if constexpr (IsStringLike<T>)
+			{
+				EncodeString(cursor, stringBudget, std::string_view(value));
+			}
+			else if constexpr (!std::is_trivially_copyable_v<std::decay_t<T>>)
+			{
+				const std::string formatted = std::format("{}", value);
+				EncodeString(cursor, stringBudget, formatted);
+			}
+			else
+			{
+				std::memcpy(cursor, &value, sizeof(value));
+				cursor += sizeof(value);
+			}
+		}
+
+		static void EncodeString(std::byte*& cursor, size_t& stringBudget, std::string_view string)
+		{
+			const uint16_t length = static_cast<uint16_t>(std::min(string.size(), stringBudget));
+			std::memcpy(cursor, &length, sizeof(length));
+			std::memcpy(cursor + sizeof(length), string.data(), length);
+			cursor += sizeof(length) + length;
+			stringBudget -= length;
+		}
+
+		template<typename S>
+		static S Decode(const std::byte*& cursor)
+		{
+			if constexpr (std::is_same_v<S, std::string_view>)
+			{
+				uint16_t length;
+				std::memcpy(&length, cursor, sizeof(length));
+				const std::string_view string(reinterpret_cast<const char*>(cursor + sizeof(length)), length);
+				cursor += sizeof(length) + length;
+				return string;
+			}
+			else
+			{
+				S value;
+				std::memcpy(&value, cursor, sizeof(S));
+				cursor += sizeof(S);
+				return value;
+			}
+		}
+
+		template<typename... S>
+		static void FormatRecord(const std::byte* args, const char* fmt, std::string& out)
+		{
+			if constexpr (sizeof...(S) == 0)
+			{
+				out += fmt;
+			}
+			else
+			{
+				const std::byte* cursor = args;
+				std::tuple<S...> values{ Decode<S>(cursor)... };
+				std::apply([&](auto&... value) {
+					std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(value...));
+				}, values);
+			}
+		}
+
+		Record* GetRecord(uint64_t position) { return &records[position & (kRecordCount - 1)]; }
+
+		Record* AcquireRecord(uint64_t& position);
+		void PublishRecord(Record* record, uint64_t position);
+
+		void SinkThread();
+		size_t Drain(std::string& batch);
+		void ReportDrops(std::string& batch);
+
+	private:
+		static_assert((kRecordCount & (kRecordCount - 1)) == 0, "Log record count must be a power of two.");
+
+		std::unique_ptr<Record[]> records;
+
+		alignas(64) std::atomic<uint64_t> enqueuePosition{ 0 };
+		alignas(64) std::atomic<uint64_t> dequeuePosition{ 0 };
+		std::atomic<uint64_t> writtenPosition{ 0 };
+
+		std::atomic<bool> sinkSleeping{ false };
+		std::atomic<bool> running{ true };
+		std::thread sinkThread;
+
+		std::array<std::atomic<uint64_t>, 5> dropped{};
+		std::array<uint64_t, 5> reportedDrops{};
+		std::atomic<uint64_t> written{ 0 };
+
+		std::mutex outputMutex;
+		bool consoleOutput = true;
+		std::ofstream file;
+
+		std::atomic<LogLevel> mLogLevel{ LogLevel::DEBUG };
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,146 @@
+#include "MemoryTracker.h"
+#include "TracyWrapper.h"
+
+#include <iostream>
+
+namespace Wiley
+{
+	MemoryTracker::MemoryTracker()
+	{
+	}
+
+	void MemoryTracker::RecordAlloc(MemoryTag tag, size_t bytes, size_t count)
+	{
+		Counters& c = counters[static_cast<size_t>(tag)];
+		c.liveBytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+		c.liveCount.fetch_add(static_cast<int64_t>(count), std::memory_order_relaxed);
+		OnFootprintChanged(tag);
+	}
+
+	void MemoryTracker::RecordFree(MemoryTag tag, size_t bytes, size_t count)
+	{
+		Counters& c = counters[static_cast<size_t>(tag)];
+		c.liveBytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+		c.liveCount.fetch_sub(static_cast<int64_t>(count), std::memory_order_relaxed);
+		OnFootprintChanged(tag);
+	}
+
+	void MemoryTracker::RecordReserve(MemoryTag tag, size_t bytes)
+	{
+		counters[static_cast<size_t>(tag)].reservedBytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+		OnFootprintChanged(tag);
+	}
+
+	void MemoryTracker::RecordRelease(MemoryTag tag, size_t bytes)
+	{
+		counters[static_cast<size_t>(tag)].reservedBytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+		OnFootprintChanged(tag);
+	}
+
+	void MemoryTracker::SetBudget(MemoryTag tag, size_t bytes)
+	{
+		counters[static_cast<size_t>(tag)].budgetBytes = static_cast<int64_t>(bytes);
+		OnFootprintChanged(tag);
+	}
+
+	void MemoryTracker::OnFootprintChanged(MemoryTag tag)
+	{
+		Counters& c = counters[static_cast<size_t>(tag)];
+
+		const int64_t live = c.liveBytes.load(std::memory_order_relaxed);
+		const int64_t reserved = c.reservedBytes.load(std::memory_order_relaxed);
+		const int64_t footprint = (live > reserved) ? live : reserved;
+
+		int64_t peak = c.peakBytes.load(std::memory_order_relaxed);
+		while (footprint > peak && !c.peakBytes.compare_exchange_weak(peak, footprint, std::memory_order_relaxed)) {}
+
+		const int64_t budget = c.budgetBytes.load(std::memory_order_relaxed);
+		const bool overBudget = budget > 0 && footprint > budget;
+		if (c.overBudget.exchange(overBudget) != overBudget && overBudget)
+		{
+			std::cout << "WARNING :: " << GetTagName(tag) << " memory is over budget (" << footprint << " / " << budget << " bytes)." << std::endl;
+		}
+	}
+
+	MemoryTracker::Snapshot MemoryTracker::GetSnapshot()const
+	{
+		Snapshot snapshot{};
+		for (size_t i = 0; i < kTagCount; i++)
+		{
+			const Counters& c = counters[i];
+			TagStats& stats = snapshot.tags[i];
+
+			stats.liveBytes = c.liveBytes.load(std::memory_order_relaxed);
+			stats.liveCount = c.liveCount.load(std::memory_order_relaxed);
+			stats.reservedBytes = c.reservedBytes.load(std::memory_order_relaxed);
+			stats.peakBytes = c.peakBytes.load(std::memory_order_relaxed);
+			stats.budgetBytes = c.budgetBytes.load(std::memory_order_relaxed);
+		}
+		return snapshot;
+	}
+
+	MemoryTracker::Snapshot MemoryTracker::Snapshot::Diff(const Snapshot& older)const
+	{
+		Snapshot diff{};
+		for (size_t i = 0; i < kTagCount; i++)
+		{
+			diff.tags[i].liveBytes = tags[i].liveBytes - older.tags[i].liveBytes;
+			diff.tags[i].liveCount = tags[i].liveCount - older.tags[i].liveCount;
+			diff.tags[i].reservedBytes = tags[i].reservedBytes - older.tags[i].reservedBytes;
+			diff.tags[i].peakBytes = tags[i].peakBytes - older.tags[i].peakBytes;
+			diff.tags[i].budgetBytes = tags[i].budgetBytes;
+		}
+		return diff;
+	}
+
+	void MemoryTracker::Snapshot::Dump(std::ostream& stream)const
+	{
+		for (size_t i = 0; i < kTagCount; i++)
+		{
+			const char* name = GetTagName(static_cast<MemoryTag>(i));
+			const TagStats& stats = tags[i];
+
+			stream << name << ".live_bytes " << stats.liveBytes << "\n";
+			stream << name << ".live_count " << stats.liveCount << "\n";
+			stream << name << ".reserved_bytes " << stats.reservedBytes << "\n";
+			stream << name << ".peak_bytes " << stats.peakBytes << "\n";
+			stream << name << ".budget_bytes " << stats.budgetBytes << "\n";
+		}
+	}
+
+	void MemoryTracker::PlotToTracy()const
+	{
+		for (size_t i = 0; i < kTagCount; i++)
+		{
+			const Counters& c = counters[i];
+			const int64_t live = c.liveBytes.load(std::memory_order_relaxed);
+			const int64_t reserved = c.reservedBytes.load(std::memory_order_relaxed);
+
+			TracePlot(GetTagName(static_cast<MemoryTag>(i)), (live > reserved) ? live : reserved);
+			TracyPlotConfig(GetTagName(static_cast<MemoryTag>(i)), tracy::PlotFormatType::Memory, false, true, 0);
+		}
+	}
+
+	const char* MemoryTracker::GetTagName(MemoryTag tag)
+	{
+		switch (tag)
+		{
+			case MemoryTag::General: return "General";
+			case MemoryTag::VertexPool: return "VertexPool";
+			case MemoryTag::IndexPool: return "IndexPool";
+			case MemoryTag::MaterialData: return "MaterialData";
+			case MemoryTag::SceneData: return "SceneData";
+			case MemoryTag::ShadowMaps: return "ShadowMaps";
+			case MemoryTag::Resources: return "Resources";
+			case MemoryTag::Textures: return "Textures";
+			default: return "Unknown";
+		}
+	}
+
+	MemoryTracker& MemoryTracker::GetMemoryTracker()
+	{
+		static MemoryTracker memoryTracker;
+		return memoryTracker;
+	}
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <ostream>
+#include <cstdint>
+
+namespace Wiley {
+
+	enum class MemoryTag : uint8_t
+	{
+		General,
+		VertexPool,
+		IndexPool,
+		MaterialData,
+		SceneData,
+		ShadowMaps,
+		Resources,
+		Textures,
+		Count
+	};
+
+	/// <summary>
+	///		Counts bytes and allocations per subsystem tag.
+	///		Allocators report two things: reserved bytes are the memory backing a pool (a malloc'd block or a committed GPU buffer),
+	///		live bytes are what has been handed out of it. Memory that is not pooled is reported as live only.
+	///		A tag's footprint is the larger of the two and is what budgets are checked against.
+	/// </summary>
+	class MemoryTracker
+	{
+	public:
+		static constexpr size_t kTagCount = static_cast<size_t>(MemoryTag::Count);
+
+		struct TagStats
+		{
+			int64_t liveBytes = 0;
+			int64_t liveCount = 0;
+			int64_t reservedBytes = 0;
+			int64_t peakBytes = 0;
+			int64_t budgetBytes = 0;
+
+			int64_t GetFootprint()const { return (liveBytes > reservedBytes) ? liveBytes : reservedBytes; }
+		};
+
+		struct Snapshot
+		{
+			std::array<TagStats, kTagCount> tags{};
+
+			const TagStats& operator[](MemoryTag tag)const { return tags[static_cast<size_t>(tag)]; }
+
+			/// <summary>
+			///		Per-tag change since an older snapshot. Budgets are copied rather than subtracted.
+			/// </summary>
+			Snapshot Diff(const Snapshot& older)const;
+
+			/// <summary>
+			///		Writes one "tag.field value" pair per line so dumps can be diffed.
+			/// </summary>
+			void Dump(std::ostream& stream)const;
+		};
+
+		MemoryTracker();
+
+		void RecordAlloc(MemoryTag tag, size_t bytes, size_t count = 1);
+		void RecordFree(MemoryTag tag, size_t bytes, size_t count = 1);
+		void RecordReserve(MemoryTag tag, size_t bytes);
+		void RecordRelease(MemoryTag tag, size_t bytes);
+
+		/// <summary>
+		///		A warning is printed the first time the tag's footprint goes over budget, and again after it has dropped back under it.
+		///		0 disables the budget.
+		/// </summary>
+		void SetBudget(MemoryTag tag, size_t bytes);
+
+		Snapshot GetSnapshot()const;
+
+		/// <summary>
+		///		Plots every tag's footprint to Tracy. Call once per frame.
+		/// </summary>
+		void PlotToTracy()const;
+
+		static const char* GetTagName(MemoryTag tag);
+		static MemoryTracker& GetMemoryTracker();
+
+	private:
+		struct Counters
+		{
+			std::atomic<int64_t> liveBytes{ 0 };
+			std::atomic<int64_t> liveCount{ 0 };
+			std::atomic<int64_t> reservedBytes{ 0 };
+			std::atomic<int64_t> peakBytes{ 0 };
+			std::atomic<int64_t> budgetBytes{ 0 };
+			std::atomic<bool> overBudget{ false };
+		};
+
+		void OnFootprintChanged(MemoryTag tag);
+
+	private:
+		std::array<Counters, kTagCount> counters;
+	};
+
+#define gMemoryTracker MemoryTracker::GetMemoryTracker()
+
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include "ThreadPool.h"
+
+#include <vector>
+#include <ranges>
+#include <concepts>
+#include <algorithm>
+#include <type_traits>
+
+namespace Wiley {
+
+	/// <summary>
+	///		Anything that looks like an EnTT view: a leading sparse set reachable through handle() plus a contains() filter.
+	///		Kept structural so Core does not have to include entt.
+	/// </summary>
+	template<typename View>
+	concept IsEntityView = requires(const View & view, typename View::entity_type entity) {
+		{ view.handle() };
+		{ view.contains(entity) } -> std::convertible_to<bool>;
+	};
+
+	namespace detail {
+
+		/// <summary>
+		///		Picks the chunk size actually used. The caller's grain is a lower bound;
+		///		above that we aim for a handful of chunks per worker so stealing can balance uneven work.
+		/// </summary>
+		inline size_t AdaptiveGrain(size_t count, size_t grain, const ThreadPool& pool)
+		{
+			constexpr size_t kChunksPerWorker = 8;
+			const size_t workers = std::max<size_t>(1, pool.GetWorkerCount() + 1);
+			return std::max<size_t>({ size_t(1), grain, count / (workers * kChunksPerWorker) });
+		}
+
+		/// <summary>
+		///		Lazy binary splitting. Halves the range and hands the upper half to the pool until the remainder fits in one chunk,
+		///		then runs that remainder on the current thread. Stolen halves split again on the thief.
+		/// </summary>
+		template<typename Body>
+		void SplitRange(size_t begin, size_t end, size_t grain, const Body& body, TaskCounter& counter, ThreadPool& pool)
+		{
+			while (end - begin > grain)
+			{
+				const size_t mid = begin + (end - begin) / 2;
+				pool.Submit([mid, end, grain, &body, &counter, &pool]() {
+					SplitRange(mid, end, grain, body, counter, pool);
+				}, counter);
+				end = mid;
+			}
+
+			body(begin, end);
+		}
+
+		/// <summary>
+		///		Runs body(chunkBegin, chunkEnd) over [0, count) and returns once every chunk is done.
+		///		Small ranges never leave the calling thread.
+		/// </summary>
+		template<typename Body>
+		void ParallelChunks(size_t count, size_t grain, const Body& body, ThreadPool& pool)
+		{
+			if (count == 0)
+				return;
+
+			grain = AdaptiveGrain(count, grain, pool);
+			if (count <= grain || pool.GetWorkerCount() == 0) {
+				body(size_t(0), count);
+				return;
+			}
+
+			TaskCounter counter;
+			SplitRange(0, count, grain, body, counter, pool);
+			pool.Wait(counter);
+		}
+	}
+
+	/// <summary>
+	///		Calls fn(i) for every i in [begin, end).
+	/// </summary>
+	template<std::integral Index, typename Function>
+		requires std::invocable<Function&, Index>
+	void ParallelFor(Index begin, Index end, Index grain, Function&& fn, ThreadPool& pool = gThreadPool)
+	{
+		if (end <= begin)
+			return;
+
+		const size_t count = static_cast<size_t>(end - begin);
+		detail::ParallelChunks(count, static_cast<size_t>(grain), [begin, &fn](size_t chunkBegin, size_t chunkEnd) {
+			for (size_t i = chunkBegin; i < chunkEnd; i++)
+				fn(static_cast<Index>(begin + static_cast<Index>(i)));
+		}, pool);
+	}
+
+	/// <summary>
+	///		Calls fn(element) for every element of a sized random access range (std::vector, std::span...).
+	/// </summary>
+	template<std::ranges::random_access_range Range, typename Function>
+		requires std::ranges::sized_range<Range> && (!IsEntityView<std::remove_cvref_t<Range>>)
+	void ParallelFor(Range&& range, size_t grain, Function&& fn, ThreadPool& pool = gThreadPool)
+	{
+		auto first = std::ranges::begin(range);
+		detail::ParallelChunks(static_cast<size_t>(std::ranges::size(range)), grain, [first, &fn](size_t chunkBegin, size_t chunkEnd) {
+			for (size_t i = chunkBegin; i < chunkEnd; i++)
+				fn(first[i]);
+		}, pool);
+	}
+
+	/// <summary>
+	///		Calls fn(entity) for every entity of an EnTT view.
+	///		Splits over the packed array of the view's leading storage and filters each entity with view.contains().
+	/// </summary>
+	template<IsEntityView View, typename Function>
+	void ParallelFor(const View& view, size_t grain, Function&& fn, ThreadPool& pool = gThreadPool)
+	{
+		const auto* set = view.handle();
+		if (set == nullptr)
+			return;
+
+		const auto* entities = set->data();
+		detail::ParallelChunks(static_cast<size_t>(set->size()), grain, [&view, entities, &fn](size_t chunkBegin, size_t chunkEnd) {
+			for (size_t i = chunkBegin; i < chunkEnd; i++)
+				if (view.contains(entities[i]))
+					fn(entities[i]);
+		}, pool);
+	}
+
+	/// <summary>
+	///		Folds map(i) over [begin, end) with combine. Partial results are combined in index order,
+	///		so the result is deterministic for a given grain and worker count even for non-associative floating point combines.
+	/// </summary>
+	template<typename T, std::integral Index, typename Map, typename Combine>
+		requires std::invocable<Map&, Index> && std::invocable<Combine&, T, T>
+	T ParallelReduce(Index begin, Index end, Index grain, T identity, Map&& map, Combine&& combine, ThreadPool& pool = gThreadPool)
+	{
+		if (end <= begin)
+			return identity;
+
+		const size_t count = static_cast<size_t>(end - begin);
+		const size_t chunk = detail::AdaptiveGrain(count, static_cast<size_t>(grain), pool);
+		const size_t chunkCount = (count + chunk - 1) / chunk;
+
+		std::vector<T> partials(chunkCount, identity);
+		detail::ParallelChunks(chunkCount, 1, [&](size_t firstChunk, size_t lastChunk) {
+			for (size_t c = firstChunk; c < lastChunk; c++)
+			{
+				const size_t chunkBegin = c * chunk;
+				const size_t chunkEnd = std::min(count, chunkBegin + chunk);
+
+				T value = identity;
+				for (size_t i = chunkBegin; i < chunkEnd; i++)
+					value = combine(value, map(static_cast<Index>(begin + static_cast<Index>(i))));
+				partials[c] = value;
+			}
+		}, pool);
+
+		T result = identity;
+		for (const T& partial : partials)
+			result = combine(result, partial);
+		return result;
+	}
+
+	/// <summary>
+	///		Folds map(element) over a sized random access range.
+	/// </summary>
+	template<typename T, std::ranges::random_access_range Range, typename Map, typename Combine>
+		requires std::ranges::sized_range<Range> && (!IsEntityView<std::remove_cvref_t<Range>>)
+	T ParallelReduce(Range&& range, size_t grain, T identity, Map&& map, Combine&& combine, ThreadPool& pool = gThreadPool)
+	{
+		auto first = std::ranges::begin(range);
+		const size_t count = static_cast<size_t>(std::ranges::size(range));
+		return ParallelReduce<T>(size_t(0), count, grain, std::move(identity),
+			[first, &map](size_t i) { return map(first[i]); }, combine, pool);
+	}
+
+}
@@ -0,0 +1,64 @@
+#include "SimdSupport.h"
+
+#if defined(WILEY_SIMD_AVX) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Wiley {
+
+	namespace {
+
+#ifdef WILEY_SIMD_AVX
+		bool CpuSupportsAVX()
+		{
+#ifdef _MSC_VER
+			int info[4];
+			__cpuid(info, 1);
+			const bool osUsesXSave = (info[2] & (1 << 27)) != 0;
+			const bool hasAVX = (info[2] & (1 << 28)) != 0;
+			//The OS also has to save the upper halves of the ymm registers on context switches.
+			return osUsesXSave && hasAVX && (_xgetbv(0) & 0x6) == 0x6;
+#else
+			//Only built when the compiler already targets AVX.
+			return true;
+#endif
+		}
+#endif
+
+	}
+
+	bool IsSimdPathSupported(SimdPath path)
+	{
+		switch (path)
+		{
+		case SimdPath::Scalar:
+			return true;
+		case SimdPath::SSE:
+#ifdef WILEY_SIMD_SSE
+			return true;
+#else
+			return false;
+#endif
+		case SimdPath::AVX:
+#ifdef WILEY_SIMD_AVX
+		{
+			static const bool supported = CpuSupportsAVX();
+			return supported;
+		}
+#else
+			return false;
+#endif
+		}
+		return false;
+	}
+
+	SimdPath GetSimdPath()
+	{
+		static const SimdPath path =
+			IsSimdPathSupported(SimdPath::AVX) ? SimdPath::AVX :
+			IsSimdPathSupported(SimdPath::SSE) ? SimdPath::SSE :
+			SimdPath::Scalar;
+		return path;
+	}
+
+}
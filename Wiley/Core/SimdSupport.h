@@ -0,0 +1,33 @@
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WILEY_SIMD_SSE 1
+#include <emmintrin.h>
+#endif
+
+//MSVC lets AVX intrinsics through without /arch:AVX, so the 8-wide kernels are always built there and picked at runtime.
+#if defined(WILEY_SIMD_SSE) && (defined(_MSC_VER) || defined(__AVX__))
+#define WILEY_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+
+namespace Wiley {
+
+	/// <summary>
+	///		Instruction sets the batch kernels (TransformBatch, FrustumCulling) are written for.
+	/// </summary>
+	enum class SimdPath {
+		Scalar, SSE, AVX
+	};
+
+	/// <summary>
+	///		Whether this build contains the path and the CPU and OS can run it.
+	/// </summary>
+	bool IsSimdPathSupported(SimdPath path);
+
+	/// <summary>
+	///		The widest supported path. Detected once.
+	/// </summary>
+	SimdPath GetSimdPath();
+
+}
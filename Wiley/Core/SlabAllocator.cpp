@@ -0,0 +1,156 @@
+#include "SlabAllocator.h"
+
+#include <bit>
+#include <new>
+
+namespace Wiley
+{
+	static constexpr size_t kSlabAlignment = 64;
+
+	SlabAllocator::~SlabAllocator()
+	{
+		for (SizeClass& sizeClass : sizeClasses)
+			for (void* slab : sizeClass.slabs)
+				::operator delete(slab, std::align_val_t{ kSlabAlignment });
+	}
+
+	size_t SlabAllocator::GetSizeClass(size_t size)
+	{
+		if (size <= kMinBlockSize)
+			return 0;
+		return std::bit_width((size - 1) / kMinBlockSize);
+	}
+
+	SlabAllocator::ThreadCache& SlabAllocator::GetThreadCache()
+	{
+		thread_local ThreadCache cache;
+		return cache;
+	}
+
+	SlabAllocator::ThreadCache::~ThreadCache()
+	{
+		for (size_t i = 0; i < kSizeClassCount; i++)
+			if (counts[i] > 0)
+				gSlabAllocator.Release(*this, i, counts[i]);
+	}
+
+	/// <summary>
+	///		Moves a batch of blocks from the shared list into the thread cache, carving a new slab when the shared list is empty.
+	/// </summary>
+	void SlabAllocator::Refill(ThreadCache& cache, size_t sizeClass)
+	{
+		SizeClass& sc = sizeClasses[sizeClass];
+		const size_t blockSize = GetBlockSize(sizeClass);
+
+		std::unique_lock<std::mutex> lock(sc.mutex);
+
+		if (!sc.freeList)
+		{
+			uint8_t* slab = static_cast<uint8_t*>(::operator new(kSlabSize, std::align_val_t{ kSlabAlignment }));
+			sc.slabs.push_back(slab);
+
+			//Linked back to front so blocks are handed out in address order.
+			for (size_t offset = kSlabSize; offset >= blockSize; offset -= blockSize)
+			{
+				FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + offset - blockSize);
+				block->next = sc.freeList;
+				sc.freeList = block;
+			}
+		}
+
+		for (size_t i = 0; i < kBatchSize && sc.freeList; i++)
+		{
+			FreeBlock* block = sc.freeList;
+			sc.freeList = block->next;
+
+			block->next = cache.freeLists[sizeClass];
+			cache.freeLists[sizeClass] = block;
+			cache.counts[sizeClass]++;
+		}
+	}
+
+	void SlabAllocator::Release(ThreadCache& cache, size_t sizeClass, size_t count)
+	{
+		SizeClass& sc = sizeClasses[sizeClass];
+
+		std::unique_lock<std::mutex> lock(sc.mutex);
+		for (size_t i = 0; i < count && cache.freeLists[sizeClass]; i++)
+		{
+			FreeBlock* block = cache.freeLists[sizeClass];
+			cache.freeLists[sizeClass] = block->next;
+			cache.counts[sizeClass]--;
+
+			block->next = sc.freeList;
+			sc.freeList = block;
+		}
+	}
+
+	void* SlabAllocator::Allocate(size_t size)
+	{
+		if (size > kMaxBlockSize)
+		{
+			largeAllocations++;
+			return ::operator new(size);
+		}
+
+		const size_t sizeClass = GetSizeClass(size);
+		ThreadCache& cache = GetThreadCache();
+
+		if (!cache.freeLists[sizeClass])
+			Refill(cache, sizeClass);
+
+		FreeBlock* block = cache.freeLists[sizeClass];
+		cache.freeLists[sizeClass] = block->next;
+		cache.counts[sizeClass]--;
+
+		sizeClasses[sizeClass].liveBlocks.fetch_add(1, std::memory_order_relaxed);
+		return block;
+	}
+
+	void SlabAllocator::Free(void* ptr, size_t size)
+	{
+		if (!ptr)
+			return;
+
+		if (size > kMaxBlockSize)
+		{
+			largeAllocations--;
+			::operator delete(ptr);
+			return;
+		}
+
+		const size_t sizeClass = GetSizeClass(size);
+		ThreadCache& cache = GetThreadCache();
+
+		FreeBlock* block = static_cast<FreeBlock*>(ptr);
+		block->next = cache.freeLists[sizeClass];
+		cache.freeLists[sizeClass] = block;
+		cache.counts[sizeClass]++;
+
+		sizeClasses[sizeClass].liveBlocks.fetch_sub(1, std::memory_order_relaxed);
+
+		//Objects are often freed on a different thread than they were created on, so caches that only free give blocks back.
+		if (cache.counts[sizeClass] > 2 * kBatchSize)
+			Release(cache, sizeClass, kBatchSize);
+	}
+
+	SlabAllocator::Stats SlabAllocator::GetStats()const
+	{
+		Stats stats{};
+		for (const SizeClass& sc : sizeClasses)
+		{
+			std::unique_lock<std::mutex> lock(sc.mutex);
+			stats.slabCount += sc.slabs.size();
+			stats.liveBlocks += sc.liveBlocks.load(std::memory_order_relaxed);
+		}
+		stats.largeAllocations = largeAllocations.load();
+		return stats;
+	}
+
+	SlabAllocator& SlabAllocator::GetSlabAllocator()
+	{
+		static SlabAllocator slabAllocator;
+		return slabAllocator;
+	}
+
+}
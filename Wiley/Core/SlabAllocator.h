@@ -0,0 +1,116 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Wiley {
+
+	/// <summary>
+	///		Pool for small engine objects. Requests are rounded up to a power of two size class between kMinBlockSize and kMaxBlockSize
+	///		and carved out of kSlabSize slabs, so objects of similar size sit next to each other in memory.
+	///		Free blocks are linked through their own storage. Every thread keeps a small cache per size class and only
+	///		takes the class lock to move a batch of blocks in or out of it. Larger requests go straight to the heap.
+	///		Slabs are never returned to the system.
+	/// </summary>
+	class SlabAllocator
+	{
+	public:
+		static constexpr size_t kMinBlockSize = 16;
+		static constexpr size_t kMaxBlockSize = 4096;
+		static constexpr size_t kSizeClassCount = 9;
+		static constexpr size_t kSlabSize = 64 * 1024;
+		static constexpr size_t kBatchSize = 32;
+
+		struct Stats
+		{
+			size_t slabCount = 0;
+			size_t liveBlocks = 0;
+			size_t largeAllocations = 0;
+		};
+
+		~SlabAllocator();
+
+		void* Allocate(size_t size);
+		void Free(void* ptr, size_t size);
+
+		Stats GetStats()const;
+
+		static SlabAllocator& GetSlabAllocator();
+
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* next;
+		};
+
+		struct SizeClass
+		{
+			mutable std::mutex mutex;
+			FreeBlock* freeList = nullptr;
+			std::vector<void*> slabs;
+			std::atomic<size_t> liveBlocks{ 0 };
+		};
+
+		struct ThreadCache
+		{
+			FreeBlock* freeLists[kSizeClassCount] = {};
+			size_t counts[kSizeClassCount] = {};
+
+			~ThreadCache();
+		};
+
+		static size_t GetSizeClass(size_t size);
+		static size_t GetBlockSize(size_t sizeClass) { return kMinBlockSize << sizeClass; }
+		static ThreadCache& GetThreadCache();
+
+		void Refill(ThreadCache& cache, size_t sizeClass);
+		void Release(ThreadCache& cache, size_t sizeClass, size_t count);
+
+	private:
+		SizeClass sizeClasses[kSizeClassCount];
+		std::atomic<size_t> largeAllocations{ 0 };
+	};
+
+#define gSlabAllocator SlabAllocator::GetSlabAllocator()
+
+	/// <summary>
+	///		STL allocator over the SlabAllocator. Used with std::allocate_shared so the object and its control block share one pooled block.
+	/// </summary>
+	template<typename T>
+	class SlabStlAllocator
+	{
+	public:
+		using value_type = T;
+
+		SlabStlAllocator() noexcept = default;
+
+		template<typename U>
+		SlabStlAllocator(const SlabStlAllocator<U>&) noexcept
+		{
+		}
+
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(gSlabAllocator.Allocate(n * sizeof(T)));
+		}
+
+		void deallocate(T* ptr, size_t n) noexcept
+		{
+			gSlabAllocator.Free(ptr, n * sizeof(T));
+		}
+
+		template<typename U>
+		bool operator==(const SlabStlAllocator<U>&)const noexcept { return true; }
+	};
+
+	template<typename T, typename...Args>
+	std::shared_ptr<T> MakePooled(Args&&... args)
+	{
+		return std::allocate_shared<T>(SlabStlAllocator<T>{}, std::forward<Args>(args)...);
+	}
+
+}
@@ -0,0 +1,78 @@
+#include "StringId.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <iostream>
+#include <charconv>
+
+namespace Wiley {
+
+#if WILEY_STRING_ID_REVERSE_LOOKUP
+	namespace {
+
+		struct InternTable
+		{
+			std::shared_mutex mutex;
+			//Node-based so views handed out by GetString stay valid as the table grows.
+			std::unordered_map<uint64_t, std::string> strings;
+		};
+
+		InternTable& GetInternTable()
+		{
+			static InternTable table;
+			return table;
+		}
+
+		void Intern(uint64_t hash, std::string_view string)
+		{
+			InternTable& table = GetInternTable();
+			{
+				std::shared_lock<std::shared_mutex> lock(table.mutex);
+				auto it = table.strings.find(hash);
+				if (it != table.strings.end())
+				{
+					if (it->second != string)
+						std::cout << "StringId collision between \"" << it->second << "\" and \"" << string << "\"." << std::endl;
+					return;
+				}
+			}
+
+			std::unique_lock<std::shared_mutex> lock(table.mutex);
+			table.strings.try_emplace(hash, string);
+		}
+	}
+#endif
+
+	StringId::StringId(std::string_view string)
+		:hash(Fnv1a64(string))
+	{
+#if WILEY_STRING_ID_REVERSE_LOOKUP
+		Intern(hash, string);
+#endif
+	}
+
+	std::string_view StringId::GetString()const
+	{
+#if WILEY_STRING_ID_REVERSE_LOOKUP
+		InternTable& table = GetInternTable();
+		std::shared_lock<std::shared_mutex> lock(table.mutex);
+		auto it = table.strings.find(hash);
+		if (it != table.strings.end())
+			return it->second;
+#endif
+		return {};
+	}
+
+	std::string StringId::ToString()const
+	{
+		const std::string_view string = GetString();
+		if (!string.empty())
+			return std::string(string);
+
+		char digits[17];
+		const auto result = std::to_chars(digits, digits + sizeof(digits), hash, 16);
+		return "#" + std::string(digits, result.ptr);
+	}
+
+}
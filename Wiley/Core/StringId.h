@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <functional>
+
+//Keeps every runtime-hashed string so ids can be turned back into names and collisions are caught. On by default in debug builds.
+#ifndef WILEY_STRING_ID_REVERSE_LOOKUP
+#ifdef _DEBUG
+#define WILEY_STRING_ID_REVERSE_LOOKUP 1
+#else
+#define WILEY_STRING_ID_REVERSE_LOOKUP 0
+#endif
+#endif
+
+namespace Wiley {
+
+	constexpr uint64_t kFnv1aOffsetBasis = 0xCBF29CE484222325ULL;
+	constexpr uint64_t kFnv1aPrime = 0x100000001B3ULL;
+
+	constexpr uint64_t Fnv1a64(std::string_view string)
+	{
+		uint64_t hash = kFnv1aOffsetBasis;
+		for (const char c : string)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= kFnv1aPrime;
+		}
+		return hash;
+	}
+
+	/// <summary>
+	///		64-bit FNV-1a hash of a name, compared and hashed as a plain integer.
+	///		String literals are hashed at compile time. Other strings must be converted explicitly, which hashes them at runtime
+	///		and, with WILEY_STRING_ID_REVERSE_LOOKUP, records them in the global intern table.
+	/// </summary>
+	class StringId
+	{
+	public:
+		constexpr StringId() = default;
+
+		template<size_t N>
+		consteval StringId(const char(&literal)[N])
+			:hash(Fnv1a64(std::string_view(literal, N - 1)))
+		{
+		}
+
+		explicit StringId(std::string_view string);
+
+		static constexpr StringId FromHash(uint64_t hash)
+		{
+			StringId id;
+			id.hash = hash;
+			return id;
+		}
+
+		constexpr uint64_t GetHash()const { return hash; }
+		constexpr bool IsValid()const { return hash != 0; }
+
+		/// <summary>
+		///		The interned string, or an empty view if it was never hashed at runtime or reverse lookup is compiled out.
+		/// </summary>
+		std::string_view GetString()const;
+
+		/// <summary>
+		///		The interned string if there is one, otherwise the hash in hex. Meant for log messages.
+		/// </summary>
+		std::string ToString()const;
+
+		constexpr bool operator==(const StringId& other)const = default;
+		constexpr auto operator<=>(const StringId& other)const = default;
+
+	private:
+		uint64_t hash = 0;
+	};
+
+	namespace StringIdLiterals {
+		consteval StringId operator""_sid(const char* string, size_t length)
+		{
+			return StringId::FromHash(Fnv1a64(std::string_view(string, length)));
+		}
+	}
+}
+
+namespace std {
+	template<>
+	struct hash<Wiley::StringId> {
+		size_t operator()(const Wiley::StringId& id) const noexcept {
+			return static_cast<size_t>(id.GetHash());
+		}
+	};
+}
@@ -0,0 +1,333 @@
+#include "TLSFAllocator.h"
+
+#include <bit>
+#include <algorithm>
+
+namespace Wiley
+{
+	TLSFAllocator::TLSFAllocator(uint32_t capacity)
+	{
+		Reset(capacity);
+	}
+
+	void TLSFAllocator::Reset(uint32_t capacity)
+	{
+		nodes.clear();
+		unusedNodes.clear();
+		allocationCount = 0;
+
+		firstLevelBitmap = 0;
+		std::fill(std::begin(secondLevelBitmaps), std::end(secondLevelBitmaps), 0u);
+		for (auto& heads : freeHeads)
+			std::fill(std::begin(heads), std::end(heads), kInvalidNode);
+
+		this->capacity = capacity;
+		used = 0;
+		lastNode = kInvalidNode;
+
+		if (capacity > 0)
+		{
+			lastNode = CreateNode(0, capacity);
+			InsertFree(lastNode);
+		}
+	}
+
+	TLSFAllocator::BinIndex TLSFAllocator::GetBinRoundDown(uint32_t size)
+	{
+		if (size < kSecondLevelCount)
+			return { 0, size };
+
+		const uint32_t topBit = std::bit_width(size) - 1;
+		return {
+			topBit - kSecondLevelBits + 1,
+			(size >> (topBit - kSecondLevelBits)) & (kSecondLevelCount - 1)
+		};
+	}
+
+	/// <summary>
+	///		Rounds size up to the next bin boundary so any block in the returned bin is large enough.
+	///		Returns a first level of kFirstLevelCount when the rounded size does not fit any bin.
+	/// </summary>
+	TLSFAllocator::BinIndex TLSFAllocator::GetBinRoundUp(uint32_t size)
+	{
+		if (size < kSecondLevelCount)
+			return { 0, size };
+
+		const uint32_t topBit = std::bit_width(size) - 1;
+		const uint64_t rounded = static_cast<uint64_t>(size) + (1ull << (topBit - kSecondLevelBits)) - 1;
+		if (rounded > UINT32_MAX)
+			return { kFirstLevelCount, 0 };
+
+		return GetBinRoundDown(static_cast<uint32_t>(rounded));
+	}
+
+	uint32_t TLSFAllocator::CreateNode(uint32_t offset, uint32_t size)
+	{
+		uint32_t index;
+		if (!unusedNodes.empty())
+		{
+			index = unusedNodes.back();
+			unusedNodes.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(nodes.size());
+			nodes.emplace_back();
+		}
+
+		nodes[index] = Node{ .offset = offset, .size = size };
+		return index;
+	}
+
+	void TLSFAllocator::ReleaseNode(uint32_t node)
+	{
+		//Stale metadata may still point here, so the node must not look like a live allocation.
+		nodes[node].used = false;
+		unusedNodes.push_back(node);
+	}
+
+	void TLSFAllocator::InsertFree(uint32_t node)
+	{
+		Node& n = nodes[node];
+		const BinIndex bin = GetBinRoundDown(n.size);
+
+		uint32_t& head = freeHeads[bin.firstLevel][bin.secondLevel];
+		n.used = false;
+		n.prevFree = kInvalidNode;
+		n.nextFree = head;
+		if (head != kInvalidNode)
+			nodes[head].prevFree = node;
+		head = node;
+
+		firstLevelBitmap |= 1u << bin.firstLevel;
+		secondLevelBitmaps[bin.firstLevel] |= 1u << bin.secondLevel;
+	}
+
+	void TLSFAllocator::RemoveFree(uint32_t node)
+	{
+		Node& n = nodes[node];
+		const BinIndex bin = GetBinRoundDown(n.size);
+
+		if (n.prevFree != kInvalidNode)
+			nodes[n.prevFree].nextFree = n.nextFree;
+		else
+			freeHeads[bin.firstLevel][bin.secondLevel] = n.nextFree;
+
+		if (n.nextFree != kInvalidNode)
+			nodes[n.nextFree].prevFree = n.prevFree;
+
+		n.prevFree = kInvalidNode;
+		n.nextFree = kInvalidNode;
+
+		if (freeHeads[bin.firstLevel][bin.secondLevel] == kInvalidNode)
+		{
+			secondLevelBitmaps[bin.firstLevel] &= ~(1u << bin.secondLevel);
+			if (secondLevelBitmaps[bin.firstLevel] == 0)
+				firstLevelBitmap &= ~(1u << bin.firstLevel);
+		}
+	}
+
+	uint32_t TLSFAllocator::FindFree(uint32_t size)const
+	{
+		const BinIndex bin = GetBinRoundUp(size);
+		if (bin.firstLevel < kFirstLevelCount)
+		{
+			uint32_t firstLevel = bin.firstLevel;
+			uint32_t secondLevelMap = secondLevelBitmaps[firstLevel] & (~0u << bin.secondLevel);
+
+			if (secondLevelMap == 0)
+			{
+				const uint32_t firstLevelMap = (firstLevel + 1 < 32) ? firstLevelBitmap & (~0u << (firstLevel + 1)) : 0;
+				if (firstLevelMap != 0)
+				{
+					firstLevel = std::countr_zero(firstLevelMap);
+					secondLevelMap = secondLevelBitmaps[firstLevel];
+				}
+			}
+
+			if (secondLevelMap != 0)
+				return freeHeads[firstLevel][std::countr_zero(secondLevelMap)];
+		}
+
+		//Rounding up skips blocks in the requested size's own bin that may still be large enough.
+		//Only reached when the allocator is nearly full.
+		const BinIndex exact = GetBinRoundDown(size);
+		for (uint32_t node = freeHeads[exact.firstLevel][exact.secondLevel]; node != kInvalidNode; node = nodes[node].nextFree)
+			if (nodes[node].size >= size)
+				return node;
+
+		return kInvalidNode;
+	}
+
+	bool TLSFAllocator::IsLive(const Allocation& allocation)const
+	{
+		return allocation.metadata < nodes.size() && nodes[allocation.metadata].used && nodes[allocation.metadata].offset == allocation.offset;
+	}
+
+	TLSFAllocator::Allocation TLSFAllocator::Allocate(uint32_t size)
+	{
+		size = std::max(size, 1u);
+
+		const uint32_t node = FindFree(size);
+		if (node == kInvalidNode)
+			return {};
+
+		RemoveFree(node);
+
+		if (nodes[node].size > size)
+		{
+			const uint32_t remainder = CreateNode(nodes[node].offset + size, nodes[node].size - size);
+
+			Node& n = nodes[node];
+			Node& r = nodes[remainder];
+			n.size = size;
+
+			r.prevPhysical = node;
+			r.nextPhysical = n.nextPhysical;
+			if (n.nextPhysical != kInvalidNode)
+				nodes[n.nextPhysical].prevPhysical = remainder;
+			else
+				lastNode = remainder;
+			n.nextPhysical = remainder;
+
+			InsertFree(remainder);
+		}
+
+		Node& n = nodes[node];
+		n.used = true;
+		used += n.size;
+		allocationCount++;
+		return { n.offset, node };
+	}
+
+	bool TLSFAllocator::Free(const Allocation& allocation)
+	{
+		if (!IsLive(allocation))
+			return false;
+
+		uint32_t node = allocation.metadata;
+		allocationCount--;
+		used -= nodes[node].size;
+
+		const uint32_t prev = nodes[node].prevPhysical;
+		if (prev != kInvalidNode && !nodes[prev].used)
+		{
+			RemoveFree(prev);
+			nodes[prev].size += nodes[node].size;
+			nodes[prev].nextPhysical = nodes[node].nextPhysical;
+			if (nodes[node].nextPhysical != kInvalidNode)
+				nodes[nodes[node].nextPhysical].prevPhysical = prev;
+			else
+				lastNode = prev;
+
+			ReleaseNode(node);
+			node = prev;
+		}
+
+		const uint32_t next = nodes[node].nextPhysical;
+		if (next != kInvalidNode && !nodes[next].used)
+		{
+			RemoveFree(next);
+			nodes[node].size += nodes[next].size;
+			nodes[node].nextPhysical = nodes[next].nextPhysical;
+			if (nodes[next].nextPhysical != kInvalidNode)
+				nodes[nodes[next].nextPhysical].prevPhysical = node;
+			else
+				lastNode = node;
+
+			ReleaseNode(next);
+		}
+
+		InsertFree(node);
+		return true;
+	}
+
+	void TLSFAllocator::Grow(uint32_t newCapacity)
+	{
+		if (newCapacity <= capacity)
+			return;
+
+		const uint32_t extension = newCapacity - capacity;
+
+		if (lastNode != kInvalidNode && !nodes[lastNode].used)
+		{
+			RemoveFree(lastNode);
+			nodes[lastNode].size += extension;
+			InsertFree(lastNode);
+		}
+		else
+		{
+			const uint32_t node = CreateNode(capacity, extension);
+			nodes[node].prevPhysical = lastNode;
+			if (lastNode != kInvalidNode)
+				nodes[lastNode].nextPhysical = node;
+			lastNode = node;
+			InsertFree(node);
+		}
+
+		capacity = newCapacity;
+	}
+
+	bool TLSFAllocator::Shrink(uint32_t newCapacity)
+	{
+		if (newCapacity >= capacity)
+			return true;
+
+		if (GetReach() > newCapacity)
+			return false;
+
+		//The tail is free and starts at or before newCapacity.
+		RemoveFree(lastNode);
+		Node& tail = nodes[lastNode];
+		tail.size = newCapacity - tail.offset;
+
+		if (tail.size > 0)
+		{
+			InsertFree(lastNode);
+		}
+		else
+		{
+			const uint32_t prev = tail.prevPhysical;
+			ReleaseNode(lastNode);
+			if (prev != kInvalidNode)
+				nodes[prev].nextPhysical = kInvalidNode;
+			lastNode = prev;
+		}
+
+		capacity = newCapacity;
+		return true;
+	}
+
+	uint32_t TLSFAllocator::GetAllocationSize(const Allocation& allocation)const
+	{
+		return IsLive(allocation) ? nodes[allocation.metadata].size : 0;
+	}
+
+	uint32_t TLSFAllocator::GetReach()const
+	{
+		if (lastNode != kInvalidNode && !nodes[lastNode].used)
+			return nodes[lastNode].offset;
+		return capacity;
+	}
+
+	TLSFAllocator::Stats TLSFAllocator::GetStats()const
+	{
+		Stats stats{};
+		stats.capacity = capacity;
+		stats.used = used;
+		stats.reach = GetReach();
+		stats.allocationCount = allocationCount;
+
+		for (uint32_t node = lastNode; node != kInvalidNode; node = nodes[node].prevPhysical)
+		{
+			if (nodes[node].used)
+				continue;
+
+			stats.freeBlockCount++;
+			stats.largestFreeBlock = std::max(stats.largestFreeBlock, nodes[node].size);
+		}
+
+		return stats;
+	}
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Wiley {
+
+	/// <summary>
+	///		Two-level segregated-fit allocator for offset ranges. It never touches memory itself,
+	///		so the same allocator can manage a malloc'd pool or the mapped range of an RHI::UploadBuffer.
+	///		Free blocks are binned by the top bit of their size (first level) and the next kSecondLevelBits bits (second level).
+	///		Allocate and Free are O(1): a bin is found with two bitmap scans and freed blocks merge with their physical neighbours.
+	///		Units are whatever the caller uses, elements for LinearAllocator.
+	///		Allocate returns the block's node index as metadata and Free takes it back, so no offset lookup is kept.
+	/// </summary>
+	class TLSFAllocator
+	{
+	public:
+		static constexpr uint32_t kInvalidOffset = UINT32_MAX;
+
+		static constexpr uint32_t kSecondLevelBits = 4;
+		static constexpr uint32_t kSecondLevelCount = 1u << kSecondLevelBits;
+		static constexpr uint32_t kFirstLevelCount = 32 - kSecondLevelBits + 1;
+
+		struct Allocation
+		{
+			uint32_t offset = kInvalidOffset;
+			uint32_t metadata = UINT32_MAX;
+
+			bool IsValid()const { return offset != kInvalidOffset; }
+		};
+
+		struct Stats
+		{
+			uint32_t capacity = 0;
+			uint32_t used = 0;
+			uint32_t reach = 0;
+			uint32_t allocationCount = 0;
+			uint32_t freeBlockCount = 0;
+			uint32_t largestFreeBlock = 0;
+
+			/// <summary>
+			///		0 when all free space is one block, approaching 1 as it is split into many small ones.
+			/// </summary>
+			float GetFragmentation()const
+			{
+				const uint32_t freeSpace = capacity - used;
+				return (freeSpace > 0) ? 1.0f - static_cast<float>(largestFreeBlock) / static_cast<float>(freeSpace) : 0.0f;
+			}
+		};
+
+		explicit TLSFAllocator(uint32_t capacity = 0);
+
+		/// <summary>
+		///		Drops every allocation and starts over with one free block of the given capacity.
+		/// </summary>
+		void Reset(uint32_t capacity);
+
+		/// <summary>
+		///		Returns a range of the given size, or an invalid allocation when no free block is large enough.
+		/// </summary>
+		Allocation Allocate(uint32_t size);
+
+		/// <summary>
+		///		Frees an allocation returned by Allocate. Returns false when it is not live.
+		/// </summary>
+		bool Free(const Allocation& allocation);
+
+		/// <summary>
+		///		Extends the managed range to newCapacity. Existing offsets stay valid.
+		/// </summary>
+		void Grow(uint32_t newCapacity);
+
+		/// <summary>
+		///		Gives up the free space past newCapacity. Fails when a live allocation ends past it.
+		/// </summary>
+		bool Shrink(uint32_t newCapacity);
+
+		/// <summary>
+		///		Size of the allocation or 0 if it is not live.
+		/// </summary>
+		uint32_t GetAllocationSize(const Allocation& allocation)const;
+
+		uint32_t GetCapacity()const { return capacity; }
+		uint32_t GetUsed()const { return used; }
+		uint32_t GetAllocationCount()const { return allocationCount; }
+
+		/// <summary>
+		///		End of the highest live allocation. Everything after it is free.
+		/// </summary>
+		uint32_t GetReach()const;
+
+		/// <summary>
+		///		Walks every block, so it is meant for debugging and benchmarks rather than per-frame use.
+		/// </summary>
+		Stats GetStats()const;
+
+	private:
+		static constexpr uint32_t kInvalidNode = UINT32_MAX;
+
+		struct Node
+		{
+			uint32_t offset = 0;
+			uint32_t size = 0;
+			uint32_t prevPhysical = kInvalidNode;
+			uint32_t nextPhysical = kInvalidNode;
+			uint32_t prevFree = kInvalidNode;
+			uint32_t nextFree = kInvalidNode;
+			bool used = false;
+		};
+
+		struct BinIndex
+		{
+			uint32_t firstLevel;
+			uint32_t secondLevel;
+		};
+
+		static BinIndex GetBinRoundDown(uint32_t size);
+		static BinIndex GetBinRoundUp(uint32_t size);
+
+		uint32_t CreateNode(uint32_t offset, uint32_t size);
+		void ReleaseNode(uint32_t node);
+
+		void InsertFree(uint32_t node);
+		void RemoveFree(uint32_t node);
+		uint32_t FindFree(uint32_t size)const;
+		bool IsLive(const Allocation& allocation)const;
+
+	private:
+		std::vector<Node> nodes;
+		std::vector<uint32_t> unusedNodes;
+		uint32_t allocationCount = 0;
+
+		uint32_t firstLevelBitmap = 0;
+		uint32_t secondLevelBitmaps[kFirstLevelCount] = {};
+		uint32_t freeHeads[kFirstLevelCount][kSecondLevelCount];
+
+		uint32_t lastNode = kInvalidNode;
+		uint32_t capacity = 0;
+		uint32_t used = 0;
+	};
+
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+namespace Wiley {
+
+	/// <summary>
+	///		Move-only void() callable with inline capture storage.
+	///		Callables up to kInlineSize bytes are constructed in place. Anything larger falls back to a single heap allocation.
+	///		Used for thread pool tasks so submitting a lambda does not allocate.
+	/// </summary>
+	class TaskFunction
+	{
+	public:
+		static constexpr size_t kInlineSize = 64;
+
+		TaskFunction() = default;
+
+		template<typename F>
+			requires (!std::is_same_v<std::decay_t<F>, TaskFunction>) && std::is_invocable_v<std::decay_t<F>&>
+		TaskFunction(F&& f)
+		{
+			using Callable = std::decay_t<F>;
+
+			if constexpr (IsInline<Callable>()) {
+				::new (static_cast<void*>(storage)) Callable(std::forward<F>(f));
+				vtable = &InlineVTable<Callable>;
+			}
+			else {
+				::new (static_cast<void*>(storage)) Callable*(new Callable(std::forward<F>(f)));
+				vtable = &HeapVTable<Callable>;
+			}
+		}
+
+		TaskFunction(TaskFunction&& other) noexcept
+		{
+			MoveFrom(other);
+		}
+
+		TaskFunction& operator=(TaskFunction&& other) noexcept
+		{
+			if (this != &other) {
+				Reset();
+				MoveFrom(other);
+			}
+			return *this;
+		}
+
+		TaskFunction(const TaskFunction&) = delete;
+		TaskFunction& operator=(const TaskFunction&) = delete;
+
+		~TaskFunction() { Reset(); }
+
+		void operator()() { vtable->invoke(storage); }
+
+		explicit operator bool()const { return vtable != nullptr; }
+
+		void Reset()
+		{
+			if (vtable) {
+				vtable->destroy(storage);
+				vtable = nullptr;
+			}
+		}
+
+		/// <summary>
+		///		True when a callable of type F is stored inline.
+		/// </summary>
+		template<typename F>
+		static constexpr bool IsInline()
+		{
+			return sizeof(F) <= kInlineSize && alignof(F) <= alignof(std::max_align_t) &&
+				std::is_nothrow_move_constructible_v<F>;
+		}
+
+	private:
+		struct VTable
+		{
+			void (*invoke)(void* storage);
+			//Move constructs into dst and destroys src.
+			void (*relocate)(void* dst, void* src);
+			void (*destroy)(void* storage);
+		};
+
+		template<typename F>
+		static constexpr VTable InlineVTable = {
+			[](void* storage) { (*static_cast<F*>(storage))(); },
+			[](void* dst, void* src) {
+				::new (dst) F(std::move(*static_cast<F*>(src)));
+				static_cast<F*>(src)->~F();
+			},
+			[](void* storage) { static_cast<F*>(storage)->~F(); }
+		};
+
+		template<typename F>
+		static constexpr VTable HeapVTable = {
+			[](void* storage) { (**static_cast<F**>(storage))(); },
+			[](void* dst, void* src) { *static_cast<F**>(dst) = *static_cast<F**>(src); },
+			[](void* storage) { delete *static_cast<F**>(storage); }
+		};
+
+		void MoveFrom(TaskFunction& other)
+		{
+			vtable = other.vtable;
+			if (vtable) {
+				vtable->relocate(storage, other.storage);
+				other.vtable = nullptr;
+			}
+		}
+
+	private:
+		alignas(std::max_align_t) unsigned char storage[kInlineSize];
+		const VTable* vtable = nullptr;
+	};
+
+}
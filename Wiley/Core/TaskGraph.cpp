@@ -0,0 +1,170 @@
+#include "TaskGraph.h"
+
+#include <queue>
+
+namespace Wiley
+{
+	struct TaskGraph::RunState
+	{
+		std::shared_ptr<const std::vector<Node>> nodes;
+		std::unique_ptr<std::atomic<uint32_t>[]> remainingDependencies;
+		std::atomic<uint32_t> remainingNodes{ 0 };
+		ThreadPool* pool = nullptr;
+	};
+
+	TaskGraph::TaskGraph()
+		:nodes(std::make_shared<std::vector<Node>>())
+	{
+	}
+
+	TaskGraph::NodeID TaskGraph::AddNode(Job job, const std::string& name, ThreadPool::TaskPriority priority)
+	{
+		validated = false;
+		Node& node = nodes->emplace_back();
+		node.job = std::move(job);
+		node.name = name;
+		node.priority = priority;
+		return static_cast<NodeID>(nodes->size() - 1);
+	}
+
+	void TaskGraph::AddEdge(NodeID before, NodeID after)
+	{
+		if (before >= nodes->size() || after >= nodes->size() || before == after) {
+			std::cout << "Invalid task graph edge." << std::endl;
+			return;
+		}
+
+		validated = false;
+		(*nodes)[before].successors.push_back(after);
+		(*nodes)[after].dependencyCount++;
+	}
+
+	void TaskGraph::AddEdges(const std::vector<NodeID>& before, NodeID after)
+	{
+		for (NodeID id : before)
+			AddEdge(id, after);
+	}
+
+	void TaskGraph::AddEdges(NodeID before, const std::vector<NodeID>& after)
+	{
+		for (NodeID id : after)
+			AddEdge(before, id);
+	}
+
+	void TaskGraph::Clear()
+	{
+		//A running launch keeps the old node list alive through its own reference.
+		nodes = std::make_shared<std::vector<Node>>();
+		validated = false;
+	}
+
+	bool TaskGraph::Validate()const
+	{
+		//Kahn's algorithm. Every node must be reachable from a root or there is a cycle.
+		std::vector<uint32_t> inDegree(nodes->size());
+		std::queue<NodeID> ready;
+		for (NodeID i = 0; i < nodes->size(); i++) {
+			inDegree[i] = (*nodes)[i].dependencyCount;
+			if (inDegree[i] == 0)
+				ready.push(i);
+		}
+
+		size_t visited = 0;
+		while (!ready.empty()) {
+			NodeID id = ready.front();
+			ready.pop();
+			visited++;
+			for (NodeID next : (*nodes)[id].successors)
+				if (--inDegree[next] == 0)
+					ready.push(next);
+		}
+
+		return visited == nodes->size();
+	}
+
+	TaskGraphHandle TaskGraph::Launch(ThreadPool& pool)
+	{
+		if (nodes->empty())
+			return {};
+
+		if (!validated) {
+			if (!Validate()) {
+				std::cout << "Task graph contains a cycle. It will not be launched." << std::endl;
+				return {};
+			}
+			validated = true;
+		}
+
+		const size_t count = nodes->size();
+
+		auto state = std::make_shared<RunState>();
+		state->nodes = nodes;
+		state->pool = &pool;
+		state->remainingNodes = static_cast<uint32_t>(count);
+		state->remainingDependencies = std::make_unique<std::atomic<uint32_t>[]>(count);
+		for (size_t i = 0; i < count; i++)
+			state->remainingDependencies[i].store((*nodes)[i].dependencyCount, std::memory_order_relaxed);
+
+		//Counters must be fully set up before the first root can complete and touch them.
+		for (NodeID i = 0; i < count; i++) {
+			const Node& node = (*nodes)[i];
+			if (node.dependencyCount == 0)
+				pool.Submit([state, i]() { RunNode(state, i); }, node.priority);
+		}
+
+		return TaskGraphHandle(std::move(state));
+	}
+
+	void TaskGraph::Run(ThreadPool& pool)
+	{
+		Launch(pool).Wait();
+	}
+
+	/// <summary>
+	///		Runs a node and releases its successors.
+	///		The first successor that becomes ready is continued inline on this worker, the rest are submitted to the pool.
+	/// </summary>
+	void TaskGraph::RunNode(const std::shared_ptr<RunState>& state, NodeID id)
+	{
+		const std::vector<Node>& graphNodes = *state->nodes;
+
+		while (true)
+		{
+			const Node& node = graphNodes[id];
+			if (node.job)
+				node.job();
+
+			NodeID continuation = UINT32_MAX;
+			for (NodeID next : node.successors)
+			{
+				if (state->remainingDependencies[next].fetch_sub(1, std::memory_order_acq_rel) != 1)
+					continue;
+
+				if (continuation == UINT32_MAX)
+					continuation = next;
+				else
+					state->pool->Submit([state, next]() { RunNode(state, next); }, graphNodes[next].priority);
+			}
+
+			//Release ordering makes every job's side effects visible to whoever observes the launch as done.
+			state->remainingNodes.fetch_sub(1, std::memory_order_acq_rel);
+
+			if (continuation == UINT32_MAX)
+				return;
+			id = continuation;
+		}
+	}
+
+	bool TaskGraphHandle::IsDone()const
+	{
+		return !state || state->remainingNodes.load(std::memory_order_acquire) == 0;
+	}
+
+	void TaskGraphHandle::Wait()const
+	{
+		if (!state)
+			return;
+
+		state->pool->HelpUntil([this]() { return IsDone(); });
+	}
+}
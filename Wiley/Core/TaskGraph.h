@@ -0,0 +1,111 @@
+#pragma once
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace Wiley {
+
+	class TaskGraphHandle;
+
+	/// <summary>
+	///		Builder for a set of jobs with explicit dependencies.
+	///		Nodes become ready once every node they depend on has finished and are then run on whichever worker finished the last dependency.
+	///		A graph can be launched any number of times but must not be edited while a launch is still running.
+	/// </summary>
+	class TaskGraph
+	{
+	public:
+		using NodeID = uint32_t;
+		using Job = std::function<void()>;
+
+		TaskGraph();
+
+		NodeID AddNode(Job job, const std::string& name = "", ThreadPool::TaskPriority priority = ThreadPool::TaskPriority::Normal);
+
+		/// <summary>
+		///		Declares that "after" may only start once "before" has finished.
+		/// </summary>
+		void AddEdge(NodeID before, NodeID after);
+
+		/// <summary>
+		///		Makes every node in "before" a dependency of "after" (fan-in).
+		/// </summary>
+		void AddEdges(const std::vector<NodeID>& before, NodeID after);
+
+		/// <summary>
+		///		Makes "before" a dependency of every node in "after" (fan-out).
+		/// </summary>
+		void AddEdges(NodeID before, const std::vector<NodeID>& after);
+
+		void Clear();
+
+		size_t GetNodeCount()const { return nodes->size(); }
+		const std::string& GetNodeName(NodeID id)const { return (*nodes)[id].name; }
+
+		/// <summary>
+		///		Submits every root node to the pool and returns immediately.
+		///		Returns an empty handle if the graph contains a cycle.
+		/// </summary>
+		TaskGraphHandle Launch(ThreadPool& pool = gThreadPool);
+
+		/// <summary>
+		///		Launch() followed by Wait() on the returned handle.
+		/// </summary>
+		void Run(ThreadPool& pool = gThreadPool);
+
+	private:
+		struct Node
+		{
+			Job job;
+			std::string name;
+			ThreadPool::TaskPriority priority = ThreadPool::TaskPriority::Normal;
+
+			std::vector<NodeID> successors;
+			uint32_t dependencyCount = 0;
+		};
+
+		struct RunState;
+
+		bool Validate()const;
+		static void RunNode(const std::shared_ptr<RunState>& state, NodeID id);
+
+		friend class TaskGraphHandle;
+
+	private:
+		std::shared_ptr<std::vector<Node>> nodes;
+		bool validated = false;
+	};
+
+	/// <summary>
+	///		Handle to one launch of a TaskGraph. Cheap to copy.
+	///		An empty handle (default constructed or a failed launch) is always done.
+	/// </summary>
+	class TaskGraphHandle
+	{
+	public:
+		TaskGraphHandle() = default;
+
+		bool IsDone()const;
+
+		/// <summary>
+		///		Helps the thread pool until every node of this launch has run.
+		/// </summary>
+		void Wait()const;
+
+	private:
+		friend class TaskGraph;
+
+		explicit TaskGraphHandle(std::shared_ptr<TaskGraph::RunState> state)
+			:state(std::move(state))
+		{
+		}
+
+		std::shared_ptr<TaskGraph::RunState> state;
+	};
+
+}
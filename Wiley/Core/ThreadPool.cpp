@@ -1,68 +1,359 @@
 #include "ThreadPool.h"
+#include "TracyWrapper.h"
+
+#include <algorithm>
+#include <bit>
 
 namespace Wiley
 {
 	ThreadPool threadPool;
 
+	using SteadyClock = std::chrono::steady_clock;
+
+	static uint64_t ElapsedNs(SteadyClock::time_point start, SteadyClock::time_point end)
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+
+	static size_t GetPriorityClass(int priority)
+	{
+		return static_cast<size_t>(std::clamp(priority / 10, 0, static_cast<int>(ThreadPoolStats::kPriorityClassCount) - 1));
+	}
+
+	static size_t GetWaitBucket(uint64_t waitNs)
+	{
+		const uint64_t waitUs = waitNs / 1000;
+		return std::min(static_cast<size_t>(std::bit_width(waitUs)), ThreadPoolStats::kWaitBucketCount - 1);
+	}
+
 	ThreadPool::ThreadPool()
 	{
 	}
 
 	ThreadPool::~ThreadPool() {
+		Shutdown();
+
+		for (Task* task : sharedFreeTasks)
+			delete task;
+		sharedFreeTasks.clear();
+	}
+
+	void ThreadPool::Initialize()
+	{
+		nThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+
+		workers.reserve(nThreads);
+		for (int i = 0; i < nThreads; i++)
+			workers.emplace_back(std::make_unique<Worker>());
+
+		//Start threads only after every worker exists so stealing never sees a half built vector.
+		for (int i = 0; i < nThreads; i++)
+			workers[i]->thread = std::thread([this, i] { WorkerLoop(i); });
+	}
+
+	void ThreadPool::Shutdown()
+	{
+		if (workers.empty())
+			return;
+
 		{
-			std::unique_lock<std::mutex> lock(mutex);
+			std::unique_lock<std::mutex> lock(sleepMutex);
 			stop = true;
 		}
 
-		condition.notify_all();
+		sleepCondition.notify_all();
 
 		for (auto& worker : workers)
-			worker.join();
+			if (worker->thread.joinable())
+				worker->thread.join();
+
+		{
+			std::unique_lock<std::mutex> lock(freeTasksMutex);
+			for (auto& worker : workers)
+				sharedFreeTasks.insert(sharedFreeTasks.end(), worker->freeTasks.begin(), worker->freeTasks.end());
+		}
+
+		workers.clear();
 	}
 
-	void ThreadPool::Initialize()
+	void ThreadPool::WorkerLoop(int index)
 	{
-		nThreads = std::thread::hardware_concurrency() - 1;
-		for (int i = 0; i < nThreads; i++)
+		workerIndex = index;
+
+		const std::string threadName = "Worker " + std::to_string(index);
+		TraceThreadName(threadName.c_str());
+
+		constexpr int kSpinCount = 64;
+		int idleSpins = 0;
+
+		Counters& counters = workers[index]->counters;
+		SteadyClock::time_point idleStart = SteadyClock::now();
+
+		while (true)
+		{
+			if (Task* task = FindTask(index))
+			{
+				idleSpins = 0;
+
+				const SteadyClock::time_point busyStart = SteadyClock::now();
+				counters.idleNs.fetch_add(ElapsedNs(idleStart, busyStart), std::memory_order_relaxed);
+
+				Execute(task);
+
+				idleStart = SteadyClock::now();
+				counters.busyNs.fetch_add(ElapsedNs(busyStart, idleStart), std::memory_order_relaxed);
+				continue;
+			}
+
+			if (++idleSpins < kSpinCount)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			idleSpins = 0;
+
+			sleepingWorkers++;
+			{
+				std::unique_lock<std::mutex> lock(sleepMutex);
+				sleepCondition.wait(lock, [this]() { return stop.load() || queuedTasks.load() > 0; });
+			}
+			sleepingWorkers--;
+
+			if (stop.load() && queuedTasks.load() == 0)
+			{
+				counters.idleNs.fetch_add(ElapsedNs(idleStart, SteadyClock::now()), std::memory_order_relaxed);
+				return;
+			}
+		}
+	}
+
+	void ThreadPool::Enqueue(Task* task)
+	{
+		task->enqueueTime = SteadyClock::now();
+
+		pendingTasks++;
+		const size_t queued = ++queuedTasks;
+
+		size_t maxQueued = maxQueuedTasks.load(std::memory_order_relaxed);
+		while (queued > maxQueued && !maxQueuedTasks.compare_exchange_weak(maxQueued, queued, std::memory_order_relaxed)) {}
+
+		const int index = workerIndex;
+		if (task->priority >= static_cast<int>(TaskPriority::Critical) || workers.empty())
+		{
+			std::unique_lock<std::mutex> lock(criticalMutex);
+			criticalTasks.push_back(task);
+			criticalCount++;
+		}
+		else if (index >= 0)
+		{
+			workers[index]->deque.Push(task);
+		}
+		else
+		{
+			Worker& worker = *workers[nextInbox.fetch_add(1, std::memory_order_relaxed) % workers.size()];
+			std::unique_lock<std::mutex> lock(worker.inboxMutex);
+			worker.inbox.push_back(task);
+			worker.inboxCount++;
+		}
+
+		if (sleepingWorkers.load() > 0)
+		{
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			sleepCondition.notify_one();
+		}
+
+		//Threads helping in HelpUntil may be asleep with nothing to steal.
+		WakeHelpers();
+	}
+
+	ThreadPool::Task* ThreadPool::PopCritical()
+	{
+		if (criticalCount.load(std::memory_order_relaxed) == 0)
+			return nullptr;
+
+		std::unique_lock<std::mutex> lock(criticalMutex);
+		if (criticalTasks.empty())
+			return nullptr;
+
+		Task* task = criticalTasks.front();
+		criticalTasks.pop_front();
+		criticalCount--;
+		return task;
+	}
+
+	/// <summary>
+	///		Moves a worker's inbox out under its lock and returns one task from it.
+	///		When the caller owns the worker the rest of the batch is pushed onto its deque, otherwise it is handed back.
+	/// </summary>
+	ThreadPool::Task* ThreadPool::TakeInbox(Worker& worker, bool isOwner)
+	{
+		if (worker.inboxCount.load(std::memory_order_relaxed) == 0)
+			return nullptr;
+
+		if (!isOwner)
+		{
+			std::unique_lock<std::mutex> lock(worker.inboxMutex, std::try_to_lock);
+			if (!lock.owns_lock() || worker.inbox.empty())
+				return nullptr;
+
+			Task* task = worker.inbox.back();
+			worker.inbox.pop_back();
+			worker.inboxCount--;
+			return task;
+		}
+
+		//Swapping with the owner's batch vector keeps the capacity of both, so draining does not allocate.
+		std::vector<Task*>& batch = worker.inboxBatch;
+		batch.clear();
+		{
+			std::unique_lock<std::mutex> lock(worker.inboxMutex);
+			batch.swap(worker.inbox);
+			worker.inboxCount = 0;
+		}
+
+		if (batch.empty())
+			return nullptr;
+
+		//Lowest priority first so the highest priority sits at the bottom and is popped first.
+		std::stable_sort(batch.begin(), batch.end(), [](const Task* a, const Task* b) { return *a < *b; });
+
+		Task* task = batch.back();
+		batch.pop_back();
+		for (Task* t : batch)
+			worker.deque.Push(t);
+		batch.clear();
+		return task;
+	}
+
+	ThreadPool::Task* ThreadPool::FindTask(int index)
+	{
+		Task* task = PopCritical();
+
+		if (!task && index >= 0)
 		{
-			workers.emplace_back([this] {
+			task = workers[index]->deque.Pop();
+			if (!task)
+				task = TakeInbox(*workers[index], true);
+		}
 
-				while (true)
-				{
-					Task task;
+		if (!task && !workers.empty())
+		{
+			const size_t count = workers.size();
+			const size_t start = (index >= 0) ? static_cast<size_t>(index) + 1 : nextInbox.load(std::memory_order_relaxed);
+			for (size_t i = 0; i < count && !task; i++)
+			{
+				Worker& victim = *workers[(start + i) % count];
+				if (index >= 0 && &victim == workers[index].get())
+					continue;
 
-					{
-						std::unique_lock<std::mutex> lock(mutex);
-						condition.wait(lock, [this]() {return stop || !tasks.empty(); });
+				task = victim.deque.Steal();
+				if (!task)
+					task = TakeInbox(victim, false);
+			}
 
-						if (stop && tasks.empty()) return;
+			if (task)
+				GetCounters(index).steals.fetch_add(1, std::memory_order_relaxed);
+		}
 
-						task = tasks.top();
-						tasks.pop();
-					}
+		if (task)
+			queuedTasks--;
 
-					activeThreads++;
-					task.task();
-					activeThreads--;
-				}
-				});
+		return task;
+	}
+
+	/// <summary>
+	///		Workers take from their own list and refill it from the shared one in batches. Other threads go straight to the shared list.
+	/// </summary>
+	ThreadPool::Task* ThreadPool::PopFreeTask()
+	{
+		constexpr size_t kRefillCount = 64;
+
+		const int index = workerIndex;
+		if (index >= 0)
+		{
+			std::vector<Task*>& freeTasks = workers[index]->freeTasks;
+			if (freeTasks.empty())
+			{
+				std::unique_lock<std::mutex> lock(freeTasksMutex);
+				const size_t count = std::min(kRefillCount, sharedFreeTasks.size());
+				freeTasks.insert(freeTasks.end(), sharedFreeTasks.end() - count, sharedFreeTasks.end());
+				sharedFreeTasks.resize(sharedFreeTasks.size() - count);
+			}
+
+			if (freeTasks.empty())
+				return nullptr;
+
+			Task* task = freeTasks.back();
+			freeTasks.pop_back();
+			return task;
 		}
+
+		std::unique_lock<std::mutex> lock(freeTasksMutex);
+		if (sharedFreeTasks.empty())
+			return nullptr;
+
+		Task* task = sharedFreeTasks.back();
+		sharedFreeTasks.pop_back();
+		return task;
 	}
 
-	void ThreadPool::Submit(std::function<void()> job, TaskPriority priority)
+	/// <summary>
+	///		Tasks are mostly submitted by one thread and executed by another, so a worker that collects
+	///		more than it needs hands half of its list back to the shared one.
+	/// </summary>
+	void ThreadPool::RecycleTask(Task* task)
 	{
+		constexpr size_t kMaxLocalCount = 256;
+
+		task->task.Reset();
+		task->counter = nullptr;
+
+		const int index = workerIndex;
+		if (index >= 0)
 		{
-			std::unique_lock<std::mutex> lock(mutex);
-			tasks.push({ static_cast<int>(priority), job });
+			std::vector<Task*>& freeTasks = workers[index]->freeTasks;
+			freeTasks.push_back(task);
+			if (freeTasks.size() > kMaxLocalCount)
+			{
+				const size_t count = freeTasks.size() / 2;
+				std::unique_lock<std::mutex> lock(freeTasksMutex);
+				sharedFreeTasks.insert(sharedFreeTasks.end(), freeTasks.end() - count, freeTasks.end());
+				freeTasks.resize(freeTasks.size() - count);
+			}
+			return;
 		}
 
-		condition.notify_one();
+		std::unique_lock<std::mutex> lock(freeTasksMutex);
+		sharedFreeTasks.push_back(task);
+	}
+
+	void ThreadPool::Execute(Task* task)
+	{
+		Counters& counters = GetCounters(workerIndex);
+		const uint64_t waitNs = ElapsedNs(task->enqueueTime, SteadyClock::now());
+		counters.waitHistogram[GetPriorityClass(task->priority)][GetWaitBucket(waitNs)].fetch_add(1, std::memory_order_relaxed);
+
+		activeThreads++;
+		task->task();
+		activeThreads--;
+
+		counters.tasksExecuted.fetch_add(1, std::memory_order_relaxed);
+		completedThreads++;
+
+		//Captures are released before the counter is signalled, and the counter may be destroyed as soon as it reaches zero.
+		task->task.Reset();
+		if (TaskCounter* counter = task->counter)
+			counter->Done();
+
+		RecycleTask(task);
+
+		pendingTasks--;
+		WakeHelpers();
 	}
 
 	void ThreadPool::WaitForAll()
 	{
-		std::unique_lock<std::mutex> lock(mutex);
-		condition.wait(lock, [this]() {return tasks.empty() && activeThreads.load() == 0; });
+		HelpUntil([this]() { return pendingTasks.load() == 0; });
 	}
 
 	size_t ThreadPool::GetActiveThreadCount()
@@ -76,7 +367,135 @@ namespace Wiley
 	}
 
 	size_t ThreadPool::GetIdleThreadCount() {
-		return workers.size() - activeThreads.load();
+		return workers.size() - std::min(workers.size(), activeThreads.load());
+	}
+
+	void ThreadPool::Counters::Reset()
+	{
+		busyNs = 0;
+		idleNs = 0;
+		tasksExecuted = 0;
+		steals = 0;
+		for (auto& buckets : waitHistogram)
+			for (auto& bucket : buckets)
+				bucket = 0;
+	}
+
+	ThreadPoolStats ThreadPool::GetStats()const
+	{
+		ThreadPoolStats stats{};
+
+		auto addHistogram = [&stats](const Counters& counters) {
+			for (size_t p = 0; p < ThreadPoolStats::kPriorityClassCount; p++)
+				for (size_t b = 0; b < ThreadPoolStats::kWaitBucketCount; b++)
+					stats.waitHistogram[p][b] += counters.waitHistogram[p][b].load(std::memory_order_relaxed);
+		};
+
+		stats.workers.reserve(workers.size());
+		for (const auto& worker : workers)
+		{
+			const Counters& counters = worker->counters;
+
+			ThreadPoolStats::WorkerStats& workerStats = stats.workers.emplace_back();
+			workerStats.busyMs = counters.busyNs.load(std::memory_order_relaxed) / 1e6;
+			workerStats.idleMs = counters.idleNs.load(std::memory_order_relaxed) / 1e6;
+			workerStats.tasksExecuted = counters.tasksExecuted.load(std::memory_order_relaxed);
+			workerStats.steals = counters.steals.load(std::memory_order_relaxed);
+			addHistogram(counters);
+		}
+
+		stats.externalTasksExecuted = externalCounters.tasksExecuted.load(std::memory_order_relaxed);
+		stats.externalSteals = externalCounters.steals.load(std::memory_order_relaxed);
+		addHistogram(externalCounters);
+
+		stats.queuedTasks = queuedTasks.load();
+		stats.maxQueuedTasks = maxQueuedTasks.load(std::memory_order_relaxed);
+
+		{
+			std::unique_lock<std::mutex> lock(statsMutex);
+			const size_t count = std::min(queueDepthSampleCount, kQueueDepthSampleCount);
+			stats.queueDepthSamples.reserve(count);
+			for (size_t i = queueDepthSampleCount - count; i < queueDepthSampleCount; i++)
+				stats.queueDepthSamples.push_back(queueDepthSamples[i % kQueueDepthSampleCount]);
+		}
+
+		return stats;
+	}
+
+	void ThreadPool::ResetStats()
+	{
+		for (auto& worker : workers)
+			worker->counters.Reset();
+		externalCounters.Reset();
+		maxQueuedTasks = queuedTasks.load();
+
+		std::unique_lock<std::mutex> lock(statsMutex);
+		queueDepthSampleCount = 0;
+		lastSampledTasksExecuted = 0;
+	}
+
+	void ThreadPool::SampleStats()
+	{
+		const size_t queued = queuedTasks.load();
+		const uint64_t executed = completedThreads.load();
+
+		uint64_t executedThisSample = 0;
+		{
+			std::unique_lock<std::mutex> lock(statsMutex);
+			queueDepthSamples[queueDepthSampleCount % kQueueDepthSampleCount] = queued;
+			queueDepthSampleCount++;
+
+			executedThisSample = executed - std::min<uint64_t>(executed, lastSampledTasksExecuted);
+			lastSampledTasksExecuted = executed;
+		}
+
+		TracePlot("ThreadPool Queue Depth", static_cast<int64_t>(queued));
+		TracePlot("ThreadPool Active Workers", static_cast<int64_t>(activeThreads.load()));
+		TracePlot("ThreadPool Sleeping Workers", static_cast<int64_t>(sleepingWorkers.load()));
+		TracePlot("ThreadPool Tasks Executed", static_cast<int64_t>(executedThisSample));
+	}
+
+	uint64_t ThreadPoolStats::GetTasksExecuted()const
+	{
+		uint64_t total = externalTasksExecuted;
+		for (const WorkerStats& worker : workers)
+			total += worker.tasksExecuted;
+		return total;
+	}
+
+	void ThreadPoolStats::Dump(std::ostream& stream)const
+	{
+		static constexpr const char* kPriorityNames[kPriorityClassCount] = { "low", "minor", "normal", "high", "urgent", "critical" };
+
+		stream << "workers " << workers.size() << "\n";
+		for (size_t i = 0; i < workers.size(); i++)
+		{
+			const WorkerStats& worker = workers[i];
+			stream << "worker." << i << ".busy_ms " << worker.busyMs << "\n";
+			stream << "worker." << i << ".idle_ms " << worker.idleMs << "\n";
+			stream << "worker." << i << ".utilization " << worker.GetUtilization() << "\n";
+			stream << "worker." << i << ".tasks " << worker.tasksExecuted << "\n";
+			stream << "worker." << i << ".steals " << worker.steals << "\n";
+		}
+
+		stream << "external.tasks " << externalTasksExecuted << "\n";
+		stream << "external.steals " << externalSteals << "\n";
+		stream << "tasks " << GetTasksExecuted() << "\n";
+		stream << "queue.depth " << queuedTasks << "\n";
+		stream << "queue.max_depth " << maxQueuedTasks << "\n";
+
+		stream << "queue.samples";
+		for (size_t depth : queueDepthSamples)
+			stream << " " << depth;
+		stream << "\n";
+
+		for (size_t p = 0; p < kPriorityClassCount; p++)
+		{
+			stream << "wait_us." << kPriorityNames[p];
+			for (uint64_t count : waitHistogram[p])
+				stream << " " << count;
+			stream << "\n";
+		}
 	}
 
 	ThreadPool& ThreadPool::GetThreadPool()
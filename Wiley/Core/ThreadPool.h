@@ -1,7 +1,10 @@
 #pragma once
+#include "WorkStealingDeque.h"
+#include "TaskFunction.h"
+
 #include <thread>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
@@ -10,11 +13,88 @@
 #include <utility>
 #include <iostream>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <array>
+#include <ostream>
+#include <cstdint>
 
 namespace Wiley {
-	
+
+	/// <summary>
+	///		Lightweight completion counter for fire-and-forget tasks.
+	///		Every task submitted against a counter increments it and decrements it once it has run.
+	///		The counter must outlive the tasks referencing it.
+	/// </summary>
+	class TaskCounter
+	{
+	public:
+		TaskCounter() = default;
+		TaskCounter(const TaskCounter&) = delete;
+		TaskCounter& operator=(const TaskCounter&) = delete;
+
+		void Add(size_t count = 1) { pending.fetch_add(count, std::memory_order_relaxed); }
+		void Done() { pending.fetch_sub(1, std::memory_order_release); }
+
+		bool IsDone()const { return pending.load(std::memory_order_acquire) == 0; }
+		size_t GetPendingCount()const { return pending.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<size_t> pending{ 0 };
+	};
+
+	/// <summary>
+	///		Snapshot of the ThreadPool counters returned by ThreadPool::GetStats().
+	///		Task wait latency is the time between a task being submitted and a thread starting it,
+	///		bucketed in powers of two microseconds: bucket 0 is under 1us, bucket i covers [2^(i-1), 2^i) us and the last bucket is open ended.
+	/// </summary>
+	struct ThreadPoolStats
+	{
+		static constexpr size_t kPriorityClassCount = 6;
+		static constexpr size_t kWaitBucketCount = 24;
+
+		using WaitHistogram = std::array<std::array<uint64_t, kWaitBucketCount>, kPriorityClassCount>;
+
+		struct WorkerStats
+		{
+			double busyMs = 0.0;
+			double idleMs = 0.0;
+			uint64_t tasksExecuted = 0;
+			uint64_t steals = 0;
+
+			double GetUtilization()const { return (busyMs + idleMs > 0.0) ? busyMs / (busyMs + idleMs) : 0.0; }
+		};
+
+		std::vector<WorkerStats> workers;
+
+		//Work done by threads outside of the pool while helping in Wait()/WaitForAll().
+		uint64_t externalTasksExecuted = 0;
+		uint64_t externalSteals = 0;
+
+		size_t queuedTasks = 0;
+		size_t maxQueuedTasks = 0;
+		//Queue depth recorded by SampleStats(), oldest first.
+		std::vector<size_t> queueDepthSamples;
+
+		WaitHistogram waitHistogram{};
+
+		uint64_t GetTasksExecuted()const;
+
+		/// <summary>
+		///		Writes one "key value" pair per line so dumps from two runs can be diffed.
+		/// </summary>
+		void Dump(std::ostream& stream)const;
+	};
+
+	/// <summary>
+	///		Work-stealing job system.
+	///		Every worker owns a lock-free deque it pushes to and pops from. Idle workers steal from the others.
+	///		Threads outside the pool submit through per-worker inboxes (round robin) so submitting never funnels through one lock.
+	///		TaskPriority::Critical tasks bypass the deques and go through a dedicated lane every worker checks first.
+	/// </summary>
 	class ThreadPool
 	{
+	public:
 		enum class TaskPriority : int
 		{
 			Low = 0,
@@ -25,10 +105,13 @@ namespace Wiley {
 			Critical = 50
 		};
 
+	private:
 		struct Task
 		{
 			int priority;
-			std::function<void()> task;
+			TaskFunction task;
+			TaskCounter* counter = nullptr;
+			std::chrono::steady_clock::time_point enqueueTime;
 
 			bool operator<(const Task& other)const
 			{
@@ -36,15 +119,79 @@ namespace Wiley {
 			}
 		};
 
+		//Written with relaxed atomics so GetStats() can read them from any thread.
+		struct Counters
+		{
+			std::atomic<uint64_t> busyNs{ 0 };
+			std::atomic<uint64_t> idleNs{ 0 };
+			std::atomic<uint64_t> tasksExecuted{ 0 };
+			std::atomic<uint64_t> steals{ 0 };
+			std::array<std::array<std::atomic<uint64_t>, ThreadPoolStats::kWaitBucketCount>, ThreadPoolStats::kPriorityClassCount> waitHistogram{};
+
+			void Reset();
+		};
+
+		struct Worker
+		{
+			WorkStealingDeque<Task*> deque;
+
+			//Tasks submitted from threads outside of the pool. Drained into the deque by the owner.
+			std::mutex inboxMutex;
+			std::vector<Task*> inbox;
+			std::atomic<size_t> inboxCount{ 0 };
+
+			//Owner only. Reused when draining the inbox.
+			std::vector<Task*> inboxBatch;
+
+			//Recycled tasks. Owner only.
+			std::vector<Task*> freeTasks;
+
+			Counters counters;
+
+			std::thread thread;
+		};
+
 	public:
+		using Job = std::function<void()>;
+
 		ThreadPool();
 		~ThreadPool();
 
 		void Initialize();
 
-		void Submit(std::function<void()> job, TaskPriority priority = TaskPriority::Minor);
+		/// <summary>
+		///		Runs every queued task and joins the workers. Safe to call more than once.
+		/// </summary>
+		void Shutdown();
+
+		/// <summary>
+		///		Fire-and-forget. The callable is stored inline in a recycled task so this does not allocate
+		///		unless its captures exceed TaskFunction::kInlineSize.
+		/// </summary>
+		template<typename F>
+			requires std::is_void_v<std::invoke_result_t<std::decay_t<F>&>>
+		void Submit(F&& f, TaskPriority priority = TaskPriority::Minor)
+		{
+			Enqueue(AllocateTask(static_cast<int>(priority), std::forward<F>(f), nullptr));
+		}
+
+		/// <summary>
+		///		Fire-and-forget tracked by a counter. Use Wait(counter) or counter.IsDone() to join.
+		/// </summary>
+		template<typename F>
+			requires std::is_void_v<std::invoke_result_t<std::decay_t<F>&>>
+		void Submit(F&& f, TaskCounter& counter, TaskPriority priority = TaskPriority::Minor)
+		{
+			counter.Add();
+			Enqueue(AllocateTask(static_cast<int>(priority), std::forward<F>(f), &counter));
+		}
 
+		/// <summary>
+		///		Submits a call and returns a future for its result.
+		///		Needs a shared state allocation, so prefer the overloads above when the result is not needed.
+		/// </summary>
 		template<typename F, typename...Args>
+			requires (sizeof...(Args) > 0 || !std::is_void_v<std::invoke_result_t<F, Args...>>)
 		auto Submit(F&& f, TaskPriority priority, Args&&... args)
 			-> std::future<typename std::invoke_result<F, Args...>::type>
 		{
@@ -56,37 +203,167 @@ namespace Wiley {
 
 			std::future<return_type> result = task->get_future();
 
-			{
-				std::unique_lock<std::mutex> lock(mutex);
-				tasks.push({ static_cast<int>(priority), [task]() { (*task)(); } });
-			}
-
-			condition.notify_one();
+			Enqueue(AllocateTask(static_cast<int>(priority), [task]() { (*task)(); }, nullptr));
 
 			return result;
 		}
 
+		/// <summary>
+		///		Blocks until every submitted task has finished. The calling thread executes queued tasks while it waits.
+		/// </summary>
 		void WaitForAll();
 
+		/// <summary>
+		///		Executes queued tasks on the calling thread until done() returns true.
+		///		When there is nothing left to help with it sleeps until a task is submitted or completes.
+		/// </summary>
+		template<typename Predicate>
+		void HelpUntil(Predicate&& done)
+		{
+			while (!done())
+			{
+				if (Task* task = FindTask(workerIndex))
+				{
+					Execute(task);
+					continue;
+				}
+
+				//Register before sampling the wake count and re-check afterwards. A submit or completion that lands after
+				//the checks below bumps the count, so the wait returns; one that lands before them is seen by the checks.
+				waitingHelpers++;
+				const uint32_t observed = helperWakeups.load();
+
+				if (done()) {
+					waitingHelpers--;
+					return;
+				}
+
+				if (Task* task = FindTask(workerIndex))
+				{
+					waitingHelpers--;
+					Execute(task);
+					continue;
+				}
+
+				helperWakeups.wait(observed);
+				waitingHelpers--;
+			}
+		}
+
+		/// <summary>
+		///		Helps the pool until the future is ready instead of blocking in future::get().
+		/// </summary>
+		void Wait(const TaskCounter& counter)
+		{
+			HelpUntil([&counter]() { return counter.IsDone(); });
+		}
+
+		template<typename T>
+		void Wait(const std::future<T>& future)
+		{
+			HelpUntil([&future]() {
+				return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+			});
+		}
+
 		size_t GetActiveThreadCount();
 		size_t GetCompletedThreadCount();
 		size_t GetIdleThreadCount();
+		size_t GetWorkerCount()const { return workers.size(); }
+		size_t GetQueuedTaskCount()const { return queuedTasks.load(); }
+
+		/// <summary>
+		///		Reads every counter into a snapshot. Counters are updated while this runs, so totals may be off by the tasks in flight.
+		/// </summary>
+		ThreadPoolStats GetStats()const;
+		void ResetStats();
+
+		/// <summary>
+		///		Records the current queue depth and plots the pool counters to Tracy. Call once per frame.
+		/// </summary>
+		void SampleStats();
+
+		/// <summary>
+		///		Index of the calling worker or -1 when called from a thread outside of the pool.
+		/// </summary>
+		static int GetWorkerIndex() { return workerIndex; }
 
 		static ThreadPool& GetThreadPool();
 	private:
-		std::vector<std::thread> workers;
-		std::priority_queue<Task> tasks;
-		std::mutex mutex;
-		std::condition_variable condition;
-		bool stop = false;
+		void WorkerLoop(int index);
+
+		template<typename F>
+		Task* AllocateTask(int priority, F&& f, TaskCounter* counter)
+		{
+			Task* task = PopFreeTask();
+			if (!task)
+				task = new Task{};
+
+			task->priority = priority;
+			task->task = TaskFunction(std::forward<F>(f));
+			task->counter = counter;
+			return task;
+		}
+
+		Task* PopFreeTask();
+		void RecycleTask(Task* task);
+
+		void Enqueue(Task* task);
+		Task* FindTask(int index);
+		Task* PopCritical();
+		Task* TakeInbox(Worker& worker, bool isOwner);
+		void Execute(Task* task);
+		Counters& GetCounters(int index) { return (index >= 0) ? workers[index]->counters : externalCounters; }
+
+		void WakeHelpers()
+		{
+			helperWakeups++;
+			if (waitingHelpers.load() > 0)
+				helperWakeups.notify_all();
+		}
+
+	private:
+		std::vector<std::unique_ptr<Worker>> workers;
+
+		std::mutex criticalMutex;
+		std::deque<Task*> criticalTasks;
+		std::atomic<size_t> criticalCount{ 0 };
+
+		//Recycled tasks shared by threads outside of the pool and used to rebalance the per-worker lists.
+		std::mutex freeTasksMutex;
+		std::vector<Task*> sharedFreeTasks;
+
+		//Queued but not yet picked up. Used by idle workers to decide whether to sleep.
+		std::atomic<size_t> queuedTasks{ 0 };
+		//Submitted but not yet finished. Used by WaitForAll/HelpUntil.
+		std::atomic<size_t> pendingTasks{ 0 };
+		std::atomic<size_t> waitingHelpers{ 0 };
+		//Bumped on every submit and completion. Only ever grows, so a helper cannot miss a wake-up the way it could
+		//waiting on pendingTasks, whose value can return to the one it sampled.
+		std::atomic<uint32_t> helperWakeups{ 0 };
+		std::atomic<size_t> nextInbox{ 0 };
+
+		std::mutex sleepMutex;
+		std::condition_variable sleepCondition;
+		std::atomic<size_t> sleepingWorkers{ 0 };
+		std::atomic<bool> stop{ false };
 
 		inline static int nThreads = 8;
+		inline static thread_local int workerIndex = -1;
 
 		std::atomic<size_t> activeThreads{ 0 };
 		std::atomic<size_t> completedThreads{ 0 };
+
+		Counters externalCounters;
+		std::atomic<size_t> maxQueuedTasks{ 0 };
+
+		mutable std::mutex statsMutex;
+		static constexpr size_t kQueueDepthSampleCount = 256;
+		std::array<size_t, kQueueDepthSampleCount> queueDepthSamples{};
+		size_t queueDepthSampleCount = 0;
+		uint64_t lastSampledTasksExecuted = 0;
 	};
 
 #define gThreadPool ThreadPool::GetThreadPool()
 
 }
-
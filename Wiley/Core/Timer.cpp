@@ -1,4 +1,10 @@
 #include "timer.h"
+#include "FlatHashMap.h"
+#include "StringId.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
 
 namespace Wiley {
 
@@ -52,4 +58,220 @@ namespace Wiley {
         oss << std::put_time(&local_tm, "%I:%M %p"); // 12-hour format with AM/PM
         t = oss.str();
     }
-}
\ No newline at end of file
+
+    namespace {
+
+        struct NodeCacheKey
+        {
+            uint32_t parent;
+            uint64_t nameHash;
+
+            bool operator==(const NodeCacheKey& other)const = default;
+        };
+
+        struct NodeCacheKeyHash
+        {
+            size_t operator()(const NodeCacheKey& key)const noexcept
+            {
+                return static_cast<size_t>(key.nameHash ^ (static_cast<uint64_t>(key.parent) << 40));
+            }
+        };
+
+        double ToMs(uint64_t nanoseconds)
+        {
+            return static_cast<double>(nanoseconds) / 1'000'000.0;
+        }
+    }
+
+    CPUProfiler::CPUProfiler()
+        :nodes(std::make_unique<Node[]>(kMaxNodes)), children(kMaxNodes)
+    {
+        nodes[kRootNode].name = "Root";
+    }
+
+    CPUProfiler& CPUProfiler::GetCPUProfiler()
+    {
+        static CPUProfiler profiler;
+        return profiler;
+    }
+
+    uint32_t CPUProfiler::GetCurrentNode()
+    {
+        return currentNode;
+    }
+
+    uint32_t CPUProfiler::GetNode(uint32_t parent, const char* name)
+    {
+        if (parent == kInvalidNode)
+            return kInvalidNode;
+
+        //Each thread caches by a hash of the name, so only the first use of a name takes the lock.
+        //Keying by pointer would hand a name built in a reused buffer whatever node that buffer last held.
+        thread_local FlatHashMap<NodeCacheKey, uint32_t, NodeCacheKeyHash> cache;
+
+        const NodeCacheKey key{ parent, Fnv1a64(name) };
+        if (auto it = cache.find(key); it != cache.end())
+            return it->second;
+
+        uint32_t node;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            auto [it, inserted] = nodeIndex.try_emplace({ parent, std::string(name) }, 0);
+            if (inserted)
+            {
+                const uint32_t count = nodeCount.load(std::memory_order_relaxed);
+                if (count >= kMaxNodes)
+                {
+                    //Out of nodes. Folding the scope into its parent would count its time twice, so it is not timed at all.
+                    std::cout << "CPUProfiler node limit reached, dropping samples of " << name << "." << std::endl;
+                    it->second = kInvalidNode;
+                }
+                else
+                {
+                    nodes[count].name = name;
+                    nodes[count].parent = parent;
+                    nodes[count].depth = nodes[parent].depth + 1;
+                    children[parent].push_back(count);
+                    nodeCount.store(count + 1, std::memory_order_release);
+                    it->second = count;
+                }
+            }
+            node = it->second;
+        }
+
+        cache.try_emplace(key, node);
+        return node;
+    }
+
+    void CPUProfiler::AddSample(uint32_t node, uint64_t nanoseconds)
+    {
+        if (node == kInvalidNode)
+            return;
+
+        nodes[node].frameNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+        nodes[node].frameCalls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void CPUProfiler::EndFrame()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const uint32_t count = nodeCount.load(std::memory_order_acquire);
+        for (uint32_t i = 1; i < count; i++)
+        {
+            Node& node = nodes[i];
+            const uint64_t nanoseconds = node.frameNanoseconds.exchange(0, std::memory_order_relaxed);
+            const uint32_t calls = node.frameCalls.exchange(0, std::memory_order_relaxed);
+
+            node.lastNanoseconds = nanoseconds;
+            node.lastCalls = calls;
+            if (calls == 0)
+                continue;
+
+            node.window[node.windowHead] = nanoseconds;
+            node.windowHead = (node.windowHead + 1) % kWindowFrames;
+            node.windowCount = std::min(node.windowCount + 1, kWindowFrames);
+        }
+    }
+
+    void CPUProfiler::ResetStatistics()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        const uint32_t count = nodeCount.load(std::memory_order_acquire);
+        for (uint32_t i = 1; i < count; i++)
+        {
+            nodes[i].windowHead = 0;
+            nodes[i].windowCount = 0;
+            nodes[i].lastNanoseconds = 0;
+            nodes[i].lastCalls = 0;
+        }
+    }
+
+    void CPUProfiler::FillStats(uint32_t index, CPUTimerStats& stats)const
+    {
+        const Node& node = nodes[index];
+        stats.name = node.name;
+        stats.node = index;
+        stats.parent = node.parent;
+        stats.depth = node.depth;
+        stats.sampleCount = node.windowCount;
+        stats.lastCallCount = node.lastCalls;
+        stats.lastMs = ToMs(node.lastNanoseconds);
+
+        if (node.windowCount == 0)
+            return;
+
+        uint64_t sorted[kWindowFrames];
+        std::copy(node.window, node.window + node.windowCount, sorted);
+        std::sort(sorted, sorted + node.windowCount);
+
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < node.windowCount; i++)
+            total += sorted[i];
+
+        auto percentile = [&](double q) {
+            const uint32_t rank = static_cast<uint32_t>(std::ceil(q * node.windowCount));
+            return ToMs(sorted[std::clamp(rank, 1u, node.windowCount) - 1]);
+        };
+
+        stats.minMs = ToMs(sorted[0]);
+        stats.maxMs = ToMs(sorted[node.windowCount - 1]);
+        stats.meanMs = ToMs(total) / node.windowCount;
+        stats.p50Ms = percentile(0.50);
+        stats.p95Ms = percentile(0.95);
+        stats.p99Ms = percentile(0.99);
+    }
+
+    std::vector<CPUTimerStats> CPUProfiler::GetStats()const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::vector<CPUTimerStats> result;
+        result.reserve(nodeCount.load(std::memory_order_acquire));
+
+        std::vector<uint32_t> stack(children[kRootNode].rbegin(), children[kRootNode].rend());
+        while (!stack.empty())
+        {
+            const uint32_t node = stack.back();
+            stack.pop_back();
+
+            FillStats(node, result.emplace_back());
+            stack.insert(stack.end(), children[node].rbegin(), children[node].rend());
+        }
+        return result;
+    }
+
+    bool CPUProfiler::GetStats(std::string_view name, CPUTimerStats& stats)const
+    {
+        for (const CPUTimerStats& candidate : GetStats())
+        {
+            if (candidate.name == name)
+            {
+                stats = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ScopedCPUTimer::ScopedCPUTimer(const char* name)
+        :ScopedCPUTimer(name, CPUProfiler::currentNode)
+    {
+    }
+
+    ScopedCPUTimer::ScopedCPUTimer(const char* name, uint32_t parentNode)
+        :node(gCPUProfiler.GetNode(parentNode, name)), previousNode(CPUProfiler::currentNode)
+    {
+        CPUProfiler::currentNode = node;
+        start = CPUTimer::HRClock::now();
+    }
+
+    ScopedCPUTimer::~ScopedCPUTimer()
+    {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(CPUTimer::HRClock::now() - start);
+        gCPUProfiler.AddSample(node, static_cast<uint64_t>(elapsed.count()));
+        CPUProfiler::currentNode = previousNode;
+    }
+}
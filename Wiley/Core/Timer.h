@@ -4,6 +4,12 @@
 #include <string_view>
 #include <ctime>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <map>
+#include <cstdint>
 
 namespace Wiley {
 
@@ -13,6 +19,11 @@ namespace Wiley {
 #define WILEY_GET_LAST_TIMER_DURATION(x) (x) = CPUTimer::timer().durationMs()
 #define WILEY_SYS_TIME(t) CPUTimer::timer().getSystemTime(t)
 
+#define WILEY_CPU_SCOPE_CONCAT_INNER(a, b) a##b
+#define WILEY_CPU_SCOPE_CONCAT(a, b) WILEY_CPU_SCOPE_CONCAT_INNER(a, b)
+#define WILEY_CPU_SCOPE(name) Wiley::ScopedCPUTimer WILEY_CPU_SCOPE_CONCAT(cpuScope_, __LINE__)(name)
+#define gCPUProfiler CPUProfiler::GetCPUProfiler()
+
 	class ITimer
 	{
 	public:
@@ -46,4 +57,127 @@ namespace Wiley {
 		HRClock::time_point mEnd;
 		HRClock::duration mDuration;
 	};
-}
\ No newline at end of file
+
+	/// <summary>
+	///		Per-name timing statistics over the last kWindowFrames frames in which the scope ran. Times are in milliseconds.
+	/// </summary>
+	struct CPUTimerStats
+	{
+		std::string name;
+		uint32_t node = 0;
+		uint32_t parent = 0;
+		uint32_t depth = 0;
+
+		uint32_t sampleCount = 0;
+		uint32_t lastCallCount = 0;
+
+		double lastMs = 0.0;
+		double minMs = 0.0;
+		double maxMs = 0.0;
+		double meanMs = 0.0;
+		double p50Ms = 0.0;
+		double p95Ms = 0.0;
+		double p99Ms = 0.0;
+	};
+
+	/// <summary>
+	///		Tree of named CPU scopes, independent of Tracy and Optick so benchmarks and editor overlays can query it directly.
+	///		A node is a (parent, name) pair, so the same name under different parents is timed separately.
+	///		Scopes on any thread add their nanoseconds to their node's atomic frame total. EndFrame moves each total into a
+	///		rolling window, which is what the statistics are computed from.
+	///		Each thread nests under its own innermost open scope. Work handed to the ThreadPool starts at the root unless
+	///		the submitting code passes GetCurrentNode() along to the worker's ScopedCPUTimer.
+	/// </summary>
+	class CPUProfiler
+	{
+	public:
+		static constexpr uint32_t kRootNode = 0;
+		static constexpr uint32_t kMaxNodes = 512;
+		static constexpr uint32_t kWindowFrames = 240;
+
+		//Handed out once kMaxNodes is reached. Samples for it, and for every scope nested under it, are dropped.
+		static constexpr uint32_t kInvalidNode = UINT32_MAX;
+
+		CPUProfiler();
+
+		/// <summary>
+		///		Returns the node for name under parent, creating it on first use. Names are compared by content,
+		///		so a name built in a reused buffer still finds its own node.
+		/// </summary>
+		uint32_t GetNode(uint32_t parent, const char* name);
+
+		void AddSample(uint32_t node, uint64_t nanoseconds);
+
+		/// <summary>
+		///		Closes the current frame for every node. Call once per frame while no scope is open on the main thread.
+		/// </summary>
+		void EndFrame();
+
+		void ResetStatistics();
+
+		/// <summary>
+		///		Statistics of every node that has run, parents before their children.
+		/// </summary>
+		std::vector<CPUTimerStats> GetStats()const;
+
+		/// <summary>
+		///		Statistics of the first node with this name in tree order. Returns false if no scope with the name has run.
+		/// </summary>
+		bool GetStats(std::string_view name, CPUTimerStats& stats)const;
+
+		static uint32_t GetCurrentNode();
+
+		static CPUProfiler& GetCPUProfiler();
+
+	private:
+		friend class ScopedCPUTimer;
+
+		struct Node
+		{
+			std::string name;
+			uint32_t parent = kRootNode;
+			uint32_t depth = 0;
+
+			std::atomic<uint64_t> frameNanoseconds{ 0 };
+			std::atomic<uint32_t> frameCalls{ 0 };
+
+			uint64_t window[kWindowFrames] = {};
+			uint32_t windowHead = 0;
+			uint32_t windowCount = 0;
+			uint64_t lastNanoseconds = 0;
+			uint32_t lastCalls = 0;
+		};
+
+		void FillStats(uint32_t node, CPUTimerStats& stats)const;
+
+		inline static thread_local uint32_t currentNode = kRootNode;
+
+	private:
+		std::unique_ptr<Node[]> nodes;
+		std::atomic<uint32_t> nodeCount{ 1 };
+
+		mutable std::mutex mutex;
+		std::map<std::pair<uint32_t, std::string>, uint32_t> nodeIndex;
+		std::vector<std::vector<uint32_t>> children;
+	};
+
+	/// <summary>
+	///		Times its own lifetime into the CPUProfiler node for name, nested under the innermost open scope of this thread
+	///		or under an explicit parent node.
+	/// </summary>
+	class ScopedCPUTimer
+	{
+	public:
+		explicit ScopedCPUTimer(const char* name);
+		ScopedCPUTimer(const char* name, uint32_t parentNode);
+		~ScopedCPUTimer();
+
+		ScopedCPUTimer(const ScopedCPUTimer&) = delete;
+		ScopedCPUTimer& operator=(const ScopedCPUTimer&) = delete;
+
+	private:
+		uint32_t node;
+		uint32_t previousNode;
+		CPUTimer::HRClock::time_point start;
+	};
+}
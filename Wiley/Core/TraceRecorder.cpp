@@ -0,0 +1,258 @@
+#include "TraceRecorder.h"
+
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <charconv>
+#include <algorithm>
+
+namespace Wiley {
+
+	namespace {
+
+		void AppendEscaped(std::string& out, const char* text)
+		{
+			for (const char* c = text; *c; c++)
+			{
+				switch (*c)
+				{
+				case '"': out += "\\\""; break;
+				case '\\': out += "\\\\"; break;
+				case '\n': out += "\\n"; break;
+				case '\t': out += "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(*c) >= 0x20)
+						out += *c;
+					break;
+				}
+			}
+		}
+
+		void AppendUInt(std::string& out, uint64_t value)
+		{
+			char digits[24];
+			const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+			out.append(digits, result.ptr);
+		}
+
+		//Chrome trace timestamps are microseconds, written with nanosecond precision.
+		void AppendMicroseconds(std::string& out, uint64_t nanoseconds)
+		{
+			AppendUInt(out, nanoseconds / 1000);
+			const uint32_t fraction = static_cast<uint32_t>(nanoseconds % 1000);
+			out += '.';
+			out += static_cast<char>('0' + fraction / 100);
+			out += static_cast<char>('0' + (fraction / 10) % 10);
+			out += static_cast<char>('0' + fraction % 10);
+		}
+
+		void AppendDouble(std::string& out, double value)
+		{
+			char digits[32];
+			const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+			out.append(digits, result.ptr);
+		}
+
+		void AppendEventHeader(std::string& out, const char* name, const char* phase, uint32_t threadId)
+		{
+			out += ",\n{\"name\":\"";
+			AppendEscaped(out, name);
+			out += "\",\"ph\":\"";
+			out += phase;
+			out += "\",\"pid\":1,\"tid\":";
+			AppendUInt(out, threadId);
+		}
+	}
+
+	TraceRecorder::TraceRecorder()
+		:epoch(Clock::now())
+	{
+	}
+
+	TraceRecorder& TraceRecorder::GetTraceRecorder()
+	{
+		static TraceRecorder recorder;
+		return recorder;
+	}
+
+	void TraceRecorder::Start(uint32_t eventsPerThread)
+	{
+		Stop();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		this->eventsPerThread = std::bit_ceil(std::max<uint32_t>(eventsPerThread, 2));
+
+		//Rings are owned by their threads, so each one resets itself on its next event once it sees the new generation.
+		generation.fetch_add(1, std::memory_order_release);
+		recording.store(true, std::memory_order_release);
+	}
+
+	void TraceRecorder::Stop()
+	{
+		recording.store(false, std::memory_order_release);
+	}
+
+	TraceRecorder::ThreadBuffer& TraceRecorder::GetThreadBuffer()
+	{
+		thread_local ThreadBuffer* buffer = nullptr;
+		if (!buffer)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			auto& created = threads.emplace_back(std::make_unique<ThreadBuffer>());
+			created->threadId = static_cast<uint32_t>(threads.size());
+			buffer = created.get();
+		}
+		return *buffer;
+	}
+
+	void TraceRecorder::SetThreadName(const char* name)
+	{
+		ThreadBuffer& buffer = GetThreadBuffer();
+		std::lock_guard<std::mutex> lock(mutex);
+		buffer.name = name;
+	}
+
+	void TraceRecorder::Push(const Event& event)
+	{
+		if (!recording.load(std::memory_order_relaxed))
+			return;
+
+		ThreadBuffer& buffer = GetThreadBuffer();
+
+		const uint64_t currentGeneration = generation.load(std::memory_order_acquire);
+		if (buffer.generation != currentGeneration)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (buffer.mask + 1 != eventsPerThread)
+			{
+				buffer.events = std::make_unique<Event[]>(eventsPerThread);
+				buffer.mask = eventsPerThread - 1;
+			}
+			buffer.head.store(0, std::memory_order_relaxed);
+			buffer.generation = currentGeneration;
+		}
+
+		//Single writer, so the slot is filled first and then published by moving head past it.
+		const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+		buffer.events[head & buffer.mask] = event;
+		buffer.head.store(head + 1, std::memory_order_release);
+	}
+
+	void TraceRecorder::RecordZone(const char* name, uint64_t startNs, uint64_t endNs)
+	{
+		Event event;
+		event.name = name;
+		event.timestampNs = startNs;
+		event.durationNs = endNs - startNs;
+		event.type = EventType::Zone;
+		Push(event);
+	}
+
+	void TraceRecorder::RecordFrame(const char* name)
+	{
+		Event event;
+		event.name = name;
+		event.timestampNs = Now();
+		event.durationNs = 0;
+		event.type = EventType::Frame;
+		Push(event);
+	}
+
+	void TraceRecorder::RecordCounter(const char* name, double value)
+	{
+		Event event;
+		event.name = name;
+		event.timestampNs = Now();
+		event.value = value;
+		event.type = EventType::Counter;
+		Push(event);
+	}
+
+	bool TraceRecorder::WriteChromeTrace(const std::filesystem::path& path)const
+	{
+		std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		std::string out;
+		out.reserve(1 << 20);
+		out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+		out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Wiley\"}}";
+
+		std::lock_guard<std::mutex> lock(mutex);
+		const uint64_t currentGeneration = generation.load(std::memory_order_acquire);
+
+		std::vector<Event> snapshot;
+		for (const auto& thread : threads)
+		{
+			const ThreadBuffer& buffer = *thread;
+
+			if (!buffer.name.empty())
+			{
+				AppendEventHeader(out, "thread_name", "M", buffer.threadId);
+				out += ",\"args\":{\"name\":\"";
+				AppendEscaped(out, buffer.name.c_str());
+				out += "\"}}";
+			}
+
+			//The generation and ring are only replaced by their owner under the mutex we hold.
+			if (buffer.generation != currentGeneration || !buffer.events)
+				continue;
+
+			const uint64_t capacity = static_cast<uint64_t>(buffer.mask) + 1;
+			const uint64_t end = buffer.head.load(std::memory_order_acquire);
+			uint64_t begin = (end > capacity) ? end - capacity : 0;
+
+			snapshot.clear();
+			for (uint64_t i = begin; i < end; i++)
+				snapshot.push_back(buffer.events[i & buffer.mask]);
+
+			//Anything the owner may have started overwriting during the copy is dropped.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const uint64_t after = buffer.head.load(std::memory_order_relaxed);
+			const uint64_t firstValid = (after + 1 > capacity) ? after + 1 - capacity : 0;
+			const size_t skip = static_cast<size_t>(std::min(std::max(firstValid, begin) - begin, end - begin));
+
+			for (size_t i = skip; i < snapshot.size(); i++)
+			{
+				const Event& event = snapshot[i];
+				switch (event.type)
+				{
+				case EventType::Zone:
+					AppendEventHeader(out, event.name, "X", buffer.threadId);
+					out += ",\"ts\":";
+					AppendMicroseconds(out, event.timestampNs);
+					out += ",\"dur\":";
+					AppendMicroseconds(out, event.durationNs);
+					out += '}';
+					break;
+				case EventType::Frame:
+					AppendEventHeader(out, event.name, "i", buffer.threadId);
+					out += ",\"s\":\"g\",\"ts\":";
+					AppendMicroseconds(out, event.timestampNs);
+					out += '}';
+					break;
+				case EventType::Counter:
+					//JSON has no NaN or infinity, one bad sample would make the whole trace unreadable.
+					if (!std::isfinite(event.value))
+						break;
+					AppendEventHeader(out, event.name, "C", buffer.threadId);
+					out += ",\"ts\":";
+					AppendMicroseconds(out, event.timestampNs);
+					out += ",\"args\":{\"value\":";
+					AppendDouble(out, event.value);
+					out += "}}";
+					break;
+				}
+			}
+
+			file.write(out.data(), static_cast<std::streamsize>(out.size()));
+			out.clear();
+		}
+
+		out += "\n]}\n";
+		file.write(out.data(), static_cast<std::streamsize>(out.size()));
+		return file.good();
+	}
+
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+namespace Wiley {
+
+#define gTraceRecorder TraceRecorder::GetTraceRecorder()
+
+	/// <summary>
+	///		Built-in timeline recorder for runs without a Tracy or Optick client attached, e.g. headless perf boxes.
+	///		Every thread records zones, frame markers and counters into its own ring, so recording never takes a lock.
+	///		A ring keeps the newest events and overwrites the oldest. WriteChromeTrace writes the rings as Chrome Trace Event JSON,
+	///		which chrome://tracing and the Perfetto UI both open.
+	///		Names must outlive the recording, which string literals and __FUNCTION__ from the Trace* macros do.
+	///		While not recording a zone costs one relaxed load.
+	/// </summary>
+	class TraceRecorder
+	{
+	public:
+		static constexpr uint32_t kDefaultEventsPerThread = 1 << 16;
+
+		TraceRecorder();
+
+		TraceRecorder(const TraceRecorder&) = delete;
+		TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+		/// <summary>
+		///		Clears everything recorded so far and starts recording. eventsPerThread is rounded up to a power of two.
+		/// </summary>
+		void Start(uint32_t eventsPerThread = kDefaultEventsPerThread);
+		void Stop();
+
+		bool IsRecording()const { return recording.load(std::memory_order_relaxed); }
+
+		/// <summary>
+		///		Names the calling thread in the trace. Can be called before Start.
+		/// </summary>
+		void SetThreadName(const char* name);
+
+		void RecordZone(const char* name, uint64_t startNs, uint64_t endNs);
+		void RecordFrame(const char* name);
+		void RecordCounter(const char* name, double value);
+
+		/// <summary>
+		///		Writes what the rings currently hold. Safe while recording, events written during the copy may be left out.
+		///		Returns false if the file could not be written.
+		/// </summary>
+		bool WriteChromeTrace(const std::filesystem::path& path)const;
+
+		/// <summary>
+		///		Nanoseconds since the recorder was created, the time base of every event.
+		/// </summary>
+		uint64_t Now()const
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count());
+		}
+
+		static TraceRecorder& GetTraceRecorder();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		enum class EventType : uint32_t
+		{
+			Zone,
+			Frame,
+			Counter
+		};
+
+		struct Event
+		{
+			const char* name;
+			uint64_t timestampNs;
+			union
+			{
+				uint64_t durationNs;
+				double value;
+			};
+			EventType type;
+		};
+
+		struct ThreadBuffer
+		{
+			uint32_t threadId = 0;
+			std::string name;
+
+			std::unique_ptr<Event[]> events;
+			uint32_t mask = 0;
+			std::atomic<uint64_t> head{ 0 };
+			uint64_t generation = 0;
+		};
+
+		ThreadBuffer& GetThreadBuffer();
+		void Push(const Event& event);
+
+	private:
+		const Clock::time_point epoch;
+
+		std::atomic<bool> recording{ false };
+		std::atomic<uint64_t> generation{ 0 };
+		uint32_t eventsPerThread = kDefaultEventsPerThread;
+
+		mutable std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> threads;
+	};
+
+	/// <summary>
+	///		Records its own lifetime as a zone when the recorder was running at construction.
+	/// </summary>
+	class TraceScope
+	{
+	public:
+		explicit TraceScope(const char* name)
+			:name(name), startNs(gTraceRecorder.IsRecording() ? gTraceRecorder.Now() : kNotRecording)
+		{
+		}
+
+		~TraceScope()
+		{
+			if (startNs != kNotRecording)
+				gTraceRecorder.RecordZone(name, startNs, gTraceRecorder.Now());
+		}
+
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+
+	private:
+		static constexpr uint64_t kNotRecording = ~0ULL;
+
+		const char* name;
+		uint64_t startNs;
+	};
+
+}
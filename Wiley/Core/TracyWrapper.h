@@ -1,4 +1,14 @@
 #pragma once
 #include "Tracy/tracy/Tracy.hpp"
+#include "TraceRecorder.h"
 
-#define TraceZone ZoneScoped
\ No newline at end of file
+//Engine-side profiling macros. Each one feeds Tracy and the built-in TraceRecorder, so call sites annotate once.
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#define TraceZone ZoneScoped; Wiley::TraceScope TRACE_CONCAT(traceScope_, __LINE__)(__FUNCTION__)
+#define TraceZoneN(name) ZoneScopedN(name); Wiley::TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+#define TraceFrameMark(name) do { FrameMarkNamed(name); Wiley::TraceRecorder::GetTraceRecorder().RecordFrame(name); } while (0)
+#define TracePlot(name, value) do { const auto tracePlotValue = (value); TracyPlot(name, tracePlotValue); Wiley::TraceRecorder::GetTraceRecorder().RecordCounter(name, static_cast<double>(tracePlotValue)); } while (0)
+#define TraceThreadName(name) do { tracy::SetThreadName(name); Wiley::TraceRecorder::GetTraceRecorder().SetThreadName(name); } while (0)
@@ -0,0 +1,280 @@
+#include "TransformBatch.h"
+
+#include <cmath>
+
+namespace Wiley {
+
+	namespace {
+
+		constexpr float kDegreesToRadians = DirectX::XM_PI / 180.0f;
+		constexpr float kOneOverTwoPi = 0.159154943f;
+		constexpr float kTwoPi = 6.283185307f;
+		constexpr float kPi = 3.141592654f;
+		constexpr float kPiOverTwo = 1.570796327f;
+
+		//One lane per transform. Kept in the same shape as the SIMD lanes so the kernel below is written once.
+		struct ScalarLanes
+		{
+			using Value = float;
+			using Mask = bool;
+			static constexpr size_t kWidth = 1;
+
+			static Value Load(const float* p) { return *p; }
+			static Value Set(float v) { return v; }
+			static Value Add(Value a, Value b) { return a + b; }
+			static Value Sub(Value a, Value b) { return a - b; }
+			static Value Mul(Value a, Value b) { return a * b; }
+			static Value Round(Value a) { return std::nearbyint(a); }
+			static Value Abs(Value a) { return std::fabs(a); }
+			static Value CopySign(Value magnitude, Value sign) { return std::copysign(magnitude, sign); }
+			static Mask LessEqual(Value a, Value b) { return a <= b; }
+			static Value Select(Value ifFalse, Value ifTrue, Mask mask) { return mask ? ifTrue : ifFalse; }
+		};
+
+#ifdef WILEY_SIMD_SSE
+		struct SSELanes
+		{
+			using Value = __m128;
+			using Mask = __m128;
+			static constexpr size_t kWidth = 4;
+
+			static Value Load(const float* p) { return _mm_loadu_ps(p); }
+			static Value Set(float v) { return _mm_set1_ps(v); }
+			static Value Add(Value a, Value b) { return _mm_add_ps(a, b); }
+			static Value Sub(Value a, Value b) { return _mm_sub_ps(a, b); }
+			static Value Mul(Value a, Value b) { return _mm_mul_ps(a, b); }
+			//Round to nearest even through the integer conversion, SSE2 has no round instruction.
+			static Value Round(Value a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+			static Value Abs(Value a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+			static Value CopySign(Value magnitude, Value sign)
+			{
+				const __m128 signMask = _mm_set1_ps(-0.0f);
+				return _mm_or_ps(_mm_andnot_ps(signMask, magnitude), _mm_and_ps(signMask, sign));
+			}
+			static Mask LessEqual(Value a, Value b) { return _mm_cmple_ps(a, b); }
+			static Value Select(Value ifFalse, Value ifTrue, Mask mask) { return _mm_or_ps(_mm_andnot_ps(mask, ifFalse), _mm_and_ps(mask, ifTrue)); }
+		};
+#endif
+
+#ifdef WILEY_SIMD_AVX
+		struct AVXLanes
+		{
+			using Value = __m256;
+			using Mask = __m256;
+			static constexpr size_t kWidth = 8;
+
+			static Value Load(const float* p) { return _mm256_loadu_ps(p); }
+			static Value Set(float v) { return _mm256_set1_ps(v); }
+			static Value Add(Value a, Value b) { return _mm256_add_ps(a, b); }
+			static Value Sub(Value a, Value b) { return _mm256_sub_ps(a, b); }
+			static Value Mul(Value a, Value b) { return _mm256_mul_ps(a, b); }
+			//Same conversion as the SSE lanes so both paths round ties identically.
+			static Value Round(Value a) { return _mm256_cvtepi32_ps(_mm256_cvtps_epi32(a)); }
+			static Value Abs(Value a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+			static Value CopySign(Value magnitude, Value sign)
+			{
+				const __m256 signMask = _mm256_set1_ps(-0.0f);
+				return _mm256_or_ps(_mm256_andnot_ps(signMask, magnitude), _mm256_and_ps(signMask, sign));
+			}
+			static Mask LessEqual(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+			static Value Select(Value ifFalse, Value ifTrue, Mask mask) { return _mm256_blendv_ps(ifFalse, ifTrue, mask); }
+		};
+#endif
+
+		/// <summary>
+		///		Sine and cosine with the range reduction and 11/10 degree minimax polynomials XMScalarSinCos and XMVectorSinCos use.
+		/// </summary>
+		template<typename L>
+		void SinCos(typename L::Value angle, typename L::Value& sin, typename L::Value& cos)
+		{
+			using V = typename L::Value;
+
+			//Map to [-pi, pi].
+			const V quotient = L::Round(L::Mul(angle, L::Set(kOneOverTwoPi)));
+			V y = L::Sub(angle, L::Mul(quotient, L::Set(kTwoPi)));
+
+			//Reflect into [-pi/2, pi/2]. Sine is unchanged, cosine flips sign.
+			const V reflected = L::Sub(L::CopySign(L::Set(kPi), y), y);
+			const typename L::Mask inRange = L::LessEqual(L::Abs(y), L::Set(kPiOverTwo));
+			y = L::Select(reflected, y, inRange);
+			const V sign = L::Select(L::Set(-1.0f), L::Set(1.0f), inRange);
+
+			const V y2 = L::Mul(y, y);
+
+			V s = L::Add(L::Mul(L::Set(-2.3889859e-08f), y2), L::Set(2.7525562e-06f));
+			s = L::Add(L::Mul(s, y2), L::Set(-0.00019840874f));
+			s = L::Add(L::Mul(s, y2), L::Set(0.0083333310f));
+			s = L::Add(L::Mul(s, y2), L::Set(-0.16666667f));
+			s = L::Add(L::Mul(s, y2), L::Set(1.0f));
+			sin = L::Mul(s, y);
+
+			V c = L::Add(L::Mul(L::Set(-2.6051615e-07f), y2), L::Set(2.4760495e-05f));
+			c = L::Add(L::Mul(c, y2), L::Set(-0.0013888378f));
+			c = L::Add(L::Mul(c, y2), L::Set(0.041666638f));
+			c = L::Add(L::Mul(c, y2), L::Set(-0.5f));
+			c = L::Add(L::Mul(c, y2), L::Set(1.0f));
+			cos = L::Mul(c, sign);
+		}
+
+		/// <summary>
+		///		Composes L::kWidth transforms starting at index. rows receives the first three rows of each stored matrix,
+		///		element [row * 4 + column], one lane per transform. The fourth row is always (0, 0, 0, 1).
+		/// </summary>
+		template<typename L>
+		void ComposeLanes(const TransformStreams& streams, size_t index, typename L::Value rows[12])
+		{
+			using V = typename L::Value;
+
+			const V degreesToRadians = L::Set(kDegreesToRadians);
+			V sx, cx, sy, cy, sz, cz;
+			SinCos<L>(L::Mul(L::Load(streams.rotationX + index), degreesToRadians), sx, cx);
+			SinCos<L>(L::Mul(L::Load(streams.rotationY + index), degreesToRadians), sy, cy);
+			SinCos<L>(L::Mul(L::Load(streams.rotationZ + index), degreesToRadians), sz, cz);
+
+			//RotationX * RotationY * RotationZ expanded, r[i][j] in DirectXMath's row vector layout.
+			const V sxsy = L::Mul(sx, sy);
+			const V cxsy = L::Mul(cx, sy);
+			V r[3][3];
+			r[0][0] = L::Mul(cy, cz);
+			r[0][1] = L::Mul(cy, sz);
+			r[0][2] = L::Sub(L::Set(0.0f), sy);
+			r[1][0] = L::Sub(L::Mul(sxsy, cz), L::Mul(cx, sz));
+			r[1][1] = L::Add(L::Mul(sxsy, sz), L::Mul(cx, cz));
+			r[1][2] = L::Mul(sx, cy);
+			r[2][0] = L::Add(L::Mul(cxsy, cz), L::Mul(sx, sz));
+			r[2][1] = L::Sub(L::Mul(cxsy, sz), L::Mul(sx, cz));
+			r[2][2] = L::Mul(cx, cy);
+
+			const V t[3] = { L::Load(streams.positionX + index), L::Load(streams.positionY + index), L::Load(streams.positionZ + index) };
+			const V s[3] = { L::Load(streams.scaleX + index), L::Load(streams.scaleY + index), L::Load(streams.scaleZ + index) };
+
+			//Translation * R * Scaling scales column j of T * R by s[j]. Transposing turns that column into stored row j.
+			for (int j = 0; j < 3; j++)
+			{
+				const V translated = L::Add(L::Add(L::Mul(t[0], r[0][j]), L::Mul(t[1], r[1][j])), L::Mul(t[2], r[2][j]));
+				rows[j * 4 + 0] = L::Mul(r[0][j], s[j]);
+				rows[j * 4 + 1] = L::Mul(r[1][j], s[j]);
+				rows[j * 4 + 2] = L::Mul(r[2][j], s[j]);
+				rows[j * 4 + 3] = L::Mul(translated, s[j]);
+			}
+		}
+
+		void ComposeScalar(const TransformStreams& streams, size_t begin, size_t end, DirectX::XMFLOAT4X4* out)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				float rows[12];
+				ComposeLanes<ScalarLanes>(streams, i, rows);
+				out[i] = DirectX::XMFLOAT4X4(
+					rows[0], rows[1], rows[2], rows[3],
+					rows[4], rows[5], rows[6], rows[7],
+					rows[8], rows[9], rows[10], rows[11],
+					0.0f, 0.0f, 0.0f, 1.0f
+				);
+			}
+		}
+
+#ifdef WILEY_SIMD_SSE
+		void ComposeSSE(const TransformStreams& streams, size_t count, DirectX::XMFLOAT4X4* out)
+		{
+			const __m128 lastRow = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+			size_t i = 0;
+			for (; i + SSELanes::kWidth <= count; i += SSELanes::kWidth)
+			{
+				__m128 rows[12];
+				ComposeLanes<SSELanes>(streams, i, rows);
+
+				//Each group of four holds one row element across four transforms. Transposing gives that row of each matrix.
+				for (int row = 0; row < 3; row++)
+				{
+					__m128 a = rows[row * 4 + 0], b = rows[row * 4 + 1], c = rows[row * 4 + 2], d = rows[row * 4 + 3];
+					_MM_TRANSPOSE4_PS(a, b, c, d);
+					_mm_storeu_ps(&out[i + 0].m[row][0], a);
+					_mm_storeu_ps(&out[i + 1].m[row][0], b);
+					_mm_storeu_ps(&out[i + 2].m[row][0], c);
+					_mm_storeu_ps(&out[i + 3].m[row][0], d);
+				}
+				for (size_t k = 0; k < SSELanes::kWidth; k++)
+					_mm_storeu_ps(&out[i + k].m[3][0], lastRow);
+			}
+
+			ComposeScalar(streams, i, count, out);
+		}
+#endif
+
+#ifdef WILEY_SIMD_AVX
+		void ComposeAVX(const TransformStreams& streams, size_t count, DirectX::XMFLOAT4X4* out)
+		{
+			const __m128 lastRow = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+			size_t i = 0;
+			for (; i + AVXLanes::kWidth <= count; i += AVXLanes::kWidth)
+			{
+				__m256 rows[12];
+				ComposeLanes<AVXLanes>(streams, i, rows);
+
+				//A 4x4 transpose inside each 128-bit half: the low half yields transforms 0-3, the high half 4-7.
+				for (int row = 0; row < 3; row++)
+				{
+					const __m256 ab0 = _mm256_unpacklo_ps(rows[row * 4 + 0], rows[row * 4 + 1]);
+					const __m256 ab1 = _mm256_unpackhi_ps(rows[row * 4 + 0], rows[row * 4 + 1]);
+					const __m256 cd0 = _mm256_unpacklo_ps(rows[row * 4 + 2], rows[row * 4 + 3]);
+					const __m256 cd1 = _mm256_unpackhi_ps(rows[row * 4 + 2], rows[row * 4 + 3]);
+
+					const __m256 m0 = _mm256_shuffle_ps(ab0, cd0, _MM_SHUFFLE(1, 0, 1, 0));
+					const __m256 m1 = _mm256_shuffle_ps(ab0, cd0, _MM_SHUFFLE(3, 2, 3, 2));
+					const __m256 m2 = _mm256_shuffle_ps(ab1, cd1, _MM_SHUFFLE(1, 0, 1, 0));
+					const __m256 m3 = _mm256_shuffle_ps(ab1, cd1, _MM_SHUFFLE(3, 2, 3, 2));
+
+					_mm_storeu_ps(&out[i + 0].m[row][0], _mm256_castps256_ps128(m0));
+					_mm_storeu_ps(&out[i + 1].m[row][0], _mm256_castps256_ps128(m1));
+					_mm_storeu_ps(&out[i + 2].m[row][0], _mm256_castps256_ps128(m2));
+					_mm_storeu_ps(&out[i + 3].m[row][0], _mm256_castps256_ps128(m3));
+					_mm_storeu_ps(&out[i + 4].m[row][0], _mm256_extractf128_ps(m0, 1));
+					_mm_storeu_ps(&out[i + 5].m[row][0], _mm256_extractf128_ps(m1, 1));
+					_mm_storeu_ps(&out[i + 6].m[row][0], _mm256_extractf128_ps(m2, 1));
+					_mm_storeu_ps(&out[i + 7].m[row][0], _mm256_extractf128_ps(m3, 1));
+				}
+				for (size_t k = 0; k < AVXLanes::kWidth; k++)
+					_mm_storeu_ps(&out[i + k].m[3][0], lastRow);
+			}
+
+			//Avoid the AVX to SSE transition penalty in whatever legacy SSE code runs next.
+			_mm256_zeroupper();
+
+			ComposeScalar(streams, i, count, out);
+		}
+#endif
+
+	}
+
+	void ComposeTransforms(const TransformStreams& streams, size_t count, DirectX::XMFLOAT4X4* out)
+	{
+		ComposeTransforms(GetSimdPath(), streams, count, out);
+	}
+
+	void ComposeTransforms(SimdPath path, const TransformStreams& streams, size_t count, DirectX::XMFLOAT4X4* out)
+	{
+		if (!IsSimdPathSupported(path))
+			path = SimdPath::Scalar;
+
+		switch (path)
+		{
+#ifdef WILEY_SIMD_AVX
+		case SimdPath::AVX:
+			ComposeAVX(streams, count, out);
+			return;
+#endif
+#ifdef WILEY_SIMD_SSE
+		case SimdPath::SSE:
+			ComposeSSE(streams, count, out);
+			return;
+#endif
+		default:
+			ComposeScalar(streams, 0, count, out);
+			return;
+		}
+	}
+
+}
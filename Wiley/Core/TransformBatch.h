@@ -0,0 +1,39 @@
+#pragma once
+#include "SimdSupport.h"
+
+#include <DirectXMath.h>
+
+#include <cstddef>
+
+namespace Wiley {
+
+	/// <summary>
+	///		Structure-of-arrays view over a batch of transforms, one stream per component.
+	///		Rotation is Euler angles in degrees, the same as TransformComponent.
+	/// </summary>
+	struct TransformStreams
+	{
+		const float* positionX = nullptr;
+		const float* positionY = nullptr;
+		const float* positionZ = nullptr;
+
+		const float* rotationX = nullptr;
+		const float* rotationY = nullptr;
+		const float* rotationZ = nullptr;
+
+		const float* scaleX = nullptr;
+		const float* scaleY = nullptr;
+		const float* scaleZ = nullptr;
+	};
+
+	/// <summary>
+	///		Composes count model matrices from the streams into out, in the layout TransformComponent::modelMatrix stores:
+	///		transpose(Translation * RotationX * RotationY * RotationZ * Scaling).
+	///		The SIMD paths compose 4 or 8 matrices per iteration and finish the remainder with the scalar kernel.
+	///		Every path runs the same arithmetic, so they agree with each other exactly and with DirectXMath within rounding.
+	///		Without a path the widest one GetSimdPath reports is used. An unsupported path falls back to scalar.
+	/// </summary>
+	void ComposeTransforms(const TransformStreams& streams, size_t count, DirectX::XMFLOAT4X4* out);
+	void ComposeTransforms(SimdPath path, const TransformStreams& streams, size_t count, DirectX::XMFLOAT4X4* out);
+
+}
@@ -1,19 +1,114 @@
 #include "uuid.h"
 
+#include <random>
+#include <chrono>
+#include <atomic>
+#include <array>
+#include <thread>
+#include <stdexcept>
+
 namespace Wiley {
     UUID UUIDFactory::invalid{ 0,0 };
-    UUID UUIDFactory::generateUUID()
+
+    namespace {
+
+        uint64_t SplitMix64(uint64_t& state)
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        uint64_t RotateLeft(uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+        /// <summary>
+        ///     xoshiro256**. Each thread seeds its own from one random_device draw per process,
+        ///     mixed with a per-thread counter so threads never share a sequence.
+        /// </summary>
+        struct UUIDGenerator
+        {
+            uint64_t s[4];
+
+            UUIDGenerator()
+            {
+                static const uint64_t processSeed = []() {
+                    std::random_device rd;
+                    return (static_cast<uint64_t>(rd()) << 32) ^ rd() ^
+                        static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+                }();
+                static std::atomic<uint64_t> threadCounter{ 0 };
+
+                uint64_t seed = processSeed ^ (threadCounter.fetch_add(1, std::memory_order_relaxed) * 0xD1B54A32D192ED03ULL);
+                for (uint64_t& word : s)
+                    word = SplitMix64(seed);
+            }
+
+            uint64_t Next()
+            {
+                const uint64_t result = RotateLeft(s[1] * 5, 7) * 9;
+                const uint64_t t = s[1] << 17;
+
+                s[2] ^= s[0];
+                s[3] ^= s[1];
+                s[1] ^= s[2];
+                s[0] ^= s[3];
+                s[2] ^= t;
+                s[3] = RotateLeft(s[3], 45);
+
+                return result;
+            }
+        };
+
+        constexpr char kHexDigits[] = "0123456789abcdef";
+
+        //Nibble value of every ASCII hex digit, 0xFF for everything else.
+        constexpr std::array<uint8_t, 256> kHexValues = []() {
+            std::array<uint8_t, 256> values{};
+            values.fill(0xFF);
+            for (uint8_t i = 0; i < 10; i++)
+                values['0' + i] = i;
+            for (uint8_t i = 0; i < 6; i++) {
+                values['a' + i] = 10 + i;
+                values['A' + i] = 10 + i;
+            }
+            return values;
+        }();
+
+        //Decodes 16 hex digits. Invalid characters set bits above the low nibble of the error accumulator instead of branching.
+        uint64_t DecodeHex16(const char* hex, uint8_t& error)
+        {
+            uint64_t value = 0;
+            for (int i = 0; i < 16; i++) {
+                const uint8_t nibble = kHexValues[static_cast<uint8_t>(hex[i])];
+                error |= nibble;
+                value = (value << 4) | (nibble & 0xF);
+            }
+            return value;
+        }
+    }
+
+    UUID UUIDFactory::generateUUID(UUIDVersion version)
     {
-        std::random_device rd;
-        std::mt19937_64 gen(rd());
-        std::uniform_int_distribution<uint64_t> dis(0, 0xFFFFFFFFFFFFFFFF);
+        thread_local UUIDGenerator generator;
 
         UUID uuid;
-        uuid.high = dis(gen);
-        uuid.low = dis(gen);
+        uuid.high = generator.Next();
+        uuid.low = generator.Next();
+
+        if (version == UUIDVersion::V7) {
+            const uint64_t unixMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
 
-        uuid.high &= 0xFFFFFFFFFFFF0FFFULL;
-        uuid.high |= 0x0000000000004000ULL;
+            uuid.high = (unixMs << 16) | (uuid.high & 0x0FFFULL) | 0x7000ULL;
+        }
+        else {
+            uuid.high &= 0xFFFFFFFFFFFF0FFFULL;
+            uuid.high |= 0x0000000000004000ULL;
+        }
 
         uuid.low &= 0x3FFFFFFFFFFFFFFFULL;
         uuid.low |= 0x8000000000000000ULL;
@@ -21,51 +116,72 @@ namespace Wiley {
         return uuid;
     }
 
-    std::string UUIDFactory::uuidToString(const UUID& uuid)
+    void UUIDFactory::uuidToChars(const UUID& uuid, char* out)
     {
-        std::stringstream ss;
-        ss << std::hex << std::setfill('0');
-
-        uint64_t h = uuid.high;
-        uint64_t l = uuid.low;
-
-        ss << std::setw(8) << ((h >> 32) & 0xFFFFFFFF) << "-";
-        ss << std::setw(4) << ((h >> 16) & 0xFFFF) << "-";
-        ss << std::setw(4) << (h & 0xFFFF) << "-";
-        ss << std::setw(4) << ((l >> 48) & 0xFFFF) << "-";
-        ss << std::setw(12) << (l & 0xFFFFFFFFFFFFULL);
+        //Output position of each of the 32 nibbles, skipping the hyphens of the 8-4-4-4-12 form.
+        static constexpr std::array<uint8_t, 32> kPositions = []() {
+            std::array<uint8_t, 32> positions{};
+            uint8_t position = 0;
+            for (uint8_t i = 0; i < 32; i++) {
+                if (i == 8 || i == 12 || i == 16 || i == 20)
+                    position++;
+                positions[i] = position++;
+            }
+            return positions;
+        }();
 
-        return ss.str();
+        out[8] = out[13] = out[18] = out[23] = '-';
+        for (int i = 0; i < 16; i++) {
+            out[kPositions[i]] = kHexDigits[(uuid.high >> (60 - 4 * i)) & 0xF];
+            out[kPositions[16 + i]] = kHexDigits[(uuid.low >> (60 - 4 * i)) & 0xF];
+        }
     }
 
-    std::string removeHyphens(const std::string& s)
+    std::string UUIDFactory::uuidToString(const UUID& uuid)
     {
-        std::string result;
-        std::copy_if(s.begin(), s.end(), std::back_inserter(result),
-            [](char c) { return c != '-'; });
+        std::string result(kStringLength, '\0');
+        uuidToChars(uuid, result.data());
         return result;
     }
 
-    uint64_t hexToUint64(const std::string& hex)
+    bool UUIDFactory::tryUUIDFromString(std::string_view s, UUID& uuid)
     {
-        uint64_t value = 0;
-        std::stringstream ss;
-        ss << std::hex << hex;
-        ss >> value;
-        return value;
+        char hex[32];
+        if (s.size() == kStringLength) {
+            if (s[8] != '-' || s[13] != '-' || s[18] != '-' || s[23] != '-')
+                return false;
+
+            s.copy(hex, 8, 0);
+            s.copy(hex + 8, 4, 9);
+            s.copy(hex + 12, 4, 14);
+            s.copy(hex + 16, 4, 19);
+            s.copy(hex + 20, 12, 24);
+        }
+        else if (s.size() == 32) {
+            s.copy(hex, 32, 0);
+        }
+        else {
+            return false;
+        }
+
+        uint8_t error = 0;
+        const uint64_t high = DecodeHex16(hex, error);
+        const uint64_t low = DecodeHex16(hex + 16, error);
+        if (error & 0xF0)
+            return false;
+
+        uuid.high = high;
+        uuid.low = low;
+        return true;
     }
 
-    UUID UUIDFactory::uuidFromString(const std::string& s)
+    UUID UUIDFactory::uuidFromString(std::string_view s)
     {
-        std::string hex = removeHyphens(s);
-        if (hex.size() != 32)
+        UUID uuid;
+        if (!tryUUIDFromString(s, uuid))
         {
             throw std::runtime_error("Invalid UUID string");
         }
-
-        UUID uuid;
-        uuid.high = hexToUint64(hex.substr(0, 16));
-        uuid.low = hexToUint64(hex.substr(16, 16));
         return uuid;
     }
-}
\ No newline at end of file
+}
@@ -2,11 +2,14 @@
 #include <stdint.h>
 #include <string>
 #include <memory>
-#include <random>
-#include <sstream>
 #include <string_view>
 #include <functional>
 #include <filesystem>
+#include <format>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
 
 #define WILEY_GEN_UUID UUIDFactory::generateUUID()
 #define WILEY_INVALID_UUID UUIDFactory::InvalidUUID()
@@ -35,14 +38,65 @@ namespace Wiley {
 		}
 	};
 
+	/// <summary>
+	///		Full 64x64->128 multiply folded back to 64 bits. Every input bit affects every output bit, which a plain xor of the halves does not.
+	/// </summary>
+	inline uint64_t MulFold64(uint64_t a, uint64_t b)
+	{
+#if defined(_MSC_VER) && defined(_M_X64)
+		uint64_t high;
+		const uint64_t low = _umul128(a, b, &high);
+		return low ^ high;
+#elif defined(__SIZEOF_INT128__)
+		const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+		return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+		const uint64_t aLow = a & 0xFFFFFFFFULL, aHigh = a >> 32;
+		const uint64_t bLow = b & 0xFFFFFFFFULL, bHigh = b >> 32;
+		const uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh, highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+		const uint64_t cross = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFULL) + highLow;
+		return ((cross << 32) | (lowLow & 0xFFFFFFFFULL)) ^ (highHigh + (lowHigh >> 32) + (cross >> 32));
+#endif
+	}
+
+	inline uint64_t HashUUID(const UUID& uuid)
+	{
+		return MulFold64(uuid.high ^ 0x9E3779B97F4A7C15ULL, uuid.low ^ 0xD1B54A32D192ED03ULL);
+	}
+
+	enum class UUIDVersion {
+		V4, //122 random bits
+		V7  //48 bit unix millisecond timestamp followed by 74 random bits, so ids sort roughly by creation time
+	};
+
+	/// <summary>
+	///		UUIDs come from a per-thread xoshiro256** generator seeded once per thread, so generating one is a few arithmetic ops.
+	///		Strings use the canonical 8-4-4-4-12 lowercase form and are encoded and decoded without stringstreams.
+	/// </summary>
 	class UUIDFactory
 	{
 		public:
-			static UUID generateUUID();
+			static constexpr size_t kStringLength = 36;
+
+			static UUID generateUUID(UUIDVersion version = UUIDVersion::V4);
 			static UUID InvalidUUID() { return invalid; }
 
 			static std::string uuidToString(const UUID& uuid);
-			static UUID uuidFromString(const std::string& s);
+
+			/// <summary>
+			///		Writes the kStringLength characters of the canonical form to out. No null terminator is written.
+			/// </summary>
+			static void uuidToChars(const UUID& uuid, char* out);
+
+			/// <summary>
+			///		Throws std::runtime_error if s is not a valid UUID string.
+			/// </summary>
+			static UUID uuidFromString(std::string_view s);
+
+			/// <summary>
+			///		Accepts the canonical form or 32 hex digits without hyphens, in either case.
+			/// </summary>
+			static bool tryUUIDFromString(std::string_view s, UUID& uuid);
 		private:
 			static UUID invalid;
 	};
@@ -54,7 +108,24 @@ namespace std
 	{
 		std::size_t operator()(const Wiley::UUID& uuid) const noexcept
 		{
-			return std::hash<uint64_t>{}(uuid.high) ^ (std::hash<uint64_t>{}(uuid.low) << 1);
+			return static_cast<std::size_t>(Wiley::HashUUID(uuid));
+		}
+	};
+
+	template<>
+	struct formatter<Wiley::UUID, char>
+	{
+		constexpr auto parse(format_parse_context& ctx)
+		{
+			return ctx.begin();
+		}
+
+		template<typename FormatContext>
+		auto format(const Wiley::UUID& uuid, FormatContext& ctx) const
+		{
+			char buffer[Wiley::UUIDFactory::kStringLength];
+			Wiley::UUIDFactory::uuidToChars(uuid, buffer);
+			return std::copy(std::begin(buffer), std::end(buffer), ctx.out());
 		}
 	};
 }
@@ -0,0 +1,139 @@
+#include "VirtualMemory.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Wiley
+{
+	static size_t RoundUpToPage(size_t bytes)
+	{
+		const size_t pageSize = VirtualMemoryRange::GetPageSize();
+		return (bytes + pageSize - 1) / pageSize * pageSize;
+	}
+
+	VirtualMemoryRange::~VirtualMemoryRange()
+	{
+		Release();
+	}
+
+	size_t VirtualMemoryRange::GetPageSize()
+	{
+		static const size_t pageSize = []() {
+#ifdef _WIN32
+			SYSTEM_INFO info{};
+			GetSystemInfo(&info);
+			return static_cast<size_t>(info.dwPageSize);
+#else
+			return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+		}();
+		return pageSize;
+	}
+
+	bool VirtualMemoryRange::Reserve(size_t bytes, bool useHugePages)
+	{
+		if (basePtr)
+		{
+			std::cout << "Attempting to reserve an already reserved memory range." << std::endl;
+			return false;
+		}
+
+		bytes = RoundUpToPage(bytes);
+
+#ifdef _WIN32
+		//Large pages on Windows need SeLockMemoryPrivilege and must be committed up front, so the hint is ignored here.
+		(void)useHugePages;
+		basePtr = VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS);
+#else
+		void* ptr = mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		basePtr = (ptr == MAP_FAILED) ? nullptr : ptr;
+#ifdef MADV_HUGEPAGE
+		if (basePtr && useHugePages)
+			madvise(basePtr, bytes, MADV_HUGEPAGE);
+#endif
+#endif
+
+		if (!basePtr)
+		{
+			std::cout << "Failed to reserve " << bytes << " bytes of address space." << std::endl;
+			return false;
+		}
+
+		reservedSize = bytes;
+		committedSize = 0;
+		return true;
+	}
+
+	bool VirtualMemoryRange::Commit(size_t bytes)
+	{
+		bytes = RoundUpToPage(bytes);
+		if (bytes <= committedSize)
+			return true;
+
+		if (bytes > reservedSize)
+		{
+			std::cout << "Attempting to commit past the reserved memory range." << std::endl;
+			return false;
+		}
+
+		void* begin = static_cast<char*>(basePtr) + committedSize;
+		const size_t size = bytes - committedSize;
+
+#ifdef _WIN32
+		const bool succeeded = VirtualAlloc(begin, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+		const bool succeeded = mprotect(begin, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+
+		if (!succeeded)
+		{
+			std::cout << "Failed to commit memory." << std::endl;
+			return false;
+		}
+
+		committedSize = bytes;
+		return true;
+	}
+
+	void VirtualMemoryRange::Decommit(size_t bytes)
+	{
+		bytes = RoundUpToPage(bytes);
+		if (bytes >= committedSize)
+			return;
+
+		void* begin = static_cast<char*>(basePtr) + bytes;
+		const size_t size = committedSize - bytes;
+
+#ifdef _WIN32
+		VirtualFree(begin, size, MEM_DECOMMIT);
+#else
+		madvise(begin, size, MADV_DONTNEED);
+		mprotect(begin, size, PROT_NONE);
+#endif
+
+		committedSize = bytes;
+	}
+
+	void VirtualMemoryRange::Release()
+	{
+		if (!basePtr)
+			return;
+
+#ifdef _WIN32
+		VirtualFree(basePtr, 0, MEM_RELEASE);
+#else
+		munmap(basePtr, reservedSize);
+#endif
+
+		basePtr = nullptr;
+		reservedSize = 0;
+		committedSize = 0;
+	}
+
+}
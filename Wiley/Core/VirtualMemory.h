@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Wiley {
+
+	/// <summary>
+	///		A range of address space reserved once and committed from the front on demand.
+	///		The base pointer never changes, so pointers into the committed part stay valid while it grows.
+	///		Uses VirtualAlloc on Windows and mmap/mprotect/madvise elsewhere.
+	/// </summary>
+	class VirtualMemoryRange
+	{
+	public:
+		VirtualMemoryRange() = default;
+		~VirtualMemoryRange();
+
+		VirtualMemoryRange(const VirtualMemoryRange&) = delete;
+		VirtualMemoryRange& operator=(const VirtualMemoryRange&) = delete;
+
+		/// <summary>
+		///		Reserves address space without committing any of it. useHugePages asks the OS to back it with
+		///		transparent huge pages where that is supported and is ignored otherwise.
+		/// </summary>
+		bool Reserve(size_t bytes, bool useHugePages = false);
+
+		/// <summary>
+		///		Makes sure the first bytes of the range are committed. Rounded up to whole pages.
+		/// </summary>
+		bool Commit(size_t bytes);
+
+		/// <summary>
+		///		Returns every committed page past the first bytes to the OS. Their contents are lost.
+		/// </summary>
+		void Decommit(size_t bytes);
+
+		void Release();
+
+		void* GetBasePtr()const { return basePtr; }
+		size_t GetReservedSize()const { return reservedSize; }
+		size_t GetCommittedSize()const { return committedSize; }
+
+		static size_t GetPageSize();
+
+	private:
+		void* basePtr = nullptr;
+		size_t reservedSize = 0;
+		size_t committedSize = 0;
+	};
+
+}
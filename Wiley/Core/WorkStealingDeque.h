@@ -0,0 +1,150 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+namespace Wiley {
+
+	/// <summary>
+	///		Lock-free single-owner/multi-thief deque (Chase-Lev).
+	///		Only the owning worker may call Push/Pop, which work on the bottom end in LIFO order.
+	///		Any thread may call Steal, which takes from the top end in FIFO order.
+	///		Old rings are kept alive until the deque is destroyed so a thief can never read freed memory after a grow.
+	/// </summary>
+	/// <typeparam name="T">Must be a pointer type. nullptr is used to signal an empty deque or a lost race.</typeparam>
+	template<typename T>
+	class WorkStealingDeque
+	{
+		static_assert(std::is_pointer_v<T>, "WorkStealingDeque only stores pointers.");
+
+		struct Ring
+		{
+			explicit Ring(int64_t capacity)
+				:capacity(capacity), mask(capacity - 1), slots(new std::atomic<T>[capacity])
+			{
+			}
+
+			T Load(int64_t index)const {
+				return slots[index & mask].load(std::memory_order_relaxed);
+			}
+
+			void Store(int64_t index, T item) {
+				slots[index & mask].store(item, std::memory_order_relaxed);
+			}
+
+			Ring* Grow(int64_t top, int64_t bottom)const {
+				Ring* ring = new Ring(capacity * 2);
+				for (int64_t i = top; i < bottom; i++)
+					ring->Store(i, Load(i));
+				return ring;
+			}
+
+			int64_t capacity;
+			int64_t mask;
+			std::unique_ptr<std::atomic<T>[]> slots;
+		};
+
+	public:
+		/// <param name="capacity">Initial capacity. Rounded up to a power of two.</param>
+		explicit WorkStealingDeque(int64_t capacity = 1024)
+		{
+			int64_t powerOfTwo = 1;
+			while (powerOfTwo < capacity)
+				powerOfTwo <<= 1;
+
+			Ring* first = new Ring(powerOfTwo);
+			rings.emplace_back(first);
+			ring.store(first, std::memory_order_relaxed);
+		}
+
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+		/// <summary>
+		///		Owner only.
+		/// </summary>
+		void Push(T item)
+		{
+			int64_t b = bottom.load(std::memory_order_relaxed);
+			int64_t t = top.load(std::memory_order_acquire);
+			Ring* r = ring.load(std::memory_order_relaxed);
+
+			if (b - t > r->capacity - 1) {
+				r = r->Grow(t, b);
+				rings.emplace_back(r);
+				ring.store(r, std::memory_order_release);
+			}
+
+			r->Store(b, item);
+			bottom.store(b + 1, std::memory_order_release);
+		}
+
+		/// <summary>
+		///		Owner only. Returns nullptr when empty.
+		/// </summary>
+		T Pop()
+		{
+			int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+			Ring* r = ring.load(std::memory_order_relaxed);
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t t = top.load(std::memory_order_relaxed);
+
+			if (t > b) {
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T item = r->Load(b);
+			if (t == b) {
+				//Last element. Race any thief for it.
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					item = nullptr;
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return item;
+		}
+
+		/// <summary>
+		///		Any thread. Returns nullptr when empty or when another thread won the race.
+		/// </summary>
+		T Steal()
+		{
+			int64_t t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t b = bottom.load(std::memory_order_acquire);
+
+			if (t >= b)
+				return nullptr;
+
+			Ring* r = ring.load(std::memory_order_acquire);
+			T item = r->Load(t);
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+			return item;
+		}
+
+		/// <summary>
+		///		Approximate number of queued items. Only exact when called by the owner with no thieves active.
+		/// </summary>
+		size_t Size()const
+		{
+			int64_t b = bottom.load(std::memory_order_relaxed);
+			int64_t t = top.load(std::memory_order_relaxed);
+			return static_cast<size_t>(b > t ? b - t : 0);
+		}
+
+		bool Empty()const { return Size() == 0; }
+
+	private:
+		alignas(64) std::atomic<int64_t> top{ 0 };
+		alignas(64) std::atomic<int64_t> bottom{ 0 };
+		alignas(64) std::atomic<Ring*> ring{ nullptr };
+
+		//Owner only. Retired rings stay alive for late thieves.
+		std::vector<std::unique_ptr<Ring>> rings;
+	};
+
+}
@@ -62,12 +62,15 @@ namespace Wiley
 			auto& transform = component;
 
 			if (ImGui::DragFloat3("Position", &transform.position.x, 0.5f, 0.0f, 0.0f, "%.3f", ImGuiSliderFlags_ColorMarkers)){
+				transform.MarkDirty();
 				smm->MakeAllLightEntityDirty();
 			}
 			if (ImGui::DragFloat3("Rotation", &transform.rotation.x, 0.5f, 0.0f, 0.0f, "%.3f", ImGuiSliderFlags_ColorMarkers)) {
+				transform.MarkDirty();
 				smm->MakeAllLightEntityDirty();
 			}
 			if (ImGui::DragFloat3("Scale", &transform.scale.x, 0.5f, 0.0f, 0.0f, "%.3f", ImGuiSliderFlags_ColorMarkers)) {
+				transform.MarkDirty();
 				smm->MakeAllLightEntityDirty();
 			}
 		});
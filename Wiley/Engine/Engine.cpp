@@ -5,9 +5,11 @@ namespace Wiley {
 	Engine::Engine(Window::Ref window)
 		:window(window), isEditorVisible(true)
 	{
-		ZoneScopedN("Engine::Engine");
+		TraceZoneN("Engine::Engine");
 
 		gThreadPool.Initialize();
+		gIOService.Initialize();
+		gFrameAllocator.Initialize(FRAMES_IN_FLIGHT);
 		rctx = std::make_shared<RHI::RenderContext>(window);
 		renderer = std::make_shared<Renderer3D::Renderer>(window, rctx);
 
@@ -33,11 +35,14 @@ namespace Wiley {
 		gInput.GetInputEvent().windowResizeEvent.AddMember(&Scene::OnResize, *scene.get());
 
 		gInput.GetInputEvent().middleMouseEvent.AddMember(&Camera::Zoom, *scene->GetCamera().get());
+
+		lastFrameTime = CPUTimer::HRClock::now();
 	}
 
 	Engine::~Engine()
 	{
-        gThreadPool.~ThreadPool();
+        gIOService.Shutdown();
+        gThreadPool.Shutdown();
         scene.reset();
         renderer.reset();
         rctx.reset();
@@ -45,24 +50,47 @@ namespace Wiley {
 
 	void Engine::OnUpdate()
 	{
-		ZoneScopedN("Engine::OnUpdate");
+		TraceZoneN("Engine::OnUpdate");
 
         {
             std::lock_guard<std::mutex> lock(gInput.GetMutex());
             gInput.Tick();
         }	
-        
-		scene->OnUpdate();
 
-		renderer->NewFrame(scene);
-		renderer->RenderFrame();
+        gThreadPool.SampleStats();
+        gMemoryTracker.PlotToTracy();
+        gCPUProfiler.EndFrame();
+
+        //Clamped so a stall (breakpoint, window drag) does not turn into one huge simulation step.
+        constexpr float kMaxFrameDelta = 0.1f;
+        const auto now = CPUTimer::HRClock::now();
+        const float dt = std::min(std::chrono::duration<float>(now - lastFrameTime).count(), kMaxFrameDelta);
+        lastFrameTime = now;
+
+        WILEY_CPU_SCOPE("Frame");
+
+        {
+            WILEY_CPU_SCOPE("Scene");
+            scene->OnUpdate(dt);
+        }
 
-		//Crashes RenderDoc and PIX on launch
-		editor->Run();
+        {
+            WILEY_CPU_SCOPE("Render");
+            renderer->NewFrame(scene);
+            renderer->RenderFrame();
+        }
 
-		renderer->EndFrame();
-		renderer->RenderToWindowDirect();
+        {
+            WILEY_CPU_SCOPE("Editor");
+            //Crashes RenderDoc and PIX on launch
+            editor->Run();
+        }
 
+        {
+            WILEY_CPU_SCOPE("Present");
+            renderer->EndFrame();
+            renderer->RenderToWindowDirect();
+        }
 	}
 
 
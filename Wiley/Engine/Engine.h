@@ -1,5 +1,9 @@
 #pragma once
 #include "../Core/ThreadPool.h"
+#include "../Core/IOService.h"
+#include "../Core/FrameAllocator.h"
+#include "../Core/MemoryTracker.h"
+#include "../Core/Timer.h"
 #include "../Core/Window.h"
 
 #include "../RHI/RenderContext.h"
@@ -14,7 +18,7 @@
 #include "../Scene/Component.h"
 #include "../Editor/Editor.h"
 
-#include "Tracy/tracy/Tracy.hpp"
+#include "../Core/TracyWrapper.h"
 
 
 namespace Wiley {
@@ -41,6 +45,8 @@ namespace Wiley {
 
 			Editor::Ref editor;
 			bool isEditorVisible;
+
+			CPUTimer::HRClock::time_point lastFrameTime;
 			
 	};
 
@@ -1,5 +1,5 @@
 #include "CommandList.h"
-#include "Tracy/tracy/Tracy.hpp"
+#include "../Core/TracyWrapper.h"
 
 namespace RHI
 {
@@ -57,7 +57,7 @@ namespace RHI
 
 	void CommandList::Begin(const std::vector<DescriptorHeap::Ref>& heap)
 	{
-		ZoneScopedN("CommandList::Begin");
+		TraceZoneN("CommandList::Begin");
 
 		commandAllocator->Reset();
 		commandList->Reset(commandAllocator.Get(), nullptr);
@@ -72,7 +72,7 @@ namespace RHI
 
 	void CommandList::End()
 	{
-		ZoneScopedN("CommandList::End");
+		TraceZoneN("CommandList::End");
 
 		commandList->Close();
 	}
@@ -591,4 +591,9 @@ namespace RHI
 
 		commandList->CopyBufferRegion(dstBuffer->GetResource(), 0, srcBuffer->GetResource(), srcOffset, finalBytes);
 	}
+
+	void CommandList::CopyBufferRegion(Buffer::Ref srcBuffer, UINT64 srcOffset, Buffer::Ref dstBuffer, UINT64 dstOffset, UINT64 numBytes)
+	{
+		commandList->CopyBufferRegion(dstBuffer->GetResource(), dstOffset, srcBuffer->GetResource(), srcOffset, numBytes);
+	}
 }
\ No newline at end of file
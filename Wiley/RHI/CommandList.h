@@ -129,6 +129,11 @@ namespace RHI
 		/// <param name="dstBuffer">Reference to the destination buffer to write to.</param>
 		/// <param name="numBytes">Number of bytes to copy (UINT64). numBytes = 0 uses the copies the entire size of the dst buffer</param>
 		void CopyBufferToBuffer(Buffer::Ref srcBuffer, UINT srcOffset, Buffer::Ref dstBuffer, UINT64 numBytes, bool align = true);
+
+		/// <summary>
+		/// Copies numBytes from srcOffset in srcBuffer to dstOffset in dstBuffer. No alignment or size fix-up is applied.
+		/// </summary>
+		void CopyBufferRegion(Buffer::Ref srcBuffer, UINT64 srcOffset, Buffer::Ref dstBuffer, UINT64 dstOffset, UINT64 numBytes);
 		
 	private:
 		ComPtr<ID3D12GraphicsCommandList> commandList;
@@ -1,6 +1,6 @@
 #include "CommandQueue.h"
 #include "Fence.h"
-#include "Tracy/tracy/Tracy.hpp"
+#include "../Core/TracyWrapper.h"
 
 namespace RHI
 {
@@ -30,7 +30,7 @@ namespace RHI
 
 	void RHI::CommandQueue::Submit(const std::vector<CommandList::Ref>& commandLists)
 	{
-		ZoneScopedN("CommandQueue::Submit");
+		TraceZoneN("CommandQueue::Submit");
 
 		std::vector<ID3D12CommandList*> pCmdLists(commandLists.size());
 		int i = 0;
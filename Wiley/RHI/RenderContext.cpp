@@ -1,13 +1,14 @@
 #include "RenderContext.h"
 #include "DDSTextureLoader.h"
 #include "../Resource/ResourceCache.h"
+#include "../Core/FrameAllocator.h"
 
 namespace RHI
 {
     RenderContext::RenderContext(Wiley::Window::Ref window)
         :window(window)
     {
-        ZoneScopedN("RenderContext::RenderContext");
+        TraceZoneN("RenderContext::RenderContext");
 
         device = Device::CreateDevice();
 
@@ -114,7 +115,7 @@ namespace RHI
 
     void RenderContext::Resize(uint32_t width, uint32_t height)
     {
-        ZoneScopedN("RenderContext::Resize");
+        TraceZoneN("RenderContext::Resize");
 
         WaitForGPU();
 
@@ -139,6 +140,9 @@ namespace RHI
         frameIndex = swapChain->AcquireImage();
 
         gfxFence[frameIndex]->BlockCPU();
+
+        //The GPU is done with this slot, so its scratch memory can be reused.
+        Wiley::gFrameAllocator.BeginFrame(frameIndex);
     }
 
     WILEY_NODISCARD IndirectCommandBuffer::Ref RenderContext::CreateIndirectCommandBuffer(IndirectCommandBufferDesc indirectCommandBufferDesc, const std::string& name)
@@ -500,7 +504,7 @@ namespace RHI
 
     void RenderContext::ExecuteGraphicsCommandList(const std::vector<CommandList::Ref> list)
     {
-        ZoneScopedN("RenderContext::ExecuteGraphicsCommandList");
+        TraceZoneN("RenderContext::ExecuteGraphicsCommandList");
 
         gfxCommandQueue->Submit(list);
     }
@@ -17,7 +17,7 @@
 
 #include "../Core/Window.h"
 
-#include "Tracy/tracy/Tracy.hpp"
+#include "../Core/TracyWrapper.h"
 
 
 namespace RHI
@@ -58,7 +58,7 @@ namespace RHI
 		WILEY_NODISCARD Buffer::Ref CreateComputeStorageBuffer(uint64_t size, uint64_t stride, const std::string& name = "ComputeStorageBuffer");
 
 		template<typename T>
-		WILEY_NODISCARD UploadBuffer<T>::Ref CreateUploadBuffer(size_t size, uint32_t stride, const std::string& name);
+		WILEY_NODISCARD UploadBuffer<T>::Ref CreateUploadBuffer(size_t size, uint32_t stride, const std::string& name, Wiley::MemoryTag tag = Wiley::MemoryTag::General);
 
 		WILEY_NODISCARD Buffer::Ref CreateVertexBuffer(uint64_t size, uint64_t stride, const std::string& name = "VertexBuffer");
 		WILEY_NODISCARD Buffer::Ref CreateIndexBuffer(uint64_t size, uint64_t stride, const std::string& name = "IndexBuffer");
@@ -153,9 +153,9 @@ namespace RHI
 	};
 
 	template<typename T>
-	WILEY_NODISCARD UploadBuffer<T>::Ref RenderContext::CreateUploadBuffer(size_t size, uint32_t stride, const std::string& name)
+	WILEY_NODISCARD UploadBuffer<T>::Ref RenderContext::CreateUploadBuffer(size_t size, uint32_t stride, const std::string& name, Wiley::MemoryTag tag)
 	{
-		return std::make_shared<UploadBuffer<T>>(device, size, stride, name);
+		return std::make_shared<UploadBuffer<T>>(device, size, stride, name, tag);
 	}
 }
 
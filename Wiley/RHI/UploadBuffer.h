@@ -4,6 +4,7 @@
 #include "Buffer.h"
 
 #include "../Core/Allocator.h"
+#include "../Core/DirtyRangeTracker.h"
 
 #include <memory>
 
@@ -13,6 +14,8 @@ namespace RHI
 	/// <summary>
 	///		This is a convience class around an RHI::Buffer and a LinearAllocator to allow for easy use of a CPU & GPU visible memory as a managed memory pool.
 	///		The LinearAllocator owned by this class does not allocate any memory but only manages the memory from the Mapped resource Pointer.
+	///		The committed size is reported to the MemoryTracker as reserved memory and the allocator reports its blocks under the same tag.
+	///		Writers mark the elements they change so the copy to the GPU-side buffer can be limited to the dirty byte ranges.
 	/// </summary>
 	/// <typeparam name="T">
 	///		T: the data type to be stored in this pool. The sizeof(T) defines the size of one block in this pool.
@@ -28,7 +31,7 @@ namespace RHI
 			/// <summary>
 			///		Calls the constructor of RHI::Buffer with some fixed parameters to create and CPU & GPU visible memory pool.
 			/// </summary>
-			UploadBuffer(Device::Ref device, size_t size, uint32_t stride, const std::string name);
+			UploadBuffer(Device::Ref device, size_t size, uint32_t stride, const std::string name, Wiley::MemoryTag tag = Wiley::MemoryTag::General);
 			~UploadBuffer();
 
 			/// <summary>
@@ -57,28 +60,49 @@ namespace RHI
 			T* GetPointerByIndex(uint32_t index);
 			uint32_t GetIndexOffBasePointer(Wiley::MemoryBlock<T> memBlk);
 
+			/// <summary>
+			///		Marks elements [index, index + count) as written. Safe to call from several threads at once.
+			///		Allocate marks the new block itself.
+			/// </summary>
+			void MarkDirty(uint32_t index, uint32_t count = 1);
+			void MarkAllDirty();
+			bool HasDirtyRanges()const { return dirtyRanges.IsDirty(); }
+			Wiley::DirtyRangeTracker& GetDirtyRangeTracker() { return dirtyRanges; }
+
+			/// <summary>
+			///		Appends the coalesced byte ranges written since the last call, offsets relative to the buffer start, and clears them.
+			///		Returns the total number of bytes appended.
+			/// </summary>
+			uint64_t ConsumeDirtyRanges(std::vector<Wiley::DirtyRange>& ranges, size_t mergeGap = Wiley::DirtyRangeTracker::kDefaultMergeGap);
+
 		private:
 			std::shared_ptr<Wiley::LinearAllocator<T>> memoryManager;
+			Wiley::DirtyRangeTracker dirtyRanges;
+			Wiley::MemoryTag tag;
 	};
 
 	template<typename T>
-	UploadBuffer<T>::UploadBuffer(Device::Ref device, size_t size, uint32_t stride, const std::string name)
-		:Buffer(device, BufferUsage::Copy, true, size, stride, name, nullptr)
+	UploadBuffer<T>::UploadBuffer(Device::Ref device, size_t size, uint32_t stride, const std::string name, Wiley::MemoryTag tag)
+		:Buffer(device, BufferUsage::Copy, true, size, stride, name, nullptr), tag(tag)
 	{
 		UINT8* bufferPtr = nullptr;
 		Map(reinterpret_cast<void**>(&bufferPtr), 0, 0);
-		memoryManager = std::make_shared<Wiley::LinearAllocator<T>>(size / stride, bufferPtr);
+		memoryManager = std::make_shared<Wiley::LinearAllocator<T>>(size / stride, bufferPtr, tag);
+		dirtyRanges.Resize(size / stride);
+		Wiley::gMemoryTracker.RecordReserve(tag, size);
 	}
 
 	template<typename T>
 	UploadBuffer<T>::~UploadBuffer()
 	{
+		Wiley::gMemoryTracker.RecordRelease(tag, size);
 		Unmap(0, 0);
 	}
 
 	template<typename T>
 	void UploadBuffer<T>::ResizeUploadBuffer(size_t newSize)
 	{
+		Wiley::gMemoryTracker.RecordRelease(tag, size);
 		Unmap(0, 0);
 		Resize(newSize);
 
@@ -86,13 +110,17 @@ namespace RHI
 
 		UINT8* bufferPtr = nullptr;
 		Map(reinterpret_cast<void**>(&bufferPtr), 0, 0);
-		memoryManager = std::make_shared<Wiley::LinearAllocator<T>>(size / stride, bufferPtr);
+		memoryManager = std::make_shared<Wiley::LinearAllocator<T>>(size / stride, bufferPtr, tag);
+		dirtyRanges.Resize(size / stride);
+		Wiley::gMemoryTracker.RecordReserve(tag, size);
 	}
 
 	template<typename T>
 	Wiley::MemoryBlock<T> UploadBuffer<T>::Allocate(int nElement)
 	{
-		return memoryManager->Allocate(nElement);
+		Wiley::MemoryBlock<T> memBlk = memoryManager->Allocate(nElement);
+		dirtyRanges.MarkDirty(static_cast<size_t>(memBlk.data() - GetBasePointer()), memBlk.size());
+		return memBlk;
 	}
 
 	template<typename T>
@@ -149,4 +177,22 @@ namespace RHI
 		return memoryManager->GetIndex(memBlk);
 	}
 
+	template<typename T>
+	inline void UploadBuffer<T>::MarkDirty(uint32_t index, uint32_t count)
+	{
+		dirtyRanges.MarkDirty(index, count);
+	}
+
+	template<typename T>
+	inline void UploadBuffer<T>::MarkAllDirty()
+	{
+		dirtyRanges.MarkDirty(0, GetMemoryReach() / sizeof(T));
+	}
+
+	template<typename T>
+	inline uint64_t UploadBuffer<T>::ConsumeDirtyRanges(std::vector<Wiley::DirtyRange>& ranges, size_t mergeGap)
+	{
+		return dirtyRanges.Consume(ranges, sizeof(T), mergeGap);
+	}
+
 }
@@ -11,8 +11,9 @@ namespace Renderer3D
     
     ResourceHandle FrameGraph::CreateTextureResource(const std::string& name, const TextureResourceDesc& resourceDesc, RHI::TextureUsage usage, bool isScreenSizeDependent)
     {
-        if (strDesc.find(name) != strDesc.end())
-            return { (uint32_t)strDesc[name] };
+        const Wiley::StringId id(name);
+        if (auto it = strDesc.find(id); it != strDesc.end())
+            return { it->second };
 
         auto resource = rctx->CreateTexture(resourceDesc.format, resourceDesc.width,
             resourceDesc.height, resourceDesc.usage, name);
@@ -31,13 +32,14 @@ namespace Renderer3D
             .creationState = resourceDesc.usage
         };
 
-        strDesc[name] = index;
+        strDesc[id] = index;
         return handle;
     }
 
     ResourceHandle FrameGraph::CreateBufferResource(const std::string& name,const BufferResourceDesc& resourceDesc, RHI::BufferUsage usage) {
-        if (strDesc.find(name) != strDesc.end())
-            return { (uint32_t)strDesc[name] };
+        const Wiley::StringId id(name);
+        if (auto it = strDesc.find(id); it != strDesc.end())
+            return { it->second };
 
         auto resource = std::make_shared<RHI::Buffer>(rctx->GetDevice(), resourceDesc.usage,
             resourceDesc.persistent, resourceDesc.size, resourceDesc.stride, name, rctx->GetDescriptorHeaps().cbv_srv_uav);
@@ -55,14 +57,15 @@ namespace Renderer3D
             .creationState = resourceDesc.usage
         };
 
-        strDesc[name] = index;
+        strDesc[id] = index;
         return handle;
     }
 
     ResourceHandle FrameGraph::ImportTextureResource(const std::string& name, RHI::Texture::Ref texture, RHI::TextureUsage usage)
     {
-        if (strDesc.find(name) != strDesc.end())
-            return { (uint32_t)strDesc[name],usage };
+        const Wiley::StringId id(name);
+        if (auto it = strDesc.find(id); it != strDesc.end())
+            return { it->second, usage };
 
         uint32_t index = resources.size();
         RenderPassResource passResource = {
@@ -76,14 +79,15 @@ namespace Renderer3D
             .usage = usage
         };
 
-        strDesc[name] = index;
+        strDesc[id] = index;
         return handle;
     }
 
     ResourceHandle FrameGraph::ImportBufferResource(const std::string& name, RHI::Buffer::Ref buffer, RHI::BufferUsage usage)
     {
-        if (strDesc.find(name) != strDesc.end())
-            return { (uint32_t)strDesc[name], usage };
+        const Wiley::StringId id(name);
+        if (auto it = strDesc.find(id); it != strDesc.end())
+            return { it->second, usage };
 
         uint32_t index = resources.size();
         RenderPassResource passResource = {
@@ -97,82 +101,79 @@ namespace Renderer3D
            .usage = usage
         };
 
-        strDesc[name] = index;
+        strDesc[id] = index;
         return handle;
 
     }
 
-    ResourceHandle FrameGraph::ReadTextureResource(const std::string& name, RHI::TextureUsage usage)
+    ResourceHandle FrameGraph::ReadTextureResource(Wiley::StringId name, RHI::TextureUsage usage)
     {
-        if (strDesc.find(name) != strDesc.end())
+        if (auto it = strDesc.find(name); it != strDesc.end())
         {
-            auto id = strDesc[name];
+            const uint32_t id = it->second;
             if (resources[id].type != PassResourceType::Texture) {
                 std::cout << "Attempting to Read non texture resource in texture pipeline." << std::endl;
                 return {};
             }
-            return { (uint32_t)id ,usage };
+            return { id, usage };
         }
 
-        std::cout << "Failed to find read to buffer resource. Name :: " << name << std::endl;
+        std::cout << "Failed to find read to buffer resource. Name :: " << name.ToString() << std::endl;
         return {};
     }
 
-    ResourceHandle FrameGraph::ReadBufferResource(const std::string& name, RHI::BufferUsage usage)
+    ResourceHandle FrameGraph::ReadBufferResource(Wiley::StringId name, RHI::BufferUsage usage)
     {
-        if (strDesc.find(name) != strDesc.end())
+        if (auto it = strDesc.find(name); it != strDesc.end())
         {
-            auto id = strDesc[name];
+            const uint32_t id = it->second;
             if (resources[id].type != PassResourceType::Buffer) {
                 std::cout << "Attempting to Read non buffer resource in buffer pipeline." << std::endl;
                 return {};
             }
-            return { (uint32_t)id ,usage };
+            return { id, usage };
         }
 
-        std::cout << "Failed to find read to buffer resource. Name :: " << name << std::endl;
+        std::cout << "Failed to find read to buffer resource. Name :: " << name.ToString() << std::endl;
         return {};
     }
 
-    ResourceHandle FrameGraph::WriteTextureResource(const std::string& name, RHI::TextureUsage usage)
+    ResourceHandle FrameGraph::WriteTextureResource(Wiley::StringId name, RHI::TextureUsage usage)
     {
-        if (strDesc.find(name) != strDesc.end())
+        if (auto it = strDesc.find(name); it != strDesc.end())
         {
-            auto id = strDesc[name];
+            const uint32_t id = it->second;
             if (resources[id].type != PassResourceType::Texture) {
                 std::cout << "Attempting to write to a non texture resource in texture pipeline." << std::endl;
                 return {};
             }
-            return { (uint32_t)id,usage };
+            return { id, usage };
         }
 
-        std::cout << "Failed to find write to texture resource. Name :: " << name << std::endl;
+        std::cout << "Failed to find write to texture resource. Name :: " << name.ToString() << std::endl;
         return {};
     }
 
-    ResourceHandle FrameGraph::WriteBufferResource(const std::string& name, RHI::BufferUsage usage)
+    ResourceHandle FrameGraph::WriteBufferResource(Wiley::StringId name, RHI::BufferUsage usage)
     {
-        if (strDesc.find(name) != strDesc.end())
+        if (auto it = strDesc.find(name); it != strDesc.end())
         {
-            auto id = strDesc[name];
+            const uint32_t id = it->second;
             if (resources[id].type != PassResourceType::Buffer) {
                 std::cout << "Attempting to write to a non buffer resource in buffer pipeline." << std::endl;
                 return {};
             }
-            return { (uint32_t)id, usage };
+            return { id, usage };
         }
 
-        std::cout << "Failed to find write to buffer resource. Name :: " << name << std::endl;
+        std::cout << "Failed to find write to buffer resource. Name :: " << name.ToString() << std::endl;
         return {};
     }
 
-    RenderPassResource FrameGraph::GetResource(const std::string& name)
+    RenderPassResource FrameGraph::GetResource(Wiley::StringId name)
     {
-        if (strDesc.find(name) != strDesc.end())
-        {
-            auto id = strDesc[name];
-            return resources[id];
-        }
+        if (auto it = strDesc.find(name); it != strDesc.end())
+            return resources[it->second];
         return {};
     }
 
@@ -332,10 +333,10 @@ namespace Renderer3D
         rctx->GetCurrentCommandList()->ImageBarrier(barriers);
     }
 
-    UINT FrameGraph::GetPassWaitValue(const std::string& name)
+    UINT FrameGraph::GetPassWaitValue(Wiley::StringId passId)
     {
         for (auto& sortedP : sortedPasses)
-            if (sortedP->name == name)
+            if (sortedP->id == passId)
                 return sortedP->waitValue;
         return 0;
     }
@@ -406,7 +407,7 @@ namespace Renderer3D
 
 	void FrameGraph::Execute()const
 	{
-        ZoneScopedN("FrameGraph::Execute");
+        TraceZoneN("FrameGraph::Execute");
 
 		for (auto& pass : sortedPasses)
         {
@@ -415,7 +416,7 @@ namespace Renderer3D
 	}
 
     void FrameGraph::OnResize(std::uint32_t width, std::uint32_t height) {
-        ZoneScopedN("FrameGraph::OnResize");
+        TraceZoneN("FrameGraph::OnResize");
 
         for (auto& screenSizeDeps : resources
             | std::views::filter([&](auto& res) {return res.isScreenSizeDependent; }))
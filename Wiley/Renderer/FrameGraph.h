@@ -7,7 +7,9 @@
 #include "../RHI/RenderContext.h"
 
 #include "sol/sol.hpp"
-#include "Tracy/tracy/Tracy.hpp"
+#include "../Core/TracyWrapper.h"
+#include "../Core/StringId.h"
+#include "../Core/FlatHashMap.h"
 
 #include <memory>
 #include <functional>
@@ -88,6 +90,7 @@ namespace Renderer3D
 	struct RenderPass
 	{
 		std::string name;
+		Wiley::StringId id;
 
 		std::vector<ResourceHandle> inputs;
 		std::vector<ResourceHandle> outputs;
@@ -130,13 +133,13 @@ namespace Renderer3D
 			ResourceHandle ImportTextureResource(const std::string& name, RHI::Texture::Ref texture, RHI::TextureUsage usage);
 			ResourceHandle ImportBufferResource(const std::string& name, RHI::Buffer::Ref buffer, RHI::BufferUsage usage);
 
-			ResourceHandle ReadTextureResource(const std::string& name,RHI::TextureUsage usage);
-			ResourceHandle ReadBufferResource(const std::string& name, RHI::BufferUsage usage);
+			ResourceHandle ReadTextureResource(Wiley::StringId name, RHI::TextureUsage usage);
+			ResourceHandle ReadBufferResource(Wiley::StringId name, RHI::BufferUsage usage);
 
-			ResourceHandle WriteTextureResource(const std::string& name,RHI::TextureUsage usage);
-			ResourceHandle WriteBufferResource(const std::string& name, RHI::BufferUsage usage);
+			ResourceHandle WriteTextureResource(Wiley::StringId name, RHI::TextureUsage usage);
+			ResourceHandle WriteBufferResource(Wiley::StringId name, RHI::BufferUsage usage);
 
-			RenderPassResource GetResource(const std::string& resourceName);
+			RenderPassResource GetResource(Wiley::StringId resourceName);
 
 			//Requires client to manually call std::get<T>(std::variant)
 			RenderPassResource GetResource(const ResourceHandle& handle);
@@ -156,7 +159,7 @@ namespace Renderer3D
 			void TransitionInputTextureToCreationState(RenderPass& pass);
 			void TransitionOutputTextureToCreationState(RenderPass& pass);
 
-			UINT GetPassWaitValue(const std::string& name);
+			UINT GetPassWaitValue(Wiley::StringId passId);
 
 			void AddPass(const RenderPass& pass);
 			void Compile();
@@ -169,8 +172,9 @@ namespace Renderer3D
 			std::vector<RenderPass> passes;
 			std::vector<RenderPass*> sortedPasses;
 
-			std::unordered_map<std::string, uint32_t> strDesc;
-			std::unordered_map<std::string, ResourcePool> poolMap;
+			//Resources are looked up by the hash of their name. Creation and import still take the string to name the GPU object.
+			Wiley::FlatHashMap<Wiley::StringId, uint32_t> strDesc;
+			Wiley::FlatHashMap<Wiley::StringId, ResourcePool> poolMap;
 
 			std::vector<RenderPassResource> resources;
 
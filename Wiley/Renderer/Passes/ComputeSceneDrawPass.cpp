@@ -4,7 +4,7 @@ namespace Renderer3D {
 
 	void Renderer::ComputeSceneDrawPass(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::ComputeSceneDrawPass");
+		TraceZoneN("Renderer::ComputeSceneDrawPass");
 
 		RHI::CommandList::Ref computeCommandList = rctx->GetComputeCommandList();
 		RHI::CommandQueue::Ref computeCommandQueue = rctx->GetComputeQueue();
@@ -14,7 +14,6 @@ namespace Renderer3D {
 		computeCommandList->Begin({ rctx->GetDescriptorHeaps().cbv_srv_uav });
 
 		Wiley::MeshFilterComponent* meshFilterCompPtr = _scene->GetComponentStorage<Wiley::MeshFilterComponent>();
-		UINT meshFilterCompReach = _scene->GetComponentReach<Wiley::MeshFilterComponent>();
 
 		//Get Render Pass Resources...
 		RHI::Buffer::Ref _meshFilterBufferUp = frameGraph->GetOutputBufferResource(pass, 0);
@@ -40,13 +39,47 @@ namespace Renderer3D {
 
 		std::shared_ptr<Wiley::ResourceCache> resourceCache = _scene->GetResourceCache();
 
-		std::vector<uint32_t> meshFilterIndexes;
-		std::vector<Wiley::MeshInstanceBase> meshInstanceBaseData;
+		Wiley::FrameVector<uint32_t> meshFilterIndexes;
+		Wiley::FrameVector<Wiley::MeshInstanceBase> meshInstanceBaseData;
 		auto meshResources = resourceCache->GetResourceOfType<Wiley::Mesh>(Wiley::ResourceType::Mesh);
 
 
+		//Mesh filters outside the camera frustum are left out of the main-view instance lists. The shadow passes get their own
+		//unculled lists, since a caster outside the view can still throw a shadow into it.
 		{
-			ZoneScopedN("MeshInstanceBaseSetup");
+			TraceZoneN("FrustumCulling");
+
+			const Wiley::PackedBounds& meshFilterBounds = _scene->UpdateMeshFilterBounds();
+			const size_t meshFilterCount = meshFilterBounds.GetCount();
+			if (visibleMeshFilters.size() < meshFilterCount)
+				visibleMeshFilters.resize(meshFilterCount);
+
+			const size_t visibleCount = Wiley::CullBounds(_scene->GetCamera()->GetFrustumPlanes(), meshFilterBounds, visibleMeshFilters.data());
+
+			meshFilterVisibility.assign(meshFilterCount, 0);
+			for (size_t i = 0; i < visibleCount; i++)
+				meshFilterVisibility[visibleMeshFilters[i]] = 1;
+
+			TracePlot("VisibleMeshFilters", static_cast<int64_t>(visibleCount));
+		}
+
+		{
+			TraceZoneN("MeshInstanceBaseSetup");
+
+			//Groups [0, meshCount) are the camera-culled lists the main view draws, [meshCount, 2 * meshCount) the full lists for shadows.
+			for (const auto& meshResource : meshResources) {
+				const uint32_t offset = static_cast<uint32_t>(meshFilterIndexes.size());
+				for (uint32_t meshFilterIndex : meshResource->instanceMeshFilterIndex) {
+					if (meshFilterIndex < meshFilterVisibility.size() && meshFilterVisibility[meshFilterIndex])
+						meshFilterIndexes.push_back(meshFilterIndex);
+				}
+
+				Wiley::MeshInstanceBase instanceBase{
+					.offset = offset,
+					.size = static_cast<uint32_t>(meshFilterIndexes.size()) - offset
+				};
+				meshInstanceBaseData.emplace_back(instanceBase);
+			}
 
 			for (const auto& meshResource : meshResources) {
 				Wiley::MeshInstanceBase instanceBase{
@@ -80,19 +113,33 @@ namespace Renderer3D {
 		}
 
 
-		UINT8* meshFilterBufferPtr = nullptr;
+		//Mesh filters and sub-mesh data persist on the GPU between frames, so only the byte ranges written since the last
+		//frame are copied. A static scene uploads nothing here.
+		uint64_t uploadedBytes = 0;
 		{
-			_meshFilterBufferUp->Map(reinterpret_cast<void**>(&meshFilterBufferPtr), 0, 0);
-			_meshFilterBufferUp->UploadPersistent(meshFilterBufferPtr, meshFilterCompPtr, sizeof(Wiley::MeshFilterComponent) * meshFilterCompReach);
-			_meshFilterBufferUp->Unmap(0, 0);
-		}
+			TraceZoneN("DirtyRangeUpload");
+
+			uploadRanges.clear();
+			uploadedBytes += _scene->ConsumeMeshFilterDirtyRanges(uploadRanges);
+			if (!uploadRanges.empty() && meshFilterCompPtr != nullptr)
+			{
+				UINT8* meshFilterBufferPtr = nullptr;
+				_meshFilterBufferUp->Map(reinterpret_cast<void**>(&meshFilterBufferPtr), 0, 0);
+				for (const Wiley::DirtyRange& range : uploadRanges)
+				{
+					_meshFilterBufferUp->UploadPersistent(meshFilterBufferPtr + range.offset, reinterpret_cast<const UINT8*>(meshFilterCompPtr) + range.offset, range.size);
+					computeCommandList->CopyBufferRegion(_meshFilterBufferUp, range.offset, _meshFilterBuffer, range.offset, range.size);
+				}
+				_meshFilterBufferUp->Unmap(0, 0);
+			}
 
-		const auto& subMeshDataUploadBuffer = _scene->GetSubMeshDataUploadBuffer();
-		UINT subMeshDataBufferSize = subMeshDataUploadBuffer->GetMemoryReach();
-		{
-			computeCommandList->CopyBufferToBuffer(_meshFilterBufferUp, 0, _meshFilterBuffer, sizeof(Wiley::MeshFilterComponent) * meshFilterCompReach);
-			computeCommandList->CopyBufferToBuffer(subMeshDataUploadBuffer, 0, subMeshDataBuffer, subMeshDataBufferSize, false);
+			const auto& subMeshDataUploadBuffer = _scene->GetSubMeshDataUploadBuffer();
+			uploadRanges.clear();
+			uploadedBytes += subMeshDataUploadBuffer->ConsumeDirtyRanges(uploadRanges);
+			for (const Wiley::DirtyRange& range : uploadRanges)
+				computeCommandList->CopyBufferRegion(subMeshDataUploadBuffer, range.offset, subMeshDataBuffer, range.offset, range.size);
 		}
+		TracePlot("SceneUploadBytes", static_cast<int64_t>(uploadedBytes));
 
 
 		{
@@ -141,15 +188,18 @@ namespace Renderer3D {
 
 		//Create draw commands
 		{
-			ZoneScopedN("CreateDrawCommands");
+			TraceZoneN("CreateDrawCommands");
 
 			Wiley::MeshInstanceBase* occMeshInstanceBufferPtr = nullptr;
 			readBackMeshInstanceBase->Map(reinterpret_cast<void**>(&occMeshInstanceBufferPtr), 0, 0);
 
+			const size_t meshCount = meshResources.size();
 			drawCommandCache.clear();
-			drawCommandCache.resize(meshInstanceBaseData.size());
+			drawCommandCache.resize(meshCount);
+			shadowDrawCommandCache.clear();
+			shadowDrawCommandCache.resize(meshCount);
 
-			for (int i = 0; i < meshInstanceBaseData.size(); i++) {
+			for (int i = 0; i < meshCount; i++) {
 				Wiley::Mesh* _meshres = meshResources[i].get();
 
 				WILEY_MUSTBE_UINTSIZE(_meshres->instanceMeshFilterIndex.size());
@@ -161,9 +211,14 @@ namespace Renderer3D {
 				drawCmd->drawID = i;
 				drawCmd->indexCount = _meshres->indexCount;
 				drawCmd->indexStartLocation = indexStartLocation;
-				drawCmd->instanceCount = _meshres->instanceMeshFilterIndex.size();
+				drawCmd->instanceCount = meshInstanceBaseData[i].size;
 				drawCmd->vertexStartLocation = vertexStartLocation;
 				drawCmd->instanceStartIndex = 0;
+
+				DrawCommand* shadowDrawCmd = &shadowDrawCommandCache[i];
+				*shadowDrawCmd = *drawCmd;
+				shadowDrawCmd->drawID = static_cast<UINT>(meshCount + i);
+				shadowDrawCmd->instanceCount = meshInstanceBaseData[meshCount + i].size;
 			} 
 
 			readBackMeshInstanceBase->Unmap(0, 0);
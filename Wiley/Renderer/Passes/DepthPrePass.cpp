@@ -4,7 +4,7 @@ namespace Renderer3D {
 
 	void Renderer::DepthPrePass(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::DepthPrePass");
+		TraceZoneN("Renderer::DepthPrePass");
 
 		RHI::GraphicsPipeline::Ref pso = gfxPsoCache[RenderPassSemantic::DepthPrepass];
 
@@ -67,7 +67,7 @@ namespace Renderer3D {
 		}
 
 		{
-			ZoneScopedN("DepthPrepassDrawCmdExec.");
+			TraceZoneN("DepthPrepassDrawCmdExec.");
 
 			DrawCommandsWithIndex(commandList);
 		}
@@ -82,10 +82,10 @@ namespace Renderer3D {
 
 		//Close Graphics List & Begin new one for preceeding passes.
 		{
-			ZoneScopedN("DepthPrepassNewCommandBufferRecording");
+			TraceZoneN("DepthPrepassNewCommandBufferRecording");
 
 			{
-				ZoneScopedN("EndDepthPrepassRec");
+				TraceZoneN("EndDepthPrepassRec");
 
 				commandList->End();
 				rctx->ExecuteGraphicsCommandList({ commandList });
@@ -93,7 +93,7 @@ namespace Renderer3D {
 
 			//Wait till the GPU finishes this early execute before clearing the allocator for the next ones.
 			{
-				ZoneScopedN("DepthPrepassFenceSignal");
+				TraceZoneN("DepthPrepassFenceSignal");
 
 				RHI::Fence::Ref gfxFence = rctx->GetCurrentGraphicsFence();
 				RHI::CommandQueue::Ref commandQueue = rctx->GetCommandQueue();
@@ -106,7 +106,7 @@ namespace Renderer3D {
 			//Start New Record for following passes.
 			//Passes that follow may choose to close the command list early and submit or keep it open to record.
 			{
-				ZoneScopedN("PostDepthPrepassBeginNewCmdListRec");
+				TraceZoneN("PostDepthPrepassBeginNewCmdListRec");
 
 				commandList->Begin({ heaps.cbv_srv_uav,heaps.sampler });
 				commandList->BindVertexBuffer(vertexBuffer[graphicsRingIndex]);
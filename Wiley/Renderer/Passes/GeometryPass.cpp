@@ -4,7 +4,7 @@ namespace Renderer3D {
 
 	void Renderer::GeometryPass(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::GeometryPass");
+		TraceZoneN("Renderer::GeometryPass");
 
 		RHI::GraphicsPipeline::Ref pso = gfxPsoCache[RenderPassSemantic::Geometry];
 
@@ -67,7 +67,7 @@ namespace Renderer3D {
 		}
 
 		{
-			ZoneScopedN("GeometryPassDrawCmdExec.");
+			TraceZoneN("GeometryPassDrawCmdExec.");
 
 			DrawCommandsWithIndex(commandList);
 		}
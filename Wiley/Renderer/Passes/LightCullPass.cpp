@@ -4,7 +4,7 @@ namespace Renderer3D {
 
 	void Renderer::ClusterGeneration(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::ClusterGeneration");
+		TraceZoneN("Renderer::ClusterGeneration");
 
 		if (!camera->IsChanged() || !_scene->IsWindowResize()) {
 #ifdef _DEBUG
@@ -91,7 +91,7 @@ namespace Renderer3D {
 
 	void Renderer::ClusterCullingPass(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::ClusterCullingPass");
+		TraceZoneN("Renderer::ClusterCullingPass");
 
 		RHI::ComputePipeline::Ref pso = computePsoCache[RenderPassSemantic::ClusterCullPass];
 
@@ -101,7 +101,7 @@ namespace Renderer3D {
 		RHI::Fence::Ref graphicsFence = rctx->GetCurrentGraphicsFence();
 
 		{
-			ZoneScopedN("ClusterCullingPassWaitForDepthPrePass");
+			TraceZoneN("ClusterCullingPassWaitForDepthPrePass");
 
 			UINT depthPrepassWaitValue = frameGraph->GetPassWaitValue("DepthPrepass");
 			graphicsFence->GPUWaitForValue(computeCommandQueue.get(), depthPrepassWaitValue);
@@ -180,7 +180,7 @@ namespace Renderer3D {
 
 	void Renderer::CompactClusterPass(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::CompactClusterPass");
+		TraceZoneN("Renderer::CompactClusterPass");
 
 		RHI::ComputePipeline::Ref pso = computePsoCache[RenderPassSemantic::CompactClusterPass];
 
@@ -267,7 +267,7 @@ namespace Renderer3D {
 
 	void Renderer::ClusterAssignmentPass(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::ClusterAssignmentPass");
+		TraceZoneN("Renderer::ClusterAssignmentPass");
 
 		RHI::ComputePipeline::Ref pso = computePsoCache[RenderPassSemantic::ClusterAssignment];
 
@@ -319,7 +319,7 @@ namespace Renderer3D {
 
 		{
 
-			std::vector<LightCullData> lightRadia;
+			Wiley::FrameVector<LightCullData> lightRadia;
 			lightRadia.reserve(lightCompStorSpan.size());
 
 			std::ranges::transform(lightCompStorSpan, std::back_inserter(lightRadia),
@@ -383,7 +383,7 @@ namespace Renderer3D {
 
 	void Renderer::ClusterHeatMapPass(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::ClusterHeatMapPass");
+		TraceZoneN("Renderer::ClusterHeatMapPass");
 
 		RHI::GraphicsPipeline::Ref pso = gfxPsoCache[RenderPassSemantic::ClusterHeapMapPass];
 
@@ -4,7 +4,7 @@ namespace Renderer3D {
 
 
 	void Renderer::LightingPass(RenderPass& pass) {
-		ZoneScopedN("Renderer::LightingPass");
+		TraceZoneN("Renderer::LightingPass");
 
 		RHI::GraphicsPipeline::Ref pso = gfxPsoCache[RenderPassSemantic::LightingPass];
 
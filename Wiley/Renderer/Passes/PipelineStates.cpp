@@ -7,7 +7,7 @@ namespace Renderer3D {
 	/// </summary>
 	void Renderer::CreatePipelineState()
 	{
-		ZoneScopedN("Renderer::CreatePipelines");
+		TraceZoneN("Renderer::CreatePipelines");
 
 		//Cluster Generaion
 		{
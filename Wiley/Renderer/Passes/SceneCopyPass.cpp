@@ -5,7 +5,7 @@ namespace Renderer3D {
 
 	void Renderer::SceneCopyPass(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::SceneCopyPass");
+		TraceZoneN("Renderer::SceneCopyPass");
 
 		UINT graphicsRingIndex = rctx->GetBackBufferIndex();
 
@@ -5,9 +5,9 @@
 namespace Renderer3D {
 
 
-	void ExecutePointLight(RHI::CommandList::Ref& commandList, const Wiley::LightComponent& light, ShadowMapManager::Ref shadowMapManager, Wiley::Camera::Ref camera, std::vector<DrawCommand>drawCommandCache)
+	void ExecutePointLight(RHI::CommandList::Ref& commandList, const Wiley::LightComponent& light, ShadowMapManager::Ref shadowMapManager, Wiley::Camera::Ref camera, const std::vector<DrawCommand>& drawCommands)
 	{
-		ZoneScopedN("Renderer::ShadowMapPass->Execute");
+		TraceZoneN("Renderer::ShadowMapPass->Execute");
 
 		const auto depthMap = shadowMapManager->GetDepthMap(light.depthMapIndex);
 		const auto& depthMapRTVs = depthMap->GetDepthMapRTVs();
@@ -42,8 +42,10 @@ namespace Renderer3D {
 			pConstants.vpIndex = light.matrixIndex + f;
 			pConstants.lightPosition = light.position;
 
-			for (int i = 0; i < drawCommandCache.size(); i++) {
-				const DrawCommand& drawCmd = drawCommandCache[i];
+			for (int i = 0; i < drawCommands.size(); i++) {
+				const DrawCommand& drawCmd = drawCommands[i];
+				if (drawCmd.instanceCount == 0)
+					continue;
 
 				pConstants.drawID = drawCmd.drawID;
 
@@ -56,7 +58,7 @@ namespace Renderer3D {
 
 	void Renderer3D::Renderer::ShadowMapPass(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::ShadowMapPass");
+		TraceZoneN("Renderer::ShadowMapPass");
 
 		RHI::GraphicsPipeline::Ref pso = gfxPsoCache[RenderPassSemantic::PointShadowMapPass];
 
@@ -110,7 +112,7 @@ namespace Renderer3D {
 				auto& light = lightEntt.GetComponent<Wiley::LightComponent>();
 				switch (light.type) {
 					case Wiley::LightType::Point: {
-						ExecutePointLight(commandList, light, shadowMapManager, camera, drawCommandCache);
+						ExecutePointLight(commandList, light, shadowMapManager, camera, shadowDrawCommandCache);
 						break;
 					}
 					case Wiley::LightType::Directional: {
@@ -134,7 +136,7 @@ namespace Renderer3D {
 			Wiley::Entity lightEntt = Wiley::Entity(dirtyPointLights.front(), _scene.get());
 			const auto& light = lightEntt.GetComponent<Wiley::LightComponent>();
 
-			ExecutePointLight(commandList, light, shadowMapManager, camera, drawCommandCache);
+			ExecutePointLight(commandList, light, shadowMapManager, camera, shadowDrawCommandCache);
 
 			depthToPixelBarriers.push_back({ shadowMapManager->GetDepthMap(light.depthMapIndex),RHI::TextureUsage::PixelShaderResource });
 			dirtyPointLights.pop();
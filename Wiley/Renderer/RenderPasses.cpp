@@ -6,7 +6,7 @@ namespace Renderer3D {
 
 	void Renderer::WireframePass(RenderPass& pass)
 	{
-		OPTICK_EVENT(__FUNCTION__);
+		TraceZone;
 
 		UINT graphicsRingIndex = rctx->GetBackBufferIndex();
 
@@ -55,7 +55,7 @@ namespace Renderer3D {
 
 	void Renderer::ShadowPass(RenderPass& pass)
 	{
-		OPTICK_EVENT(__FUNCTION__);
+		TraceZone;
 
 		UINT graphicsRingIndex = rctx->GetBackBufferIndex();
 
@@ -94,7 +94,7 @@ namespace Renderer3D {
 
 	void Renderer::PresentPass(RenderPass& pass)
 	{
-		ZoneScopedN("Renderer::PresentPass");
+		TraceZoneN("Renderer::PresentPass");
 
 		UINT graphicsRingIndex = rctx->GetBackBufferIndex();
 		RHI::GraphicsPipeline::Ref pso = gfxPsoCache[RenderPassSemantic::PresentPass];
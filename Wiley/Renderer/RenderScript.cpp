@@ -106,6 +106,7 @@ namespace Renderer3D
 			sol::constructors<RenderPass()>(),
 			"set_name", [this](RenderPass& pass, const std::string& name) {
 				pass.name = name;
+				pass.id = Wiley::StringId(name);
 			},
 			"set_type", [this](RenderPass& pass, RenderPassType type) {
 				pass.passType = type;
@@ -137,21 +138,21 @@ namespace Renderer3D
 				pass.outputs.push_back(handle);
 			},
 			"read_texture", [this](RenderPass& pass, const std::string& name, RHI::TextureUsage transition) {
-				auto handle = frameGraph->ReadTextureResource(name, transition);
+				auto handle = frameGraph->ReadTextureResource(Wiley::StringId(name), transition);
 				pass.inputs.push_back(handle);
 			},
 			"read_buffer", [this](RenderPass& pass, const std::string& name, RHI::BufferUsage transition) {
-				auto handle = frameGraph->ReadBufferResource(name, transition);
+				auto handle = frameGraph->ReadBufferResource(Wiley::StringId(name), transition);
 				pass.inputs.push_back(handle);
 			},
 			"write_texture", [this](RenderPass& pass, const std::string& name, RHI::TextureUsage transition)
 			{
-				auto handle = frameGraph->WriteTextureResource(name, transition);
+				auto handle = frameGraph->WriteTextureResource(Wiley::StringId(name), transition);
 				pass.outputs.push_back(handle);
 			},
 			"write_buffer", [this](RenderPass& pass, const std::string& name, RHI::BufferUsage transition)
 			{
-				auto handle = frameGraph->WriteBufferResource(name, transition);
+				auto handle = frameGraph->WriteBufferResource(Wiley::StringId(name), transition);
 				pass.outputs.push_back(handle);
 			}, 
 			"execute", [this](RenderPass& pass,std::function<void(RenderPass&)> passExecution) {
@@ -7,7 +7,7 @@ namespace Renderer3D
 {
 	void Renderer::CompileFrameGraph()
 	{
-		ZoneScopedN("Renderer::CompileFrameGraph");
+		TraceZoneN("Renderer::CompileFrameGraph");
 
 		//Importing needed external resources from C++ so they can be read via string name from Lua script
 		frameGraph->ImportBufferResource("VertexBuffer", vertexBuffer[0], RHI::BufferUsage::Vertex);
@@ -20,7 +20,7 @@ namespace Renderer3D
 	Renderer::Renderer(Wiley::Window::Ref window, RHI::RenderContext::Ref rctx)
 		:window(window), copyRingIndex(0), rctx(rctx)
 	{
-		ZoneScopedN("Renderer::Renderer");
+		TraceZoneN("Renderer::Renderer");
 
 
 		isVertexIndexDataDirty.fill(true);
@@ -76,7 +76,7 @@ namespace Renderer3D
 	}
 
 	void Renderer::OnResize(uint32_t width, uint32_t height) {
-		ZoneScopedN("Renderer::OnResize");
+		TraceZoneN("Renderer::OnResize");
 
 		UINT graphicsRingIndex = rctx->GetBackBufferIndex();
 
@@ -113,7 +113,7 @@ namespace Renderer3D
 	}
 
 	void Renderer3D::Renderer::NewFrame(Wiley::Scene::Ref scene) {
-		ZoneScopedN("Renderer::NewFrame");
+		TraceZoneN("Renderer::NewFrame");
 
 		rctx->NewFrame();
 
@@ -172,10 +172,12 @@ namespace Renderer3D
 
 	void Renderer::DrawCommands(RHI::CommandList::Ref commandList)
 	{
-		ZoneScopedN("Renderer::DrawCommands");
+		TraceZoneN("Renderer::DrawCommands");
 
 		for (int i = 0; i < drawCommandCache.size(); i++) {
 			const DrawCommand& drawCmd = drawCommandCache[i];
+			if (drawCmd.instanceCount == 0)
+				continue;
 			commandList->DrawInstancedIndexed(drawCmd.indexCount, drawCmd.instanceCount,
 				drawCmd.indexStartLocation, drawCmd.vertexStartLocation, drawCmd.instanceStartIndex);
 		}
@@ -183,10 +185,12 @@ namespace Renderer3D
 
 	void Renderer::DrawCommandsWithIndex(RHI::CommandList::Ref commandList)
 	{
-		ZoneScopedN("Renderer::DrawCommandsWithIndex");
+		TraceZoneN("Renderer::DrawCommandsWithIndex");
 
 		for (int i = 0; i < drawCommandCache.size(); i++) {
 			const DrawCommand& drawCmd = drawCommandCache[i];
+			if (drawCmd.instanceCount == 0)
+				continue;
 
 			commandList->PushConstant(&drawCmd.drawID, 4, 0);
 			commandList->DrawInstancedIndexed(drawCmd.indexCount, drawCmd.instanceCount,
@@ -197,7 +201,7 @@ namespace Renderer3D
 
 	void Renderer::RenderFrame()
 	{
-		ZoneScopedN("Renderer::RenderFrame");
+		TraceZoneN("Renderer::RenderFrame");
 
 		auto commandList = rctx->GetCurrentCommandList();
 
@@ -97,6 +97,10 @@ namespace Renderer3D
 
 	private:
 		std::vector<DrawCommand> drawCommandCache;
+		std::vector<DrawCommand> shadowDrawCommandCache;
+		std::vector<Wiley::DirtyRange> uploadRanges;
+		std::vector<uint32_t> visibleMeshFilters;
+		std::vector<uint8_t> meshFilterVisibility;
 		RHI::ComputePipeline::Ref computePso;
 
 		RHI::DescriptorHeap::Descriptor cBufferDesc;
@@ -16,7 +16,10 @@ namespace Renderer3D {
 		arraySrv = rctx->AllocateCBV_SRV_UAV(MAX_LIGHTS);
 
 		//Tears in my eyes... 400KB...
-		lightViewProjectionUploadBuffer = rctx->CreateUploadBuffer<DirectX::XMFLOAT4X4>(WILEY_BUFFER_SIZE_BYTES(DirectX::XMFLOAT4X4, MAX_LIGHTS * 6), WILEY_SIZEOF(DirectX::XMFLOAT4X4), "LightViewProjectionUploadBuffer");
+		lightViewProjectionUploadBuffer = rctx->CreateUploadBuffer<DirectX::XMFLOAT4X4>(WILEY_BUFFER_SIZE_BYTES(DirectX::XMFLOAT4X4, MAX_LIGHTS * 6), WILEY_SIZEOF(DirectX::XMFLOAT4X4), "LightViewProjectionUploadBuffer", MemoryTag::ShadowMaps);
+
+		lightDirtyEvent.AddLambda([this](const entt::entity& entity) { dirtyLightEntities.push(entity); });
+		pointLightDirtyEvent.AddLambda([this](const entt::entity& entity) { dirtyPointLights.push(entity); });
 	}
 
 	ShadowMapManager::~ShadowMapManager()
@@ -24,6 +27,8 @@ namespace Renderer3D {
 		rctx.reset();
 		cubeSrv.clear();
 		arraySrv.clear();
+		for (auto& depthMap : depthMaps)
+			UntrackDepthMap(depthMap);
 		depthMaps.fill(nullptr);
 	}
 
@@ -39,7 +44,9 @@ namespace Renderer3D {
 			mapfreelist.pop();
 
 			RHI::Texture::Ref& depthMap = depthMaps[index];
+			UntrackDepthMap(depthMap);
 			depthMap = std::make_shared<RHI::Texture>(rctx->GetDevice(), mapSize, mapSize, textureUsage, rctx->GetDescriptorHeaps(), mapName);
+			TrackDepthMap(depthMap);
 			
 			uint32_t srvIndex = AllocateSRV(type);
 			BuildSRV(type, srvIndex, depthMap);	
@@ -60,6 +67,7 @@ namespace Renderer3D {
 		index = mapPtr++;
 		Texture::Ref &depthMap = depthMaps[index];
 		depthMap = std::make_shared<Texture>(rctx->GetDevice(), mapSize, mapSize, textureUsage, rctx->GetDescriptorHeaps(), mapName);
+		TrackDepthMap(depthMap);
 		
 		uint32_t srvIndex = AllocateSRV(type);
 		BuildSRV(type, srvIndex, depthMap);
@@ -103,14 +111,37 @@ namespace Renderer3D {
 		return;
 	}
 
+	/// <summary>
+	///		Shadow maps are 32 bit single channel textures with 6 array slices. Freed slots keep their texture until the slot is reused.
+	/// </summary>
+	void ShadowMapManager::TrackDepthMap(const RHI::Texture::Ref& depthMap)
+	{
+		if (depthMap)
+			gMemoryTracker.RecordAlloc(MemoryTag::ShadowMaps, static_cast<size_t>(depthMap->GetWidth()) * depthMap->GetHeight() * 4 * 6);
+	}
+
+	void ShadowMapManager::UntrackDepthMap(const RHI::Texture::Ref& depthMap)
+	{
+		if (depthMap)
+			gMemoryTracker.RecordFree(MemoryTag::ShadowMaps, static_cast<size_t>(depthMap->GetWidth()) * depthMap->GetHeight() * 4 * 6);
+	}
+
 	void ShadowMapManager::MakeLightEntityDirty(entt::entity entity)
 	{
-		dirtyLightEntities.push(entity);
+		lightDirtyEvent.Post(entity);
 	}
 
 	void ShadowMapManager::MakePointLightDirty(entt::entity entity)
 	{
-		dirtyPointLights.push(entity);
+		pointLightDirtyEvent.Post(entity);
+	}
+
+	void ShadowMapManager::DispatchDirtyNotifications()
+	{
+		TraceZoneN("ShadowMapManager::DispatchDirtyNotifications");
+
+		lightDirtyEvent.Dispatch();
+		pointLightDirtyEvent.Dispatch();
 	}
 
 	void ShadowMapManager::MakeAllLightEntityDirty()
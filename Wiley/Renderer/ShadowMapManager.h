@@ -2,10 +2,12 @@
 #include "../RHI/RenderContext.h"
 #include "../Resource/ResourceCache.h"
 #include "../Scene/Component.h"
+#include "../Core/DeferredEvent.h"
 
 #include <entt.hpp>
 
 #include <string>
+#include <atomic>
 
 template<typename T>
 using Span = std::span<T>;
@@ -25,6 +27,9 @@ namespace Renderer3D
 		ShadowMapSize_4096 = 4096, //I know you are rich
 	};
 
+	class ShadowMapManager;
+	DECLARE_DEFERRED_EVENT(LightDirtyEvent, ShadowMapManager, entt::entity, true);
+
 	class ShadowMapManager
 	{
 		public:
@@ -35,10 +40,16 @@ namespace Renderer3D
 			WILEY_NODISCARD ShadowMapData AllocateTexture(Wiley::LightType type, ShadowMapSize mapSize = ShadowMapSize::ShadowMapSize_1024, const std::string& name = "ShadowMapTexture");
 			void DeallocateTexture(ShadowMapData index,Wiley::LightType type);
 
+			//Safe to call from any thread. Repeated notifications for one light within a frame are delivered once.
 			void MakeLightEntityDirty(entt::entity entity);
 			void MakePointLightDirty(entt::entity entity);
 			void MakeAllLightEntityDirty();
 
+			/// <summary>
+			///		Moves the dirty notifications posted since the last call into the dirty queues. Call once per frame before the light systems run.
+			/// </summary>
+			void DispatchDirtyNotifications();
+
 			void ClearDirtyLightQueue();
 			void ClearDirtyPointLightQueue();
 			void CleanAllLightEntity();
@@ -61,6 +72,9 @@ namespace Renderer3D
 
 			uint32_t AllocateMatrixSpace(Wiley::LightType type);
 
+			void TrackDepthMap(const RHI::Texture::Ref& depthMap);
+			void UntrackDepthMap(const RHI::Texture::Ref& depthMap);
+
 		private:
 			RHI::Texture::Ref dummyDepthBuffer;
 
@@ -81,9 +95,12 @@ namespace Renderer3D
 			//std::unique_ptr<Wiley::LinearAllocator<DirectX::XMFLOAT4X4>> lightViewProjections;
 			RHI::UploadBuffer<DirectX::XMFLOAT4X4>::Ref lightViewProjectionUploadBuffer;
 
+			LightDirtyEvent lightDirtyEvent;
+			LightDirtyEvent pointLightDirtyEvent;
+
 			Queue<entt::entity> dirtyLightEntities;
 			Queue<entt::entity> dirtyPointLights;
-			bool isAllLightEntityDiry;
+			std::atomic<bool> isAllLightEntityDiry;
 
 			RHI::RenderContext::Ref rctx;
 	};
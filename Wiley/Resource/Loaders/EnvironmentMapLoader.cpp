@@ -1,5 +1,6 @@
 #include "../ResourceLoader.h"
 #include "../ResourceCache.h"
+#include "../../Core/IOService.h"
 
 #include "toml.hpp"
 #include "stb_image.h"
@@ -26,18 +27,27 @@ namespace Wiley {
 
 	Resource::Ref EnvironmentMapLoader::LoadTOMLFromFile(filespace::filepath path, ResourceLoadDesc& loadDesc)
 	{
-		auto emResource = std::make_shared<EnvironmentMap>();
+		auto emResource = MakePooled<EnvironmentMap>();
 		const std::string fileName = path.stem().string();
 
+		FileBuffer file = gIOService.ReadBlocking(path);
+		if (!file) {
+			std::cout << "ERROR :: failed to read environment map file." << std::endl;
+			return nullptr;
+		}
+
+		const stbi_uc* fileBytes = file.bytes.data();
+		const int fileSize = static_cast<int>(file.bytes.size());
+
 		int width, height, nChannel;
-		if (!stbi_is_hdr(path.string().c_str())) {
+		if (!stbi_is_hdr_from_memory(fileBytes, fileSize)) {
 			std::cout << "ERROR :: provided file is not HDR." << std::endl;
 			return nullptr;
 		}
 
-		stbi_set_flip_vertically_on_load(loadDesc.flipUV);
+		stbi_set_flip_vertically_on_load_thread(loadDesc.flipUV);
 
-		float* data = stbi_loadf(path.string().c_str(), &width, &height, &nChannel, 4);
+		float* data = stbi_loadf_from_memory(fileBytes, fileSize, &width, &height, &nChannel, 4);
 		if (!data) {
 			std::cout << "STB failed to load image. :)\n";
 			return nullptr;
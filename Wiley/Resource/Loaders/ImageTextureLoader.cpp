@@ -1,5 +1,6 @@
 #include "../ResourceLoader.h"
 #include "../ResourceCache.h"
+#include "../../Core/IOService.h"
 
 #include "stb_image.h"
 #include "stb_image_write.h"
@@ -9,46 +10,69 @@
 namespace Wiley {
 
 
+    void ImageTextureLoader::DecodedImage::Release()
+    {
+        if (pixels)
+            stbi_image_free(pixels);
+        pixels = nullptr;
+    }
+
     Resource::Ref ImageTextureLoader::LoadFromFile(filespace::filepath path, ResourceLoadDesc& loadDesc)
     {
         if (path.extension().string() == ".dds") {
             return LoadFromDDSFile(path, loadDesc);
         }
 
-        std::shared_ptr<ImageTexture> imageTextureRef = std::make_shared<ImageTexture>();
-        void* data;
-        int width, height, nChannel;
+        FileBuffer file = gIOService.ReadBlocking(path);
+        if (!file) {
+            std::cout << "Failed to read Image Texture File." << std::endl;
+            return nullptr;
+        }
+
+        DecodedImage image;
+        if (!Decode(file, loadDesc.flipUV, image)) {
+            std::cout << "Failed to load Image Texture File." << std::endl;
+            return nullptr;
+        }
+
+        return CreateFromDecoded(image, loadDesc);
+    }
 
-        stbi_set_flip_vertically_on_load(loadDesc.flipUV);
+    bool ImageTextureLoader::Decode(const FileBuffer& file, bool flipUV, DecodedImage& image)
+    {
+        const stbi_uc* fileBytes = file.bytes.data();
+        const int fileSize = static_cast<int>(file.bytes.size());
+        int nChannel;
 
-        bool is16Bit = false;
-        if (stbi_is_16_bit(path.string().c_str())) {
-            imageTextureRef->bitPerChannel = 16;
+        //The global flip flag would race with decodes on other workers, the per-thread one does not.
+        stbi_set_flip_vertically_on_load_thread(flipUV);
 
-            data = stbi_load_16(path.string().c_str(), &width, &height, &nChannel, 4);
-            is16Bit = true;
+        if (stbi_is_16_bit_from_memory(fileBytes, fileSize)) {
+            image.bitPerChannel = 16;
+            image.pixels = stbi_load_16_from_memory(fileBytes, fileSize, &image.width, &image.height, &nChannel, 4);
         }
         else {
-            imageTextureRef->bitPerChannel = 8;
-            data = stbi_load(path.string().c_str(), &width, &height, &nChannel, 4);
-            is16Bit = false;
+            image.bitPerChannel = 8;
+            image.pixels = stbi_load_from_memory(fileBytes, fileSize, &image.width, &image.height, &nChannel, 4);
         }
 
-        if (!data) {
-            std::cout << "Failed to load Image Texture File." << std::endl;
-            return nullptr;
-        }
+        return image.pixels != nullptr;
+    }
 
-        imageTextureRef->width = width;
-        imageTextureRef->height = height;
+    Resource::Ref ImageTextureLoader::CreateFromDecoded(DecodedImage& image, const ResourceLoadDesc& loadDesc)
+    {
+        std::shared_ptr<ImageTexture> imageTextureRef = MakePooled<ImageTexture>();
+
+        imageTextureRef->width = image.width;
+        imageTextureRef->height = image.height;
         imageTextureRef->nChannels = 4;
+        imageTextureRef->bitPerChannel = image.bitPerChannel;
         imageTextureRef->mapType = loadDesc.desc.imageTextureDesc.type;
-        nChannel = 4;
 
-        imageTextureRef->textureResource = resourceCache->rctx->CreateShaderResourceTexture(data, width, height, 
-            nChannel, imageTextureRef->bitPerChannel);
+        imageTextureRef->textureResource = resourceCache->rctx->CreateShaderResourceTexture(image.pixels, image.width, image.height,
+            4, image.bitPerChannel);
 
-        stbi_image_free(data);
+        image.Release();
 
         auto descManager = resourceCache->GetImageTextureDescriptorManager(loadDesc.desc.imageTextureDesc.type);
         UINT descriptorIndex = resourceCache->GetFreeImageDescriptorIndex(descManager);
@@ -59,7 +83,7 @@ namespace Wiley {
     }
 
     Resource::Ref ImageTextureLoader::LoadFromDDSFile(filespace::filepath path, ResourceLoadDesc& loadDesc) {
-        std::shared_ptr<ImageTexture> imageTextureRef = std::make_shared<ImageTexture>();
+        std::shared_ptr<ImageTexture> imageTextureRef = MakePooled<ImageTexture>();
 
         int width, height, nChannel, bitPerChannel;
         imageTextureRef->textureResource = resourceCache->rctx->CreateShaderResourceTextureFromFile(path, width, height, nChannel, bitPerChannel);
@@ -1,5 +1,6 @@
 #include "../ResourceLoader.h"
 #include "../ResourceCache.h"
+#include "../../Core/IOService.h"
 
 #include "mtl_parser.h"
 
@@ -56,9 +57,9 @@ namespace Wiley {
 
     Resource::Ref MaterialLoader::LoadMTLFromFile(filespace::filepath path, ResourceLoadDesc& loadDesc)
     {
-        std::shared_ptr<Material> materialRef = std::make_shared<Material>();
-        MemoryBlock<MaterialData> memoryBlk = resourceCache->materialDataPool->Allocate(1);
-        materialRef->dataPtr = memoryBlk.data();
+        std::shared_ptr<Material> materialRef = MakePooled<Material>();
+        materialRef->dataPool = resourceCache->materialDataPool.get();
+        materialRef->dataHandle = materialRef->dataPool->AllocateHandle(1);
 
         std::ifstream file(path.string().c_str());
         if (!file.is_open())
@@ -85,7 +86,7 @@ namespace Wiley {
                 ImageTexture* metalloicResource = static_cast<ImageTexture*>(resourceCache->LoadResource<ImageTexture>(mtlFile.paths.metallic, metallicLoadDesc).get());
                 ImageTexture* roughnessResource = static_cast<ImageTexture*>(resourceCache->LoadResource<ImageTexture>(mtlFile.paths.roughness, roughnessLoadDesc).get());
 
-                auto mtlDataPtr = materialRef->dataPtr;
+                auto mtlDataPtr = materialRef->GetData();
                 mtlDataPtr->albedo.mapIndex = albedoResource->srvIndex;
                 mtlDataPtr->albedo.value = mtlFile.values.albedo;
 
@@ -124,11 +125,18 @@ namespace Wiley {
 
     Resource::Ref MaterialLoader::LoadTOMLFromFile(filespace::filepath path, ResourceLoadDesc& loadDesc)
     {
-        std::shared_ptr<Material> materialRef = std::make_shared<Material>();
-        MemoryBlock<MaterialData> memoryBlk = resourceCache->materialDataPool->Allocate(1);
-        materialRef->dataPtr = memoryBlk.data();
+        std::shared_ptr<Material> materialRef = MakePooled<Material>();
+        materialRef->dataPool = resourceCache->materialDataPool.get();
+        materialRef->dataHandle = materialRef->dataPool->AllocateHandle(1);
 
-        toml::table node = toml::parse_file(path.string());
+        FileBuffer file = gIOService.ReadBlocking(path);
+        if (!file) {
+            std::cout << "Failed to read TOML Material File." << std::endl;
+            return nullptr;
+        }
+
+        const std::string_view fileText(reinterpret_cast<const char*>(file.bytes.data()), file.bytes.size());
+        toml::table node = toml::parse(fileText, path.string());
 
         ResourceLoadDesc imageLoadDesc{};
 
@@ -176,7 +184,7 @@ namespace Wiley {
         }
 
         {
-            MaterialData* mtlData = materialRef->dataPtr;
+            MaterialData* mtlData = materialRef->GetData();
 
             auto albedoPropertiesTable = node["properties.albedo"];
             auto albedoPropertiesValueArr = albedoPropertiesTable["value"].as_array();
@@ -236,11 +244,11 @@ namespace Wiley {
 
     Resource::Ref MaterialLoader::CreateNew(filespace::filepath path)
     {
-        std::shared_ptr<Material> materialRef = std::make_shared<Material>();
-        MemoryBlock<MaterialData> memoryBlk = resourceCache->materialDataPool->Allocate(1);
-        materialRef->dataPtr = (MaterialData*)memoryBlk.data();
+        std::shared_ptr<Material> materialRef = MakePooled<Material>();
+        materialRef->dataPool = resourceCache->materialDataPool.get();
+        materialRef->dataHandle = materialRef->dataPool->AllocateHandle(1);
 
-        MaterialData* materialData = materialRef->dataPtr;
+        MaterialData* materialData = materialRef->GetData();
 
         materialData->albedo.value = { 1.0f,1.0f,1.0f,1.0f };
         materialData->normal.strength = 1.0f;
@@ -278,31 +286,31 @@ namespace Wiley {
             }},
 
             { "properties.albedo", toml::table{
-                { "value",toml::array{ material->dataPtr->albedo.value.x,
-                                       material->dataPtr->albedo.value.y,
-                                       material->dataPtr->albedo.value.z,
-                                       material->dataPtr->albedo.value.w}
+                { "value",toml::array{ material->GetData()->albedo.value.x,
+                                       material->GetData()->albedo.value.y,
+                                       material->GetData()->albedo.value.z,
+                                       material->GetData()->albedo.value.w}
                 }
             }},
             { "properties.normal", toml::table{
-                { "value", material->dataPtr->normal.strength}
+                { "value", material->GetData()->normal.strength}
             }},
             { "properties.ambient_occlusion", toml::table{
-                { "value", material->dataPtr->ambientOcclusion.value},
-                { "channel", GetChannelString(material->dataPtr->ambientOcclusion.valueChannel)},
+                { "value", material->GetData()->ambientOcclusion.value},
+                { "channel", GetChannelString(material->GetData()->ambientOcclusion.valueChannel)},
             }},
             { "properties.roughness", toml::table{
-                { "value", material->dataPtr->roughness.value},
-                { "channel", GetChannelString(material->dataPtr->roughness.valueChannel)}
+                { "value", material->GetData()->roughness.value},
+                { "channel", GetChannelString(material->GetData()->roughness.valueChannel)}
             }},
             { "properties.metallic", toml::table{
-                { "value", material->dataPtr->metallic.value},
-                { "channel", GetChannelString(material->dataPtr->metallic.valueChannel)}
+                { "value", material->GetData()->metallic.value},
+                { "channel", GetChannelString(material->GetData()->metallic.valueChannel)}
             }},
 
             { "properties.global", toml::table{
-                {"scale", toml::array(material->dataPtr->mapScale.x,
-                                    material->dataPtr->mapScale.y)
+                {"scale", toml::array(material->GetData()->mapScale.x,
+                                    material->GetData()->mapScale.y)
                 }
             }}
         };
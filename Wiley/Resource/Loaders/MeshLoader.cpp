@@ -11,8 +11,14 @@
 #define CGLTF_IMPLEMENTATION
 #include "cgltf.h"
 
+#include "../../Core/Parallel.h"
+#include "../../Core/IOService.h"
+
+#include <cctype>
+#include <initializer_list>
 #include <cstdlib>
 #include <fstream>
+#include <algorithm>
 
 namespace Wiley {
 
@@ -218,7 +224,7 @@ namespace Wiley {
 
     Resource::Ref MeshLoader::LoadObjFromFile(filespace::filepath path, ResourceLoadDesc& loadDesc)
     {
-        std::shared_ptr<Mesh> meshRef = std::make_shared<Mesh>();
+        std::shared_ptr<Mesh> meshRef = MakePooled<Mesh>();
         Mesh& meshData = *meshRef.get();
 
         tinyobj::ObjReaderConfig config;
@@ -394,7 +400,7 @@ namespace Wiley {
     Resource::Ref MeshLoader::LoadGLTFFromFile(filespace::filepath path, ResourceLoadDesc& loadDesc)
     {
         WILEY_DEBUGBREAK;
-        std::shared_ptr<Mesh> meshRef = std::make_shared<Mesh>();
+        std::shared_ptr<Mesh> meshRef = MakePooled<Mesh>();
         Mesh& meshData = *meshRef.get();
         return nullptr;
     }
@@ -471,85 +477,23 @@ namespace Wiley {
             aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
 
            {
-                ResourceLoadDesc loadDesc{};
-
-                aiReturn status;
-
                 aiColor4D diffuseColor;
-                std::string cTexturePath;
                 aiString texturePath;
 
-                loadDesc.desc.imageTextureDesc.type = MapType::Albedo;
-                if (material->GetTexture(aiTextureType_DIFFUSE, 0, &texturePath) != AI_SUCCESS)
-                    material->GetTexture(aiTextureType_BASE_COLOR, 0, &texturePath);
-                cTexturePath = modelDirectory.string() + "/" + texturePath.C_Str();
-                auto albedoResource = resourceCache->LoadResource<ImageTexture>(cTexturePath, loadDesc);
-
-                loadDesc.desc.imageTextureDesc.type = MapType::Normal;
-                Resource::Ref normalResource;
-                if (material->GetTexture(aiTextureType_NORMALS, 0, &texturePath) == AI_SUCCESS)
-                {
-                    cTexturePath = modelDirectory.string() + "/" + texturePath.C_Str();
-                    normalResource = resourceCache->LoadResource<ImageTexture>(cTexturePath, loadDesc);
-                }
-                else  if (material->GetTexture(aiTextureType_HEIGHT, 0, &texturePath) == AI_SUCCESS) {
-                    cTexturePath = modelDirectory.string() + "/" + texturePath.C_Str();
-                    normalResource = resourceCache->LoadResource<ImageTexture>(cTexturePath, loadDesc);
-                }
-                else  if (material->GetTexture(aiTextureType_DISPLACEMENT, 0, &texturePath) == AI_SUCCESS) {
-                    cTexturePath = modelDirectory.string() + "/" + texturePath.C_Str();
-                    normalResource = resourceCache->LoadResource<ImageTexture>(cTexturePath, loadDesc);
-                }
-                else {
-                    normalResource = resourceCache->GetDefaultImageTexture(MapType::Normal);
-                }
-
-
-                loadDesc.desc.imageTextureDesc.type = MapType::Roughness;
-                Resource::Ref roughnessResource;
-                if (material->GetTexture(aiTextureType_DIFFUSE_ROUGHNESS, 0, &texturePath) == AI_SUCCESS) {
-                    cTexturePath = modelDirectory.string() + "/" + texturePath.C_Str();
-                    roughnessResource = resourceCache->LoadResource<ImageTexture>(cTexturePath, loadDesc);
-                }
-                else if (material->GetTexture(aiTextureType_SHININESS, 0, &texturePath) == AI_SUCCESS) {
-                    cTexturePath = modelDirectory.string() + "/" + texturePath.C_Str();
-                    roughnessResource = resourceCache->LoadResource<ImageTexture>(cTexturePath, loadDesc);
-                }
-                else {
-                    roughnessResource = resourceCache->GetDefaultImageTexture(MapType::Roughness);
-                }
-
-                loadDesc.desc.imageTextureDesc.type = MapType::AO;
-                Resource::Ref aoResource;
-                if (material->GetTexture(aiTextureType_AMBIENT_OCCLUSION, 0, &texturePath) == AI_SUCCESS) {
-                    cTexturePath = modelDirectory.string() + "/" + texturePath.C_Str();
-                    aoResource = resourceCache->LoadResource<ImageTexture>(cTexturePath, loadDesc);
-                }
-                else if (material->GetTexture(aiTextureType_LIGHTMAP, 0, &texturePath) == AI_SUCCESS) {
-                    cTexturePath = modelDirectory.string() + "/" + texturePath.C_Str();
-                    aoResource = resourceCache->LoadResource<ImageTexture>(cTexturePath, loadDesc);
-                }
-                else {
-                    aoResource = resourceCache->GetDefaultImageTexture(MapType::AO);
-                }
-
+                //Returns the path of the first texture type the material has, or an empty string if it has none of them.
+                auto findTexturePath = [&](std::initializer_list<aiTextureType> types) -> std::string {
+                    for (aiTextureType type : types) {
+                        if (material->GetTexture(type, 0, &texturePath) == AI_SUCCESS)
+                            return modelDirectory.string() + "/" + texturePath.C_Str();
+                    }
+                    return {};
+                };
 
-                loadDesc.desc.imageTextureDesc.type = MapType::Metalloic;
-                status = material->GetTexture(aiTextureType_METALNESS, 0, &texturePath);
-                Resource::Ref metallicResource;
-                if (status == AI_SUCCESS)
-                {
-                    cTexturePath = modelDirectory.string() + "/" + texturePath.C_Str();
-                    metallicResource = resourceCache->LoadResource<ImageTexture>(cTexturePath, loadDesc);
-                }
-                else if (material->GetTexture(aiTextureType_SPECULAR, 0, &texturePath) == AI_SUCCESS)
-                {
-                    cTexturePath = modelDirectory.string() + "/" + texturePath.C_Str();
-                    metallicResource = resourceCache->LoadResource<ImageTexture>(cTexturePath, loadDesc);
-                }
-                else {
-                    metallicResource = resourceCache->GetDefaultImageTexture(MapType::Metalloic);
-                }
+                const std::string albedoPath = findTexturePath({ aiTextureType_DIFFUSE, aiTextureType_BASE_COLOR });
+                const std::string normalPath = findTexturePath({ aiTextureType_NORMALS, aiTextureType_HEIGHT, aiTextureType_DISPLACEMENT });
+                const std::string roughnessPath = findTexturePath({ aiTextureType_DIFFUSE_ROUGHNESS, aiTextureType_SHININESS });
+                const std::string aoPath = findTexturePath({ aiTextureType_AMBIENT_OCCLUSION, aiTextureType_LIGHTMAP });
+                const std::string metallicPath = findTexturePath({ aiTextureType_METALNESS, aiTextureType_SPECULAR });
 
                 aiString materialName = material->GetName();
                 std::string materialPath = std::string(materialName.C_Str()) + std::string(".toml");
@@ -564,14 +508,28 @@ namespace Wiley {
                 resourceCache->Cache(newMaterialResource, newMtlDesc, WILEY_INVALID_UUID);
                 const auto newMtlUUID = newMaterialResource->GetUUID();
 
-                resourceCache->SetMaterialMap(newMtlUUID, albedoResource->GetUUID(), Wiley::MapType::Albedo);
-                resourceCache->SetMaterialMap(newMtlUUID, normalResource->GetUUID(), Wiley::MapType::Normal);
-                resourceCache->SetMaterialMap(newMtlUUID, aoResource->GetUUID(), Wiley::MapType::AO);
-                resourceCache->SetMaterialMap(newMtlUUID, roughnessResource->GetUUID(), Wiley::MapType::Roughness);
-                resourceCache->SetMaterialMap(newMtlUUID, metallicResource->GetUUID(), Wiley::MapType::Metalloic);
+                //The material starts on the default maps and switches to each texture once it has been decoded off this thread,
+                //so every texture of the model decodes in parallel instead of one after another here.
+                auto loadMap = [&](const std::string& path, MapType type) {
+                    resourceCache->SetMaterialMap(newMtlUUID, resourceCache->GetDefaultImageTexture(type)->GetUUID(), type);
+                    if (path.empty())
+                        return;
+
+                    ResourceLoadDesc loadDesc{};
+                    loadDesc.desc.imageTextureDesc.type = type;
+                    resourceCache->LoadImageTextureAsync(path, loadDesc, [cache = resourceCache, newMtlUUID, type](Resource::Ref imageTexture) {
+                        cache->SetMaterialMap(newMtlUUID, imageTexture->GetUUID(), type);
+                    });
+                };
+
+                loadMap(albedoPath, MapType::Albedo);
+                loadMap(normalPath, MapType::Normal);
+                loadMap(aoPath, MapType::AO);
+                loadMap(roughnessPath, MapType::Roughness);
+                loadMap(metallicPath, MapType::Metalloic);
 
                 Material* mtl = static_cast<Material*>(newMaterialResource.get());
-                auto mtlData = mtl->dataPtr;
+                auto mtlData = mtl->GetData();
 
                 material->Get(AI_MATKEY_COLOR_DIFFUSE, diffuseColor);
                 material->Get(AI_MATKEY_METALLIC_FACTOR, mtlData->metallic.value);
@@ -596,7 +554,11 @@ namespace Wiley {
             box.min = { FLT_MAX, FLT_MAX, FLT_MAX };
             box.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
 
-            for (int v = 0; v < mesh->mNumVertices; v++) {
+            //Vertices are independent, so fill them in place across the pool and reduce the bounds separately.
+            const size_t vertexBase = vertices.size();
+            vertices.resize(vertexBase + mesh->mNumVertices);
+
+            ParallelFor(0u, mesh->mNumVertices, 1024u, [&](unsigned int v) {
                 Vertex vertex = {};
                 vertex.subMeshIndex = subMesh.index;
 
@@ -606,20 +568,6 @@ namespace Wiley {
                     vertex.position.z = mesh->mVertices[v].z;
                 }
 
-                box.min.x = std::min(box.min.x, vertex.position.x);
-                box.min.y = std::min(box.min.y, vertex.position.y);
-                box.min.z = std::min(box.min.z, vertex.position.z);
-                box.max.x = std::max(box.max.x, vertex.position.x);
-                box.max.y = std::max(box.max.y, vertex.position.y);
-                box.max.z = std::max(box.max.z, vertex.position.z);
-
-                meshData.aabb.min.x = std::min(meshData.aabb.min.x, vertex.position.x);
-                meshData.aabb.min.y = std::min(meshData.aabb.min.y, vertex.position.y);
-                meshData.aabb.min.z = std::min(meshData.aabb.min.z, vertex.position.z);
-                meshData.aabb.max.x = std::max(meshData.aabb.max.x, vertex.position.x);
-                meshData.aabb.max.y = std::max(meshData.aabb.max.y, vertex.position.y);
-                meshData.aabb.max.z = std::max(meshData.aabb.max.z, vertex.position.z);
-
                 if (mesh->HasNormals())
                 {
                     vertex.normal.x = mesh->mNormals[v].x;
@@ -675,8 +623,27 @@ namespace Wiley {
 
                 }
 
-                vertices.push_back(vertex);
-            }
+                vertices[vertexBase + v] = vertex;
+            });
+
+            auto mergeBox = [](AABB a, const AABB& b) {
+                a.min.x = std::min(a.min.x, b.min.x);
+                a.min.y = std::min(a.min.y, b.min.y);
+                a.min.z = std::min(a.min.z, b.min.z);
+                a.max.x = std::max(a.max.x, b.max.x);
+                a.max.y = std::max(a.max.y, b.max.y);
+                a.max.z = std::max(a.max.z, b.max.z);
+                return a;
+            };
+
+            box = ParallelReduce<AABB>(0u, mesh->mNumVertices, 4096u, box,
+                [&](unsigned int v) {
+                    AABB point;
+                    point.min = point.max = { mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z };
+                    return point;
+                }, mergeBox);
+
+            meshData.aabb = mergeBox(meshData.aabb, box);
 
             for (unsigned int f = 0; f < mesh->mNumFaces; f++)
             {
@@ -699,7 +666,7 @@ namespace Wiley {
     }
 
     Resource::Ref MeshLoader::LoadWithAssimp(filespace::filepath path, ResourceLoadDesc& loadDesc) {
-        std::shared_ptr<Mesh> meshRef = std::make_shared<Mesh>();
+        std::shared_ptr<Mesh> meshRef = MakePooled<Mesh>();
         Mesh& meshData = *meshRef.get();
 
         Assimp::Importer importer;
@@ -710,7 +677,23 @@ namespace Wiley {
             aiProcess_JoinIdenticalVertices;
         flags |= (loadDesc.desc.meshDesc.normalType == NormalType::Smooth) ? aiProcess_GenSmoothNormals : aiProcess_GenNormals;
 
-        const aiScene* scene = importer.ReadFile(path.string().c_str(), flags);
+        //Formats that reference sibling files (.mtl, .bin) still go through Assimp's own file system.
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        const bool selfContained = !extension.empty() && extension != ".obj" && extension != ".gltf";
+
+        FileBuffer file;
+        const aiScene* scene = nullptr;
+        if (selfContained) {
+            file = gIOService.ReadBlocking(path);
+            if (!file)
+                return nullptr;
+
+            scene = importer.ReadFileFromMemory(file.bytes.data(), file.bytes.size(), flags, extension.c_str() + 1);
+        }
+        else {
+            scene = importer.ReadFile(path.string().c_str(), flags);
+        }
 
         if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
             return nullptr;
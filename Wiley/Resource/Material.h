@@ -3,6 +3,7 @@
 //Created on 12/4/2025 at ~11:45
 
 #include "Resource.h"
+#include "../Core/Allocator.h"
 #include "DirectXMath.h"
 
 namespace Wiley {
@@ -67,7 +68,14 @@ namespace Wiley {
 	};
 
 	struct Material : public Resource {
-		MaterialData* dataPtr;
+		/// <summary>
+		/// The MaterialData lives in the ResourceCache's material data pool and is addressed by handle so the pool can grow.
+		/// </summary>
+		PoolHandle dataHandle;
+		LinearAllocator<MaterialData>* dataPool;
+
+		MaterialData* GetData()const { return dataPool->Resolve(dataHandle).data(); }
+		UINT GetDataIndex()const { return dataPool->GetIndex(dataHandle); }
 
 		/// <summary>
 		/// These are the UUIDs to the image textures that are being used for the different properties.
@@ -81,7 +89,7 @@ namespace Wiley {
 
 		Material()
 			:albedoMap(0), normalMap(0), metaillicMap(0), roughnessMap(0),
-			ambientOcclusionMap(0), dataPtr(nullptr)
+			ambientOcclusionMap(0), dataPool(nullptr)
 		{
 
 		}
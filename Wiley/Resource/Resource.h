@@ -3,6 +3,7 @@
 #include "../Core/Utils.h"
 #include "../Core/UUID.h"
 #include "../Core/FileSpace.h"
+#include "../Core/SlabAllocator.h"
 
 
 namespace Wiley
@@ -1,5 +1,6 @@
 #include "ResourceCache.h"
 #include "Geometry.h"
+#include "../Core/IOService.h"
 
 namespace Wiley {
 
@@ -18,10 +19,11 @@ namespace Wiley {
 	ResourceCache::ResourceCache(RHI::RenderContext::Ref rctx)
 		: rctx(rctx)
 	{
-		vertexUploadBuffer = rctx->CreateUploadBuffer<Vertex>(MAX_VERTEX_COUNT * WILEY_SIZEOF(Vertex), WILEY_SIZEOF(Wiley::Vertex), "VertexUploadBuffer");
-		indexUploadBuffer = rctx->CreateUploadBuffer<UINT>(MAX_INDEX_COUNT * WILEY_SIZEOF(UINT), WILEY_SIZEOF(UINT), "IndexUploadBuffer");
+		vertexUploadBuffer = rctx->CreateUploadBuffer<Vertex>(MAX_VERTEX_COUNT * WILEY_SIZEOF(Vertex), WILEY_SIZEOF(Wiley::Vertex), "VertexUploadBuffer", MemoryTag::VertexPool);
+		indexUploadBuffer = rctx->CreateUploadBuffer<UINT>(MAX_INDEX_COUNT * WILEY_SIZEOF(UINT), WILEY_SIZEOF(UINT), "IndexUploadBuffer", MemoryTag::IndexPool);
 
-		materialDataPool = std::make_shared<LinearAllocator<MaterialData>>(MAX_MATERIAL_COUNT);
+		//The GPU material buffer holds MAX_MATERIAL_COUNT entries, so reserve that much and only commit pages as materials load.
+		materialDataPool = std::make_shared<LinearAllocator<MaterialData>>(MAX_MATERIAL_COUNT / 8, MAX_MATERIAL_COUNT, MemoryTag::MaterialData);
 		materialDataPool->Initialize();
 
 		meshLoader = new MeshLoader(this);
@@ -43,6 +45,14 @@ namespace Wiley {
 
 	ResourceCache::~ResourceCache()
 	{
+		//Decode tasks capture this, so let the ones still running hand their results over first.
+		gThreadPool.HelpUntil([this]() { return imageTextureDecodesInFlight.load() == 0; });
+		for (DecodedImageTexture& result : decodedImageTextures)
+			result.image.Release();
+
+		for (auto& [id, resource] : resources)
+			UntrackResourceMemory(resource.get());
+
 		delete meshLoader;
 		delete materialLoader;
 		delete imageTextureLoader;
@@ -60,8 +70,166 @@ namespace Wiley {
 		resource->state = resourceDesc.state;
 		resource->type = resourceDesc.type;
 
-		resources[resource->id] = resource;
-		pathMap[resourceDesc.path] = resource->id;
+		//Caching under an id that is already taken drops the old resource.
+		Resource::Ref& slot = resources[resource->id];
+		if (slot)
+			UntrackResourceMemory(slot.get());
+		slot = resource;
+		pathMap[GetPathId(resourceDesc.path)] = resource->id;
+
+		TrackResourceMemory(resource.get());
+
+		resourceLoadedEvent.Post({ resource->id, resource->type });
+	}
+
+	void ResourceCache::LoadImageTextureAsync(filespace::filepath path, const ResourceLoadDesc& loadDesc, ImageTextureLoadedCallback onLoaded)
+	{
+		const StringId pathId = GetPathId(path);
+		if (auto it = pathMap.find(pathId); it != pathMap.end())
+		{
+			if (onLoaded)
+				onLoaded(resources[it->second]);
+			return;
+		}
+
+		if (auto it = pendingImageTextures.find(pathId); it != pendingImageTextures.end())
+		{
+			if (onLoaded)
+				it->second.callbacks.push_back(std::move(onLoaded));
+			return;
+		}
+
+		//DDS textures are created straight from the file, there is nothing to decode off this thread.
+		if (path.extension().string() == ".dds" || !filespace::Exists(path))
+		{
+			ResourceLoadDesc syncLoadDesc = loadDesc;
+			Resource::Ref resource = LoadResource<ImageTexture>(path, syncLoadDesc);
+			if (onLoaded)
+				onLoaded(resource ? resource : GetDefaultImageTexture(loadDesc.desc.imageTextureDesc.type));
+			return;
+		}
+
+		PendingImageTexture& pending = pendingImageTextures.try_emplace(pathId, PendingImageTexture{ path, loadDesc, {} }).first->second;
+		if (onLoaded)
+			pending.callbacks.push_back(std::move(onLoaded));
+
+		imageTextureDecodesInFlight++;
+		gIOService.ReadAsync(path, [this, pathId, flipUV = loadDesc.flipUV](FileBuffer& file) {
+			DecodedImageTexture result{ .pathId = pathId };
+			result.decoded = file && ImageTextureLoader::Decode(file, flipUV, result.image);
+			{
+				std::lock_guard<std::mutex> lock(decodedImageTextureMutex);
+				decodedImageTextures.push_back(result);
+			}
+			imageTextureDecodesInFlight--;
+		});
+	}
+
+	void ResourceCache::FinishImageTextureLoads()
+	{
+		std::vector<DecodedImageTexture> decoded;
+		{
+			std::lock_guard<std::mutex> lock(decodedImageTextureMutex);
+			decoded.swap(decodedImageTextures);
+		}
+
+		for (DecodedImageTexture& result : decoded)
+		{
+			auto it = pendingImageTextures.find(result.pathId);
+			PendingImageTexture pending = std::move(it->second);
+			pendingImageTextures.erase(it);
+
+			Resource::Ref resource = nullptr;
+			if (auto cached = pathMap.find(result.pathId); cached != pathMap.end())
+			{
+				//A synchronous LoadResource got to the same file while it was decoding.
+				result.image.Release();
+				resource = resources[cached->second];
+			}
+			else if (result.decoded)
+			{
+				resource = imageTextureLoader->CreateFromDecoded(result.image, pending.loadDesc);
+				resource->type = ResourceType::ImageTexture;
+
+				ResourceDesc resourceDesc = {
+					.type = ResourceType::ImageTexture,
+					.path = pending.path,
+					.state = ResourceState::SavedOnDisk
+				};
+
+				Cache(resource, resourceDesc, pending.loadDesc.id);
+			}
+			else
+			{
+				std::cout << "Failed to load Image Texture resource. Using default image texture for the specified type." << std::endl;
+				resource = GetDefaultImageTexture(pending.loadDesc.desc.imageTextureDesc.type);
+			}
+
+			for (ImageTextureLoadedCallback& callback : pending.callbacks)
+				callback(resource);
+		}
+	}
+
+	void ResourceCache::DispatchEvents()
+	{
+		FinishImageTextureLoads();
+		resourceLoadedEvent.Dispatch();
+	}
+
+	namespace {
+
+		struct TrackedResourceBytes
+		{
+			size_t resource = 0;
+			size_t texture = 0;
+		};
+
+		/// <summary>
+		///		Bytes a cached resource is charged under the Resources and Textures tags.
+		///		Image textures are always uploaded as RGBA, so their GPU size is estimated from four channels whatever the source had.
+		/// </summary>
+		TrackedResourceBytes GetTrackedResourceBytes(const Resource* resource)
+		{
+			switch (resource->GetType())
+			{
+				case ResourceType::Mesh:
+					return { sizeof(Mesh), 0 };
+				case ResourceType::Material:
+					return { sizeof(Material), 0 };
+				case ResourceType::EnvironmentMap:
+					return { sizeof(EnvironmentMap), 0 };
+				case ResourceType::ImageTexture:
+				{
+					const ImageTexture* texture = static_cast<const ImageTexture*>(resource);
+					constexpr size_t kUploadedChannels = 4;
+					return { sizeof(ImageTexture), static_cast<size_t>(texture->width) * texture->height * kUploadedChannels * texture->bitPerChannel / 8 };
+				}
+				default:
+					return {};
+			}
+		}
+
+	}
+
+	void ResourceCache::TrackResourceMemory(Resource* resource)
+	{
+		const TrackedResourceBytes bytes = GetTrackedResourceBytes(resource);
+		if (bytes.resource > 0)
+			gMemoryTracker.RecordAlloc(MemoryTag::Resources, bytes.resource);
+		if (bytes.texture > 0)
+			gMemoryTracker.RecordAlloc(MemoryTag::Textures, bytes.texture);
+	}
+
+	/// <summary>
+	///		Gives back what TrackResourceMemory recorded. Called when a resource leaves the cache.
+	/// </summary>
+	void ResourceCache::UntrackResourceMemory(Resource* resource)
+	{
+		const TrackedResourceBytes bytes = GetTrackedResourceBytes(resource);
+		if (bytes.resource > 0)
+			gMemoryTracker.RecordFree(MemoryTag::Resources, bytes.resource);
+		if (bytes.texture > 0)
+			gMemoryTracker.RecordFree(MemoryTag::Textures, bytes.texture);
 	}
 
 
@@ -103,7 +271,7 @@ namespace Wiley {
 			defaultMtl->metaillicMap = defaultMetallicMap->GetUUID();
 			defaultMtl->roughnessMap = defaultRoughnessMap->GetUUID();
 
-			MaterialData* defaultMtlData = defaultMtl->dataPtr;
+			MaterialData* defaultMtlData = defaultMtl->GetData();
 			defaultMtlData->albedo.mapIndex = static_cast<ImageTexture*>(defaultAlbedoMap.get())->srvIndex;
 			defaultMtlData->albedo.value = { 0.75f,0.75f,0.75f,1.0f };
 
@@ -186,34 +354,34 @@ namespace Wiley {
 			case MapType::Albedo:
 			{
 				material->albedoMap = imageTextureID;
-				material->dataPtr->albedo.mapIndex = imageTexture->srvIndex;
+				material->GetData()->albedo.mapIndex = imageTexture->srvIndex;
 				return;
 			}
 			case MapType::Normal: {
 				material->normalMap = imageTextureID;
-				material->dataPtr->normal.mapIndex = imageTexture->srvIndex;
+				material->GetData()->normal.mapIndex = imageTexture->srvIndex;
 				return;
 			}
 			case MapType::AO: {
 				material->ambientOcclusionMap = imageTextureID;
-				material->dataPtr->ambientOcclusion.mapIndex = imageTexture->srvIndex;
-				material->dataPtr->ambientOcclusion.valueChannel = channel;
+				material->GetData()->ambientOcclusion.mapIndex = imageTexture->srvIndex;
+				material->GetData()->ambientOcclusion.valueChannel = channel;
 				if (imageTexture->srvIndex == 0 || imageTexture->srvIndex == 3)
 					//WILEY_DEBUGBREAK;
 				return;
 			}
 			case MapType::Metalloic: {
 				material->metaillicMap = imageTextureID;
-				material->dataPtr->metallic.mapIndex = imageTexture->srvIndex;
-				material->dataPtr->metallic.valueChannel = channel;
+				material->GetData()->metallic.mapIndex = imageTexture->srvIndex;
+				material->GetData()->metallic.valueChannel = channel;
 				if (imageTexture->srvIndex == 1 || imageTexture->srvIndex == 2)
 					//WILEY_DEBUGBREAK;
 				return;
 			}
 			case MapType::Roughness: {
 				material->roughnessMap = imageTextureID;
-				material->dataPtr->roughness.mapIndex = imageTexture->srvIndex;
-				material->dataPtr->roughness.valueChannel = channel;
+				material->GetData()->roughness.mapIndex = imageTexture->srvIndex;
+				material->GetData()->roughness.valueChannel = channel;
 				if (imageTexture->srvIndex == 1 || imageTexture->srvIndex == 4)
 					//WILEY_DEBUGBREAK;
 				return;
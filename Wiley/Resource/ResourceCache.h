@@ -4,7 +4,10 @@
 #include "../Core/defines.h"
 #include "../Core/Utils.h"
 #include "../Core/UUID.h"
+#include "../Core/FlatHashMap.h"
+#include "../Core/StringId.h"
 #include "../Core/Allocator.h"
+#include "../Core/DeferredEvent.h"
 
 #include "../RHI/RenderContext.h"
 
@@ -16,9 +19,15 @@
 
 #include <unordered_map>
 #include <queue>
+#include <mutex>
+#include <atomic>
 #include <ranges>
 #include <variant>
+#include <functional>
 
+//The vertex, index and submesh pools are LinearAllocators over mapped upload heaps (External backing), sized once from these maxima.
+//They cannot grow: the renderer's GPU buffers and the render script constants are sized from the same numbers.
+//Pool handles only let Heap and Virtual pools, such as the material data pool, grow and compact.
 #define MAX_VERTEX_COUNT 8'000'000
 #define MAX_INDEX_COUNT  8'000'000
 
@@ -68,6 +77,14 @@ namespace Wiley
 		UUID id = WILEY_INVALID_UUID;
 	};
 
+	struct ResourceLoadedInfo {
+		UUID id;
+		ResourceType type;
+	};
+
+	class ResourceCache;
+	DECLARE_DEFERRED_EVENT(ResourceLoadedEvent, ResourceCache, ResourceLoadedInfo, false);
+
 	class ResourceCache
 	{
 		struct ResourceDesc {
@@ -113,6 +130,20 @@ namespace Wiley
 			template<IsResourceType ResourceClass>
 			Resource::Ref LoadResource(filespace::filepath path, ResourceLoadDesc& loadDesc);
 
+			using ImageTextureLoadedCallback = std::function<void(Resource::Ref)>;
+
+			/// <summary>
+			///		Reads the file on the IOService and decodes it on a compute worker, so the calling thread never waits on disk or stb_image.
+			///		The texture is created and cached by a later DispatchEvents, which then calls onLoaded on that thread
+			///		with the texture, or with the default map for the type if the load failed.
+			///		A path that is already cached calls onLoaded right away and a path already in flight only queues the callback.
+			///		DDS files and missing paths fall back to the synchronous ImageTexture LoadResource.
+			///		Call from the thread that calls DispatchEvents.
+			/// </summary>
+			void LoadImageTextureAsync(filespace::filepath path, const ResourceLoadDesc& loadDesc, ImageTextureLoadedCallback onLoaded = {});
+
+			WILEY_NODISCARD size_t GetPendingImageTextureCount()const { return pendingImageTextures.size(); }
+
 			void Cache(Resource::Ref resource, const ResourceDesc& resourceDesc, const UUID& id);
 
 			template<IsResourceType ResourceClass>
@@ -215,16 +246,44 @@ namespace Wiley
 			}
 
 
+			/// <summary>
+			///		Fires once per cached resource, on the thread that calls DispatchEvents, whichever thread loaded it.
+			/// </summary>
+			ResourceLoadedEvent& GetResourceLoadedEvent() { return resourceLoadedEvent; }
+
+			/// <summary>
+			///		Finishes the image textures decoded since the last call, then delivers the resource loaded events.
+			/// </summary>
+			void DispatchEvents();
+
 			WILEY_NODISCARD bool IsVertexIndexDataDiry()const { return isVertexIndexDataDirty; }
 			void MakeVertexIndexDataDirty() { isVertexIndexDataDirty = true; }
 			void MakeVertexIndexDataClean() { isVertexIndexDataDirty = false; }
 
 
 		private:
+			//Paths are keyed by the hash of their generic form, so "a/b" and "a\b" name the same resource on Windows.
+			static StringId GetPathId(const filespace::filepath& path) { return StringId(path.generic_string()); }
+
 			void LoadDefaultResources();
+			void TrackResourceMemory(Resource* resource);
+			void UntrackResourceMemory(Resource* resource);
 			UINT GetFreeImageDescriptorIndex(ResourceCache::ImageTextureDescriptorManager* manager);
 			ImageTextureDescriptorManager* GetImageTextureDescriptorManager(MapType type);
+			void FinishImageTextureLoads();
 		private:
+			struct PendingImageTexture {
+				filespace::filepath path;
+				ResourceLoadDesc loadDesc;
+				std::vector<ImageTextureLoadedCallback> callbacks;
+			};
+
+			struct DecodedImageTexture {
+				StringId pathId;
+				ImageTextureLoader::DecodedImage image;
+				bool decoded = false;
+			};
+
 			friend class MeshLoader;
 			friend class MaterialLoader;
 			friend class ImageTextureLoader;
@@ -232,8 +291,8 @@ namespace Wiley
 
 			ResourceCacheMeta resourceCacheMeta;
 
-			std::unordered_map<UUID, Resource::Ref> resources;
-			std::unordered_map<filespace::filepath, UUID> pathMap;
+			UUIDMap<Resource::Ref> resources;
+			FlatHashMap<StringId, UUID> pathMap;
 
 
 			RHI::UploadBuffer<Vertex>::Ref vertexUploadBuffer;
@@ -255,16 +314,25 @@ namespace Wiley
 			RHI::RenderContext::Ref rctx;
 
 			bool isVertexIndexDataDirty = true;
+
+			ResourceLoadedEvent resourceLoadedEvent;
+
+			//Async image texture loads. pendingImageTextures is only touched by the dispatching thread,
+			//decode tasks hand their results over through decodedImageTextures.
+			FlatHashMap<StringId, PendingImageTexture> pendingImageTextures;
+			std::mutex decodedImageTextureMutex;
+			std::vector<DecodedImageTexture> decodedImageTextures;
+			std::atomic<size_t> imageTextureDecodesInFlight{ 0 };
 	};
 
 
 	template<>
 	inline Resource::Ref ResourceCache::LoadResource<Mesh>(filespace::filepath path, ResourceLoadDesc& loadDesc)
 	{
-		if (pathMap.find(path) != pathMap.end())
+		if (auto it = pathMap.find(GetPathId(path)); it != pathMap.end())
 		{
 			std::cout << "Resource has already been loaded." << std::endl;
-			return resources[pathMap[path]];
+			return resources[it->second];
 		}
 
 		Resource::Ref resource = meshLoader->LoadFromFile(path, loadDesc);
@@ -292,10 +360,10 @@ namespace Wiley
 	template<>
 	inline Resource::Ref ResourceCache::LoadResource<Material>(filespace::filepath path, ResourceLoadDesc& loadDesc)
 	{
-		if (pathMap.find(path) != pathMap.end())
+		if (auto it = pathMap.find(GetPathId(path)); it != pathMap.end())
 		{
 			std::cout << "Material Resource has already been loaded." << std::endl;
-			return resources[pathMap[path]];
+			return resources[it->second];
 		}
 
 		Resource::Ref resource = materialLoader->LoadFromFile(path, loadDesc);
@@ -325,10 +393,10 @@ namespace Wiley
 	template<>
 	inline Resource::Ref ResourceCache::LoadResource<ImageTexture>(filespace::filepath path, ResourceLoadDesc& loadDesc)
 	{
-		if (pathMap.find(path) != pathMap.end())
+		if (auto it = pathMap.find(GetPathId(path)); it != pathMap.end())
 		{
 			std::cout << "Image Texture Resource has already been loaded." << std::endl;
-			return resources[pathMap[path]];
+			return resources[it->second];
 		}
 
 		if (!filespace::Exists(path)) {
@@ -358,10 +426,10 @@ namespace Wiley
 	template<>
 	inline Resource::Ref ResourceCache::LoadResource<EnvironmentMap>(filespace::filepath path, ResourceLoadDesc& loadDesc)
 	{
-		if (pathMap.find(path) != pathMap.end())
+		if (auto it = pathMap.find(GetPathId(path)); it != pathMap.end())
 		{
 			std::cout << "Environment Map Resource has already been loaded." << std::endl;
-			return resources[pathMap[path]];
+			return resources[it->second];
 		}
 
 		if (!filespace::Exists(path)) {
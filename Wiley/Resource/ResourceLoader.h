@@ -16,6 +16,7 @@
 namespace Wiley {
 	
 	struct ResourceLoadDesc;
+	struct FileBuffer;
 
 	class MeshLoader 
 	{
@@ -52,10 +53,32 @@ namespace Wiley {
 
 	class ImageTextureLoader {
 		public:
+			/// <summary>
+			///		Pixels decoded by stb_image, always 4 channels. Owned until CreateFromDecoded or Release frees them.
+			/// </summary>
+			struct DecodedImage {
+				void* pixels = nullptr;
+				int width = 0;
+				int height = 0;
+				int bitPerChannel = 8;
+
+				void Release();
+			};
+
 			ImageTextureLoader(ResourceCache* resourceCache);
 
 			Resource::Ref LoadFromFile(filespace::filepath path, ResourceLoadDesc& loadDesc);
 
+			/// <summary>
+			///		Decodes an image file already in memory. Touches no GPU or cache state, so it can run on any worker.
+			/// </summary>
+			static bool Decode(const FileBuffer& file, bool flipUV, DecodedImage& image);
+
+			/// <summary>
+			///		Creates the texture and its SRV from decoded pixels and frees them. Must run on the render thread.
+			/// </summary>
+			Resource::Ref CreateFromDecoded(DecodedImage& image, const ResourceLoadDesc& loadDesc);
+
 			Resource::Ref LoadFromDDSFile(filespace::filepath path, ResourceLoadDesc& loadDesc);
 
 			void SaveToFile(filespace::filepath path, ImageTexture* imageTexture);
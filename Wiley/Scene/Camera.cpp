@@ -202,6 +202,11 @@ namespace Wiley {
 		return DirectX::XMMatrixTranspose(DirectX::XMMatrixInverse(&determinant, vp));
 	}
 
+	FrustumPlanes Camera::GetFrustumPlanes() const
+	{
+		return ExtractFrustumPlanes(DirectX::XMMatrixMultiply(view, projection));
+	}
+
 	bool Camera::IsChanged() const
 	{
 		return isChanged;
@@ -1,5 +1,6 @@
 #pragma once
 #include "../Core/Input.h"
+#include "../Core/FrustumCulling.h"
 
 #include <DirectXMath.h>
 
@@ -84,6 +85,11 @@ namespace Wiley {
 
 			DirectX::XMMATRIX GetInverseViewProjection()const;
 
+			/// <summary>
+			///		Returns the world-space planes of the view frustum, for CPU culling.
+			/// </summary>
+			FrustumPlanes GetFrustumPlanes()const;
+
 			bool IsChanged()const;
 		private:
 			void ComputeDirectionVectors();
@@ -9,6 +9,8 @@
 #include <Windows.h>
 #include <MathHelper.h>
 
+#include "entt.hpp"
+
 namespace Wiley {
 
 	struct TagComponent {
@@ -22,6 +24,11 @@ namespace Wiley {
 		}
 	};
 
+	/// <summary>
+	///		position, rotation (degrees) and scale are relative to the parent in HierarchyComponent, or to the world for roots.
+	///		modelMatrix is the transposed world matrix, rebuilt by TransformSystem only for dirty entities and their descendants.
+	///		Writing the fields directly is fine as long as MarkDirty is called afterwards, the setters do both.
+	/// </summary>
 	struct TransformComponent {
 		DirectX::XMFLOAT3 localPosition = { 0.0f,0.0f,0.0f };
 
@@ -35,6 +42,28 @@ namespace Wiley {
 			0.0f, 0.0f, 1.0f, 0.0f,
 			0.0f, 0.0f, 0.0f, 1.0f
 		};
+
+		//New components start dirty so their first matrix gets built.
+		bool isDirty = true;
+
+		void SetPosition(const DirectX::XMFLOAT3& value) { position = value; isDirty = true; }
+		void SetRotation(const DirectX::XMFLOAT3& value) { rotation = value; isDirty = true; }
+		void SetScale(const DirectX::XMFLOAT3& value) { scale = value; isDirty = true; }
+		void MarkDirty() { isDirty = true; }
+	};
+
+	/// <summary>
+	///		Parent link and intrusive child list. Only entities that are, or have been, part of a hierarchy carry one.
+	///		Edit it through Scene::SetParent, which keeps depth and the sibling links consistent.
+	/// </summary>
+	struct HierarchyComponent {
+		entt::entity parent = entt::null;
+		entt::entity firstChild = entt::null;
+		entt::entity nextSibling = entt::null;
+		entt::entity prevSibling = entt::null;
+
+		//Number of ancestors. TransformSystem updates level by level so parents are final before their children.
+		uint32_t depth = 0;
 	};
 
 	/// <summary>
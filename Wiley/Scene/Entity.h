@@ -47,6 +47,20 @@ namespace Wiley
 				return GetComponent<TransformComponent>().modelMatrix;
 			}
 
+			/// <summary>
+			///		Passing a default constructed Entity detaches this one and makes it a root.
+			/// </summary>
+			bool SetParent(Entity parent) {
+				return parentScene->SetParent(entity, parent.entity);
+			}
+
+			WILEY_NODISCARD Entity GetParent() {
+				const HierarchyComponent* node = parentScene->registery.try_get<HierarchyComponent>(entity);
+				if (!node || node->parent == entt::null)
+					return {};
+				return { node->parent, parentScene };
+			}
+
 
 
 			WILEY_NODISCARD bool IsActive()const {
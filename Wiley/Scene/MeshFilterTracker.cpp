@@ -0,0 +1,75 @@
+#include "MeshFilterTracker.h"
+#include "Component.h"
+
+#include "../Core/Parallel.h"
+
+#include <algorithm>
+
+namespace Wiley
+{
+	void MeshFilterTracker::Connect(entt::registry& registry, size_t maxMeshFilterCount)
+	{
+		this->registry = &registry;
+		uploadDirty.Resize(maxMeshFilterCount);
+		boundsDirty.Resize(maxMeshFilterCount);
+		registry.on_construct<MeshFilterComponent>().connect<&MeshFilterTracker::OnMeshFilterChanged>(this);
+		registry.on_update<MeshFilterComponent>().connect<&MeshFilterTracker::OnMeshFilterChanged>(this);
+		registry.on_destroy<MeshFilterComponent>().connect<&MeshFilterTracker::OnMeshFilterDestroyed>(this);
+	}
+
+	void MeshFilterTracker::WriteChangedTransforms(std::span<const entt::entity> changedTransforms, SubMeshData* subMeshData, DirtyRangeTracker& subMeshDataDirty)
+	{
+		auto view = registry->view<MeshFilterComponent, TransformComponent>();
+
+		//Only entities whose world matrix changed this frame are rewritten, and only their slots are marked for upload.
+		//Each mesh filter owns a disjoint [subMeshDataOffset, subMeshDataOffset + subMeshCount) range.
+		//Their world bounds are flagged too; the scene recomputes them when the renderer culls.
+		ParallelFor(changedTransforms, 128, [this, &view, subMeshData, &subMeshDataDirty](entt::entity entt)
+		{
+			if (!view.contains(entt))
+				return;
+
+			const MeshFilterComponent& meshFilter = view.get<MeshFilterComponent>(entt);
+			const TransformComponent& transform = view.get<TransformComponent>(entt);
+
+			std::span<SubMeshData> subMeshDataSpan(subMeshData + meshFilter.subMeshDataOffset, meshFilter.subMeshCount);
+			std::for_each(subMeshDataSpan.begin(), subMeshDataSpan.end(), [&](SubMeshData& data) {
+				data.modelMatrix = transform.modelMatrix;
+			});
+			subMeshDataDirty.MarkDirty(meshFilter.subMeshDataOffset, meshFilter.subMeshCount);
+			MarkBoundsDirty(entt);
+		});
+	}
+
+	void MeshFilterTracker::MarkBoundsDirty(entt::entity entity)
+	{
+		boundsDirty.MarkDirty(registry->storage<MeshFilterComponent>().index(entity));
+	}
+
+	uint64_t MeshFilterTracker::ConsumeUploadRanges(std::vector<DirtyRange>& ranges)
+	{
+		return uploadDirty.Consume(ranges, sizeof(MeshFilterComponent));
+	}
+
+	void MeshFilterTracker::ConsumeBoundsRanges(std::vector<DirtyRange>& ranges)
+	{
+		boundsDirty.Consume(ranges, 1);
+	}
+
+	void MeshFilterTracker::OnMeshFilterChanged(entt::registry& registry, entt::entity entity)
+	{
+		const size_t index = registry.storage<MeshFilterComponent>().index(entity);
+		uploadDirty.MarkDirty(index);
+		boundsDirty.MarkDirty(index);
+	}
+
+	void MeshFilterTracker::OnMeshFilterDestroyed(entt::registry& registry, entt::entity entity)
+	{
+		//Removal swaps the last component into this slot, so both change.
+		const auto& storage = registry.storage<MeshFilterComponent>();
+		uploadDirty.MarkDirty(storage.index(entity));
+		uploadDirty.MarkDirty(storage.size() - 1);
+		boundsDirty.MarkDirty(storage.index(entity));
+	}
+
+}
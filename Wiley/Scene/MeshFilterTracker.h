@@ -0,0 +1,68 @@
+#pragma once
+#include "../Core/DirtyRangeTracker.h"
+
+#include "entt.hpp"
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+namespace Wiley {
+
+	struct SubMeshData;
+
+	/// <summary>
+	///		Tracks which mesh filters have to reach the GPU again. Component changes are caught through the registry's signals
+	///		and marked by storage index, so the renderer copies only the MeshFilterComponent slots that changed.
+	///		Moved entities are written into their sub-mesh slots by WriteChangedTransforms, which marks those slots and the world bounds.
+	///		Needs no device, so the upload volume can be measured without a renderer.
+	/// </summary>
+	class MeshFilterTracker
+	{
+	public:
+		MeshFilterTracker() = default;
+
+		MeshFilterTracker(const MeshFilterTracker&) = delete;
+		MeshFilterTracker& operator=(const MeshFilterTracker&) = delete;
+
+		/// <summary>
+		///		Starts listening to the MeshFilterComponent signals of registry, tracking up to maxMeshFilterCount slots.
+		///		registry must outlive the tracker.
+		/// </summary>
+		void Connect(entt::registry& registry, size_t maxMeshFilterCount);
+
+		/// <summary>
+		///		Copies the world matrix of every changed entity that has a mesh filter into its sub-mesh slots of subMeshData,
+		///		marks those slots in subMeshDataDirty and flags the world bounds. Each mesh filter owns a disjoint range, so entities run in parallel.
+		/// </summary>
+		void WriteChangedTransforms(std::span<const entt::entity> changedTransforms, SubMeshData* subMeshData, DirtyRangeTracker& subMeshDataDirty);
+
+		/// <summary>
+		///		Flags the world bounds of entity's mesh filter for recomputation. Safe to call from any system job.
+		/// </summary>
+		void MarkBoundsDirty(entt::entity entity);
+
+		/// <summary>
+		///		Appends the byte ranges of the MeshFilterComponent storage that changed since the last call and clears them.
+		///		Returns the total number of bytes appended.
+		/// </summary>
+		uint64_t ConsumeUploadRanges(std::vector<DirtyRange>& ranges);
+
+		/// <summary>
+		///		Appends the storage indices, not bytes, whose world bounds were flagged since the last call and clears them.
+		/// </summary>
+		void ConsumeBoundsRanges(std::vector<DirtyRange>& ranges);
+
+	private:
+		void OnMeshFilterChanged(entt::registry& registry, entt::entity entity);
+		void OnMeshFilterDestroyed(entt::registry& registry, entt::entity entity);
+
+	private:
+		entt::registry* registry = nullptr;
+
+		//Consumed by the upload, never sees transform changes; the bounds keep their own marks.
+		DirtyRangeTracker uploadDirty;
+		DirtyRangeTracker boundsDirty;
+	};
+
+}
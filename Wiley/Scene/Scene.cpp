@@ -8,6 +8,8 @@
 #include "Systems/MeshFilterSystem.h"
 #include "Systems/LightComponentSystem.h"
 
+#include "../Core/Parallel.h"
+
 #include <algorithm>
 #include <execution>
 #include <span>
@@ -21,7 +23,7 @@ namespace Wiley
 	Scene::Scene(RHI::RenderContext::Ref rctx, Renderer3D::ShadowMapManager::Ref shadowMapManager)
 		:shadowMapManager(shadowMapManager)
 	{
-		ZoneScopedN("Scene::Scene");
+		TraceZoneN("Scene::Scene");
 
 		camera = std::make_shared<Camera>();
 		resourceCache = std::make_shared<ResourceCache>(rctx);
@@ -32,19 +34,24 @@ namespace Wiley
 			environment.doIBL = false;
 		}
 
-		subMeshDataBuffer = rctx->CreateUploadBuffer<SubMeshData>(WILEY_BUFFER_SIZE_BYTES(SubMeshData, MAX_SUBMESH_COUNT), WILEY_SIZEOF(SubMeshData), "SubMeshDataUploadBuffer");
+		subMeshDataBuffer = rctx->CreateUploadBuffer<SubMeshData>(WILEY_BUFFER_SIZE_BYTES(SubMeshData, MAX_SUBMESH_COUNT), WILEY_SIZEOF(SubMeshData), "SubMeshDataUploadBuffer", MemoryTag::SceneData);
+
+		//Every change to the mesh filter storage goes through these, so the renderer only re-uploads the slots that moved.
+		meshFilterTracker.Connect(registery, MAX_MESH_COUNT);
 
 		{
-			systems.emplace_back(std::make_unique<TransformSystem>(this));
-			systems.emplace_back(std::make_unique<MeshFilterSystem>(this));
-			systems.emplace_back(std::make_unique<LightComponentSystem>(this));
+			//Registration order breaks ties between conflicting systems. Light matrices share nothing with the
+			//transform chain, so LightComponentSystem runs alongside it.
+			transformSystem = static_cast<TransformSystem*>(systemScheduler.AddSystem(std::make_unique<TransformSystem>(this)));
+			systemScheduler.AddSystem(std::make_unique<MeshFilterSystem>(this));
+			systemScheduler.AddSystem(std::make_unique<LightComponentSystem>(this));
 		}
 
 
 		auto defaultMaterial = static_cast<Material*>(resourceCache->GetDefaultMaterial().get());
 
 		{
-			ZoneScopedN("Scene->TestLights");
+			TraceZoneN("Scene->TestLights");
 
 			{
 				auto testP = AddLight("TestPointLight", LightType::Point);
@@ -68,7 +75,7 @@ namespace Wiley
 
 		if(0)
 		{
-			ZoneScopedN("LoadStressTest");
+			TraceZoneN("LoadStressTest");
 
 			
 			ResourceLoadDesc loadDesc{};
@@ -93,11 +100,11 @@ namespace Wiley
 					{
 						Entity sphere = AddModel("P:/Projects/VS/Wiley/Wiley/Assets/Models/Cylinder.obj", loadDesc);
 						auto& transform = sphere.GetComponent<TransformComponent>();
-						transform.position = {
+						transform.SetPosition({
 							x * spacing - offsetX,
 							y * spacing - offsetY,
 							z * spacing - offsetZ
-						};
+						});
 
 						AssignGlobalDefaultMaterial(sphere);
 						
@@ -110,7 +117,7 @@ namespace Wiley
 
 	Scene::~Scene()
 	{
-		ZoneScopedN("Scene::~Scene");
+		TraceZoneN("Scene::~Scene");
 #ifdef _DEBUG
 		std::cout << "Scene Owned Object RefCount => OnDTOR\n";
 		std::cout << "Camera::Ref " << camera.use_count() << std::endl;
@@ -124,15 +131,17 @@ namespace Wiley
 		registery.clear();
 	}
 
-	void Scene::OnUpdate()
+	void Scene::OnUpdate(float dt)
 	{
-		ZoneScopedN("Scene::OnUpdate");
+		TraceZoneN("Scene::OnUpdate");
 
-		camera->Update(0.1f);
+		camera->Update(dt);
 
-		std::for_each(systems.begin(), systems.end(), [&](const ISystem::Ptr& system) {
-			system->OnUpdate(0.1f);
-			});
+		//Sync point for notifications posted from other threads since the last frame.
+		resourceCache->DispatchEvents();
+		shadowMapManager->DispatchDirtyNotifications();
+
+		systemScheduler.Run(dt);
 
 		//Reset Dirty Flags
 		{
@@ -143,7 +152,7 @@ namespace Wiley
 
 	void Scene::OnResize(uint32_t width, uint32_t height)
 	{
-		ZoneScopedN("Scene::OnResize");
+		TraceZoneN("Scene::OnResize");
 
 		if (width == 0 || height == 0) {
 			return;
@@ -164,7 +173,7 @@ namespace Wiley
 	/// </summary>
 	Entity& Wiley::Scene::AddEntity(const std::string name)
 	{
-		ZoneScopedN("Scene::AddEntity");
+		TraceZoneN("Scene::AddEntity");
 
 		entities.push_back({ registery.create(), this });
 		Entity& entity = entities.back();
@@ -177,7 +186,7 @@ namespace Wiley
 
 	Entity& Scene::AddModel(std::filesystem::path path, ResourceLoadDesc& loadDesc)
 	{
-		ZoneScopedN("Scene::AddModel");
+		TraceZoneN("Scene::AddModel");
 
 		Resource::Ref resource = resourceCache->LoadResource<Mesh>(path, loadDesc);
 		Mesh& mesh = *(static_cast<Mesh*>(resource.get()));
@@ -196,7 +205,6 @@ namespace Wiley
 
 		Material::Ref defaultMaterialResource = resourceCache->GetDefaultMaterial();
 		Material* defaultMaterial = static_cast<Material*>(defaultMaterialResource.get());
-		MaterialData* mtlDataPoolBasePtr = static_cast<MaterialData*>(resourceCache->GetMaterialDataPool()->GetBasePtr());
 
 		MemoryBlock<SubMeshData> memoryBlk = subMeshDataBuffer->Allocate(meshFilter.subMeshCount);
 		meshFilter.subMeshDataOffset = memoryBlk.data() - (SubMeshData*)subMeshDataBuffer->GetBasePointer();
@@ -219,7 +227,7 @@ namespace Wiley
 
 	Entity& Scene::AddLight(const std::string name, LightType type)
 	{
-		ZoneScopedN("Scene::AddLight");
+		TraceZoneN("Scene::AddLight");
 
 		Entity& entity = AddEntity(name);
 
@@ -246,9 +254,77 @@ namespace Wiley
 		return entities.back();
 	}
 
+	bool Scene::SetParent(entt::entity child, entt::entity parent)
+	{
+		TraceZoneN("Scene::SetParent");
+
+		//Walking up from the new parent catches both self-parenting and cycles.
+		for (entt::entity ancestor = parent; ancestor != entt::null;)
+		{
+			if (ancestor == child)
+				return false;
+			const HierarchyComponent* node = registery.try_get<HierarchyComponent>(ancestor);
+			ancestor = node ? node->parent : entt::null;
+		}
+
+		//Emplace both before taking references, adding to the storage can move its elements.
+		registery.get_or_emplace<HierarchyComponent>(child);
+		if (parent != entt::null)
+			registery.get_or_emplace<HierarchyComponent>(parent);
+
+		HierarchyComponent& childNode = registery.get<HierarchyComponent>(child);
+		if (childNode.parent != entt::null)
+		{
+			HierarchyComponent& oldParent = registery.get<HierarchyComponent>(childNode.parent);
+			if (oldParent.firstChild == child)
+				oldParent.firstChild = childNode.nextSibling;
+			if (childNode.prevSibling != entt::null)
+				registery.get<HierarchyComponent>(childNode.prevSibling).nextSibling = childNode.nextSibling;
+			if (childNode.nextSibling != entt::null)
+				registery.get<HierarchyComponent>(childNode.nextSibling).prevSibling = childNode.prevSibling;
+		}
+
+		childNode.parent = parent;
+		childNode.prevSibling = entt::null;
+		childNode.nextSibling = entt::null;
+		childNode.depth = 0;
+
+		if (parent != entt::null)
+		{
+			HierarchyComponent& parentNode = registery.get<HierarchyComponent>(parent);
+			childNode.nextSibling = parentNode.firstChild;
+			if (parentNode.firstChild != entt::null)
+				registery.get<HierarchyComponent>(parentNode.firstChild).prevSibling = child;
+			parentNode.firstChild = child;
+			childNode.depth = parentNode.depth + 1;
+		}
+
+		//Depth is cached per node, so the whole moved subtree has to be renumbered.
+		std::vector<entt::entity> stack{ childNode.firstChild };
+		while (!stack.empty())
+		{
+			entt::entity node = stack.back();
+			stack.pop_back();
+
+			while (node != entt::null)
+			{
+				HierarchyComponent& current = registery.get<HierarchyComponent>(node);
+				current.depth = registery.get<HierarchyComponent>(current.parent).depth + 1;
+				if (current.firstChild != entt::null)
+					stack.push_back(current.firstChild);
+				node = current.nextSibling;
+			}
+		}
+
+		if (TransformComponent* transform = registery.try_get<TransformComponent>(child))
+			transform->MarkDirty();
+
+		return true;
+	}
+
 	void Scene::AssignGlobalMaterial(Entity entity, UUID materialUUID)
 	{
-		ZoneScopedN("Scene::AssignGlobalMaterial");
+		TraceZoneN("Scene::AssignGlobalMaterial");
 
 
 		auto materialResource = resourceCache->GetResource<Material>(materialUUID);
@@ -257,10 +333,7 @@ namespace Wiley
 			return;
 		}
 
-		const auto materialDataBase = (MaterialData*)resourceCache->GetMaterialDataPool()->GetBasePtr();
-		const auto materialDataPtr = materialResource->dataPtr;
-
-		const UINT materialDataIndex = materialDataPtr - materialDataBase;
+		const UINT materialDataIndex = materialResource->GetDataIndex();
 
 		auto subMeshDataBase = (SubMeshData*)subMeshDataBuffer->GetBasePointer();
 
@@ -268,8 +341,9 @@ namespace Wiley
 		for (int i = 0; i < meshFilter.subMeshCount; i++)
 		{
 			auto& subMeshData = subMeshDataBase[meshFilter.subMeshDataOffset + i];
-			subMeshData.materialDataIndex = materialDataPtr - materialDataBase;
+			subMeshData.materialDataIndex = materialDataIndex;
 		}
+		subMeshDataBuffer->MarkDirty(meshFilter.subMeshDataOffset, meshFilter.subMeshCount);
 
 		{
 			auto& entityMaterialList = subMeshMaterialMap[entity.GetUUID()];
@@ -286,17 +360,14 @@ namespace Wiley
 
 	void Scene::AssignMaterial(Entity entity, UUID materialUUID, int subMeshIndex)
 	{
-		ZoneScopedN("Scene::AssignMaterial");
+		TraceZoneN("Scene::AssignMaterial");
 
 		auto materialResource = resourceCache->GetResource<Material>(materialUUID);
 		if (!materialResource) {
 			return;
 		}
 
-		const auto materialDataBase = (MaterialData*)resourceCache->GetMaterialDataPool()->GetBasePtr();
-		const auto materialDataPtr = materialResource->dataPtr;
-
-		const UINT materialDataIndex = materialDataPtr - materialDataBase;
+		const UINT materialDataIndex = materialResource->GetDataIndex();
 
 		auto subMeshDataBase = (SubMeshData*)subMeshDataBuffer->GetBasePointer();
 
@@ -305,7 +376,8 @@ namespace Wiley
 			return;
 
 		auto& subMeshData = subMeshDataBase[meshFilter.subMeshDataOffset + subMeshIndex];
-		subMeshData.materialDataIndex = materialDataPtr - materialDataBase;
+		subMeshData.materialDataIndex = materialDataIndex;
+		subMeshDataBuffer->MarkDirty(meshFilter.subMeshDataOffset + subMeshIndex);
 
 		{
 			auto& entityMaterialList = subMeshMaterialMap[entity.GetUUID()];
@@ -336,4 +408,49 @@ namespace Wiley
 		return subMeshDataBuffer;
 	}
 
+	uint64_t Scene::ConsumeMeshFilterDirtyRanges(std::vector<DirtyRange>& ranges)
+	{
+		return meshFilterTracker.ConsumeUploadRanges(ranges);
+	}
+
+	void Scene::MarkMeshFilterBoundsDirty(entt::entity entity)
+	{
+		meshFilterTracker.MarkBoundsDirty(entity);
+	}
+
+	const PackedBounds& Scene::UpdateMeshFilterBounds()
+	{
+		TraceZoneN("Scene::UpdateMeshFilterBounds");
+
+		const auto& meshFilters = registery.storage<MeshFilterComponent>();
+		const auto& transforms = registery.storage<TransformComponent>();
+		meshFilterBounds.Resize(meshFilters.size());
+
+		//Consumed as element indices. The bounds are recomputed here rather than in the signals because
+		//a new MeshFilterComponent gets its aabb only after construction (see AddModel).
+		boundsRanges.clear();
+		meshFilterTracker.ConsumeBoundsRanges(boundsRanges);
+		for (const DirtyRange& range : boundsRanges)
+		{
+			const size_t begin = static_cast<size_t>(range.offset);
+			const size_t end = std::min(static_cast<size_t>(range.offset + range.size), meshFilters.size());
+			if (begin >= end)
+				continue;
+
+			ParallelFor(begin, end, size_t(256), [this, &meshFilters, &transforms](size_t index)
+			{
+				const entt::entity entity = meshFilters.data()[index];
+				if (!transforms.contains(entity)) {
+					meshFilterBounds.SetUnbounded(index);
+					return;
+				}
+
+				const AABB& aabb = meshFilters.get(entity).aabb;
+				meshFilterBounds.SetBounds(index, aabb.min, aabb.max, transforms.get(entity).modelMatrix);
+			});
+		}
+
+		return meshFilterBounds;
+	}
+
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "Systems/TransformSystem.h"
 #include "Systems/MeshFilterSystem.h"
+#include "Systems/SystemScheduler.h"
 
 #include "../Resource/Geometry.h"
 #include "../Resource/ResourceCache.h"
@@ -10,14 +11,19 @@
 
 #include "../Renderer/ShadowMapManager.h"
 
+#include "../Core/FrameAllocator.h"
+#include "../Core/DirtyRangeTracker.h"
+#include "../Core/FrustumCulling.h"
 
 #include "Camera.h"
 #include "Component.h"
+#include "MeshFilterTracker.h"
 
 #include "entt.hpp"
 
 #include <memory>
 #include <vector>
+#include <span>
 
 #include <Windows.h>
 
@@ -51,7 +57,7 @@ namespace Wiley
 		Scene(RHI::RenderContext::Ref rctx, Renderer3D::ShadowMapManager::Ref shadowMapManager);
 		~Scene();
 
-		void OnUpdate();
+		void OnUpdate(float dt);
 		void OnResize(uint32_t width, uint32_t height);
 
 		static Scene::Ref CreateScene(RHI::RenderContext::Ref rctx, Renderer3D::ShadowMapManager::Ref shadowMapManager);
@@ -61,9 +67,9 @@ namespace Wiley
 
 		Entity& AddLight(const std::string name, LightType type);
 		template<typename ...Components>
-		std::vector<Entity> GetEntitiesWith()
+		FrameVector<Entity> GetEntitiesWith()
 		{
-			std::vector<Entity> ents;
+			FrameVector<Entity> ents;
 			auto view = registery.view<Components...>();
 
 			for (auto entity : view) {
@@ -72,6 +78,18 @@ namespace Wiley
 			return ents;
 		}
 
+		/// <summary>
+		///		Moves child under parent, or makes it a root when parent is entt::null. The child's transform stays relative,
+		///		so from the next update it follows its new parent. Returns false if parent is the child or one of its descendants.
+		/// </summary>
+		bool SetParent(entt::entity child, entt::entity parent);
+
+		/// <summary>
+		///		Entities whose world matrix changed during this frame's transform update, parents before children.
+		///		Systems that run after TransformSystem can use it to touch only what moved.
+		/// </summary>
+		std::span<const entt::entity> GetChangedTransforms()const { return transformSystem->GetChangedEntities(); }
+
 		void AssignGlobalMaterial(Entity entity, UUID materialUUID);
 		void AssignGlobalDefaultMaterial(Entity entity);
 
@@ -83,6 +101,8 @@ namespace Wiley
 			return registery.view<Components...>();
 		}
 
+		entt::registry& GetRegistry() { return registery; }
+
 		template<typename Component>
 		Component* GetComponentStorage() {
 			auto& sto = registery.storage<Component>();
@@ -111,6 +131,25 @@ namespace Wiley
 		std::shared_ptr<ResourceCache> GetResourceCache()const { return resourceCache; }
 
 		RHI::UploadBuffer<SubMeshData>::Ref& GetSubMeshDataUploadBuffer();
+		MeshFilterTracker& GetMeshFilterTracker() { return meshFilterTracker; }
+
+		/// <summary>
+		///		Appends the byte ranges of the MeshFilterComponent storage that changed since the last call and clears them.
+		///		Offsets are relative to GetComponentStorage<MeshFilterComponent>(), the layout the GPU mesh filter buffer mirrors.
+		///		Returns the total number of bytes appended.
+		/// </summary>
+		uint64_t ConsumeMeshFilterDirtyRanges(std::vector<DirtyRange>& ranges);
+
+		/// <summary>
+		///		Flags the world bounds of entity's mesh filter for recomputation. Safe to call from any system job.
+		/// </summary>
+		void MarkMeshFilterBoundsDirty(entt::entity entity);
+
+		/// <summary>
+		///		Recomputes the world-space bounds of every mesh filter whose component or transform changed since the last call and returns all of them,
+		///		indexed like the MeshFilterComponent storage. Call once per frame after OnUpdate, before culling.
+		/// </summary>
+		const PackedBounds& UpdateMeshFilterBounds();
 
 		bool IsCameraDirty()const { return sceneFlags.isCameraDirty; }
 		bool IsWindowResize()const { return sceneFlags.isWindowResize; }
@@ -123,20 +162,27 @@ namespace Wiley
 		std::vector<Entity>& GetEntities() { return entities; }
 
 		Renderer3D::ShadowMapManager::Ref GetShadowMapManager()const { return shadowMapManager; }
+		const SystemScheduler& GetSystemScheduler()const { return systemScheduler; }
 	private:
 		friend class Entity;
 		entt::registry registery;
 
 		std::vector<Entity> entities;
-		std::vector<ISystem::Ptr> systems;
+		SystemScheduler systemScheduler;
+		TransformSystem* transformSystem = nullptr;
 
 		Camera::Ref camera;
 		Environment environment;
 
 		std::shared_ptr<ResourceCache> resourceCache;
 		RHI::UploadBuffer<SubMeshData>::Ref subMeshDataBuffer;
+		MeshFilterTracker meshFilterTracker;
+
+		//World bounds are rebuilt lazily from the tracker's bounds marks.
+		PackedBounds meshFilterBounds;
+		std::vector<DirtyRange> boundsRanges;
 
-		std::unordered_map<UUID, std::vector<UUID>> subMeshMaterialMap;
+		UUIDMap<std::vector<UUID>> subMeshMaterialMap;
 
 		struct SceneFlags {
 			bool isCameraDirty = true; //Has any camera parameter been changed?
@@ -1,8 +1,76 @@
 #pragma once
+#include "../../Core/StringId.h"
+
+#include "entt.hpp"
+
 #include <memory>
+#include <vector>
+#include <algorithm>
 
 namespace Wiley {
 
+	/// <summary>
+	///		State that systems share outside the registry. Two systems that name the same resource are ordered like a component conflict.
+	/// </summary>
+	namespace SystemResources {
+		constexpr StringId SubMeshData = "SubMeshData";
+		constexpr StringId LightProjections = "LightProjections";
+		constexpr StringId Camera = "Camera";
+		constexpr StringId MeshFilterBounds = "MeshFilterBounds";
+		//TransformSystem's list of entities whose world matrix changed, read through Scene::GetChangedTransforms.
+		constexpr StringId ChangedTransforms = "ChangedTransforms";
+	}
+
+	/// <summary>
+	///		What a system touches during OnUpdate. Components are keyed by their EnTT type id, everything else by a SystemResources id.
+	///		Writing implies reading. The scheduler only orders two systems when one of them writes something the other touches.
+	/// </summary>
+	class SystemAccess {
+	public:
+		template<typename Component>
+		SystemAccess& Read() { AddUnique(componentReads, entt::type_hash<Component>::value()); return *this; }
+
+		template<typename Component>
+		SystemAccess& Write() { AddUnique(componentWrites, entt::type_hash<Component>::value()); return *this; }
+
+		SystemAccess& ReadResource(StringId resource) { AddUnique(resourceReads, resource); return *this; }
+		SystemAccess& WriteResource(StringId resource) { AddUnique(resourceWrites, resource); return *this; }
+
+		bool ConflictsWith(const SystemAccess& other)const
+		{
+			return WritesAny(componentWrites, other.componentReads, other.componentWrites) ||
+				WritesAny(other.componentWrites, componentReads, componentWrites) ||
+				WritesAny(resourceWrites, other.resourceReads, other.resourceWrites) ||
+				WritesAny(other.resourceWrites, resourceReads, resourceWrites);
+		}
+
+	private:
+		template<typename T>
+		static void AddUnique(std::vector<T>& ids, T id)
+		{
+			if (std::find(ids.begin(), ids.end(), id) == ids.end())
+				ids.push_back(id);
+		}
+
+		template<typename T>
+		static bool WritesAny(const std::vector<T>& writes, const std::vector<T>& reads, const std::vector<T>& otherWrites)
+		{
+			for (const T& id : writes)
+			{
+				if (std::find(reads.begin(), reads.end(), id) != reads.end() ||
+					std::find(otherWrites.begin(), otherWrites.end(), id) != otherWrites.end())
+					return true;
+			}
+			return false;
+		}
+
+	private:
+		std::vector<entt::id_type> componentReads;
+		std::vector<entt::id_type> componentWrites;
+		std::vector<StringId> resourceReads;
+		std::vector<StringId> resourceWrites;
+	};
+
 	class Scene;
 	class ISystem {
 	public:
@@ -12,9 +80,19 @@ namespace Wiley {
 		{
 
 		}
+		virtual ~ISystem() = default;
+
 		virtual void OnUpdate(float dt) = 0;
+
+		/// <summary>
+		///		Lists everything OnUpdate reads or writes. Anything left out can race with systems the scheduler runs alongside this one.
+		/// </summary>
+		virtual void DeclareAccess(SystemAccess& access)const = 0;
+
+		//Must outlive the system, used as the timing and trace label.
+		virtual const char* GetName()const = 0;
 	protected:
 		Scene* scene;
 	};
 
-}
\ No newline at end of file
+}
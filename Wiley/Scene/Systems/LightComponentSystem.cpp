@@ -1,6 +1,7 @@
 #include "LightComponentSystem.h"
 #include "../Entity.h"
 #include "../Core/MathConstants.h"
+#include "../../Core/Parallel.h"
 
 //Todo: No need to run this every frame.
 
@@ -27,18 +28,25 @@ namespace Wiley {
         }
     }
 
+    void LightComponentSystem::DeclareAccess(SystemAccess& access)const
+    {
+        //Light matrices only depend on the light itself and, for directional cascades, the camera.
+        access.Read<LightComponent>().ReadResource(SystemResources::Camera).WriteResource(SystemResources::LightProjections);
+    }
+
 	void LightComponentSystem::OnUpdate(float dt)
 	{
         const auto smm = scene->GetShadowMapManager();
         
         if (smm->IsAllLightEntityDirty()) {
 
+            //Each light writes only its own matrixIndex slots so they can be computed independently.
             auto entts = scene->GetEntitiesWith<LightComponent>();
-            for (auto& entt : entts)
+            ParallelFor(entts, 4, [this](Entity& entt)
             {
                 auto& light = entt.GetComponent<LightComponent>();
                 Execute(&light);
-            }
+            });
             //If all lights are dirty then everything is going to end up being cleaned so no need to go through the lists.
             return;
         }
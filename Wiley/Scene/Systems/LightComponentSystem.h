@@ -12,6 +12,8 @@ namespace Wiley {
 
 		}
 		virtual void OnUpdate(float dt)override;
+		virtual void DeclareAccess(SystemAccess& access)const override;
+		virtual const char* GetName()const override { return "LightComponentSystem"; }
 	private:
 		void Execute(void* data);
 		void ComputeDirectionalLightViewProjections(void* lightComponent);
@@ -3,22 +3,17 @@
 
 namespace Wiley
 {
-	void MeshFilterSystem::OnUpdate(float dt)
+	void MeshFilterSystem::DeclareAccess(SystemAccess& access)const
 	{
-		SubMeshData* subMeshDataHead = scene->GetSubMeshDataUploadBuffer()->GetBasePointer();
-		for (auto& entt : scene->GetComponentView<MeshFilterComponent>())
-		{
-			Entity entity(entt, scene);
-			const MeshFilterComponent& meshFilter = entity.GetComponent<MeshFilterComponent>();
-			const TransformComponent& transform = entity.GetComponent<TransformComponent>();
-
-			SubMeshData* meshFilterSubMeshDataStart = subMeshDataHead + meshFilter.subMeshDataOffset;
-
-			std::span<SubMeshData> subMeshDataSpan(meshFilterSubMeshDataStart, meshFilter.subMeshCount);
-			std::for_each(subMeshDataSpan.begin(), subMeshDataSpan.end(), [&](SubMeshData& subMeshData) {
-				subMeshData.modelMatrix = transform.modelMatrix;
-			});
-		}
+		access.Read<MeshFilterComponent>().Read<TransformComponent>().ReadResource(SystemResources::ChangedTransforms)
+			.WriteResource(SystemResources::SubMeshData)
+			.WriteResource(SystemResources::MeshFilterBounds);
+	}
 
+	void MeshFilterSystem::OnUpdate(float dt)
+	{
+		RHI::UploadBuffer<SubMeshData>* subMeshDataBuffer = scene->GetSubMeshDataUploadBuffer().get();
+		scene->GetMeshFilterTracker().WriteChangedTransforms(scene->GetChangedTransforms(), subMeshDataBuffer->GetBasePointer(),
+			subMeshDataBuffer->GetDirtyRangeTracker());
 	}
 }
@@ -0,0 +1,81 @@
+#include "SystemScheduler.h"
+
+#include "../../Core/Timer.h"
+#include "../../Core/TracyWrapper.h"
+
+namespace Wiley {
+
+	ISystem* SystemScheduler::AddSystem(ISystem::Ptr system)
+	{
+		Entry entry;
+		entry.system = std::move(system);
+		entries.push_back(std::move(entry));
+		isGraphDirty = true;
+		return entries.back().system.get();
+	}
+
+	void SystemScheduler::Rebuild()
+	{
+		TraceZoneN("SystemScheduler::Rebuild");
+
+		graph.Clear();
+
+		for (auto& entry : entries)
+		{
+			entry.access = SystemAccess();
+			entry.system->DeclareAccess(entry.access);
+			entry.dependencies.clear();
+		}
+
+		for (uint32_t index = 0; index < entries.size(); index++)
+		{
+			const TaskGraph::NodeID node = graph.AddNode([this, index]() { RunSystem(index); }, entries[index].system->GetName());
+
+			//Node ids follow registration order, so every earlier system already has its node.
+			for (uint32_t earlier = 0; earlier < index; earlier++)
+			{
+				if (!entries[earlier].access.ConflictsWith(entries[index].access))
+					continue;
+				entries[index].dependencies.push_back(earlier);
+				graph.AddEdge(earlier, node);
+			}
+		}
+
+		isGraphDirty = false;
+	}
+
+	void SystemScheduler::Run(float dt, ThreadPool& pool)
+	{
+		TraceZoneN("SystemScheduler::Run");
+
+		if (isGraphDirty)
+			Rebuild();
+
+		frameDt = dt;
+		profilerParent = CPUProfiler::GetCurrentNode();
+		graph.Run(pool);
+	}
+
+	void SystemScheduler::RunSystem(uint32_t index)
+	{
+		TraceZoneN("SystemScheduler::RunSystem");
+
+		Entry& entry = entries[index];
+		const auto start = CPUTimer::HRClock::now();
+		{
+			ScopedCPUTimer timer(entry.system->GetName(), profilerParent);
+			entry.system->OnUpdate(frameDt);
+		}
+		entry.lastMs = std::chrono::duration<double, std::milli>(CPUTimer::HRClock::now() - start).count();
+	}
+
+	std::vector<SystemTiming> SystemScheduler::GetTimings()const
+	{
+		std::vector<SystemTiming> timings;
+		timings.reserve(entries.size());
+		for (const auto& entry : entries)
+			timings.push_back({ entry.system->GetName(), entry.lastMs });
+		return timings;
+	}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "ISystem.h"
+
+#include "../../Core/TaskGraph.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace Wiley {
+
+	struct SystemTiming
+	{
+		const char* name = "";
+		double lastMs = 0.0;
+	};
+
+	/// <summary>
+	///		Owns the scene's systems and runs them on the thread pool as a dependency graph built from their declared access.
+	///		A system depends on every earlier registered system it conflicts with, so registration order decides who goes first
+	///		and systems with disjoint access run concurrently. The graph is rebuilt whenever the set of systems changes.
+	///		Each system is also timed under the caller's CPUProfiler scope.
+	/// </summary>
+	class SystemScheduler
+	{
+	public:
+		SystemScheduler() = default;
+
+		ISystem* AddSystem(ISystem::Ptr system);
+
+		/// <summary>
+		///		Runs every system once and returns when all of them have finished. Not reentrant.
+		/// </summary>
+		void Run(float dt, ThreadPool& pool = gThreadPool);
+
+		size_t GetSystemCount()const { return entries.size(); }
+		ISystem* GetSystem(size_t index)const { return entries[index].system.get(); }
+
+		/// <summary>
+		///		Indices of the systems that must finish before system index starts. Updated on the next Run after a change.
+		/// </summary>
+		const std::vector<uint32_t>& GetDependencies(size_t index)const { return entries[index].dependencies; }
+
+		/// <summary>
+		///		Wall time of each system in the last Run, in registration order.
+		/// </summary>
+		std::vector<SystemTiming> GetTimings()const;
+
+	private:
+		void Rebuild();
+		void RunSystem(uint32_t index);
+
+	private:
+		struct Entry
+		{
+			ISystem::Ptr system;
+			SystemAccess access;
+			std::vector<uint32_t> dependencies;
+			double lastMs = 0.0;
+		};
+
+		std::vector<Entry> entries;
+		TaskGraph graph;
+		bool isGraphDirty = true;
+
+		//Per-run state read by the graph's jobs.
+		float frameDt = 0.0f;
+		uint32_t profilerParent = 0;
+	};
+
+}
@@ -2,46 +2,155 @@
 #include "../Entity.h"
 #include "../Component.h"
 
+#include "../../Core/Parallel.h"
+#include "../../Core/TransformBatch.h"
 
+#include <algorithm>
 
 namespace Wiley
 {
+    namespace {
+
+        //Transforms composed per task. Sized so the gathered streams and matrices stay on the stack.
+        constexpr size_t kComposeChunk = 128;
+
+        /// <summary>
+        ///     Gathers a run of TransformComponents into the structure-of-arrays layout ComposeTransforms reads.
+        /// </summary>
+        struct TransformGather
+        {
+            float position[3][kComposeChunk];
+            float rotation[3][kComposeChunk];
+            float scale[3][kComposeChunk];
+
+            void Set(size_t index, const TransformComponent& transform)
+            {
+                position[0][index] = transform.position.x;
+                position[1][index] = transform.position.y;
+                position[2][index] = transform.position.z;
+                rotation[0][index] = transform.rotation.x;
+                rotation[1][index] = transform.rotation.y;
+                rotation[2][index] = transform.rotation.z;
+                scale[0][index] = transform.scale.x;
+                scale[1][index] = transform.scale.y;
+                scale[2][index] = transform.scale.z;
+            }
+
+            TransformStreams GetStreams()const
+            {
+                return TransformStreams{
+                    position[0], position[1], position[2],
+                    rotation[0], rotation[1], rotation[2],
+                    scale[0], scale[1], scale[2]
+                };
+            }
+        };
+    }
+
+	void TransformSystem::DeclareAccess(SystemAccess& access)const
+	{
+		access.Write<TransformComponent>().Read<HierarchyComponent>().WriteResource(SystemResources::ChangedTransforms);
+	}
+
 	void TransformSystem::OnUpdate(float dt)
 	{
-        for (auto& entt : scene->GetComponentView<TransformComponent>())
+        Update(scene->GetRegistry());
+	}
+
+	void TransformSystem::Update(entt::registry& registry)
+	{
+        auto transforms = registry.view<TransformComponent>();
+        auto hierarchy = registry.view<HierarchyComponent>();
+
+        changedEntities.clear();
+        for (auto& level : levels)
+            level.clear();
+
+        auto pushToLevel = [this](entt::entity entt, uint32_t depth) {
+            if (depth >= levels.size())
+                levels.resize(depth + 1);
+            levels[depth].push_back(entt);
+        };
+
+        //Seed every level with the entities that were mutated since the last update.
+        for (auto [entt, transform] : transforms.each())
+        {
+            if (!transform.isDirty)
+                continue;
+            pushToLevel(entt, hierarchy.contains(entt) ? hierarchy.get<HierarchyComponent>(entt).depth : 0);
+        }
+
+        //levels can grow while we walk it, children of the deepest dirty level land one past the end.
+        for (size_t depth = 0; depth < levels.size(); depth++)
         {
-            Entity entity(entt, scene);
-            auto& transform = entity.GetComponent<TransformComponent>();
-
-            float rx = DirectX::XMConvertToRadians(transform.rotation.x);
-            float ry = DirectX::XMConvertToRadians(transform.rotation.y);
-            float rz = DirectX::XMConvertToRadians(transform.rotation.z);
-
-            DirectX::XMMATRIX scaleMatrix =
-                DirectX::XMMatrixScaling(
-                    transform.scale.x,
-                    transform.scale.y,
-                    transform.scale.z
-                );
-
-            DirectX::XMMATRIX rotationMatrix =
-                DirectX::XMMatrixRotationX(rx) *
-                DirectX::XMMatrixRotationY(ry) *
-                DirectX::XMMatrixRotationZ(rz);
-
-            DirectX::XMMATRIX translationMatrix =
-                DirectX::XMMatrixTranslation(
-                    transform.position.x,
-                    transform.position.y,
-                    transform.position.z
-                );
-             
-            DirectX::XMMATRIX model =
-                translationMatrix *   
-                rotationMatrix *      
-                scaleMatrix;          
-            
-            DirectX::XMStoreFloat4x4(&transform.modelMatrix, DirectX::XMMatrixTranspose(model));
+            //An entity can be queued twice, once as dirty itself and once through its parent. Only the first one counts.
+            levelBatch.clear();
+            for (entt::entity entt : levels[depth])
+            {
+                auto& transform = transforms.get<TransformComponent>(entt);
+                if (!transform.isDirty)
+                    continue;
+                transform.isDirty = false;
+                levelBatch.push_back(entt);
+            }
+
+            //Every entity writes only its own matrix and reads its parent's, which was finished on an earlier level.
+            //Local matrices are composed a chunk at a time by the SIMD batch kernel, already in the stored (transposed) layout.
+            const size_t chunkCount = (levelBatch.size() + kComposeChunk - 1) / kComposeChunk;
+            ParallelFor(size_t(0), chunkCount, size_t(2), [this, &transforms, &hierarchy](size_t chunk)
+            {
+                const size_t begin = chunk * kComposeChunk;
+                const size_t count = std::min(kComposeChunk, levelBatch.size() - begin);
+
+                TransformGather gather;
+                for (size_t i = 0; i < count; i++)
+                    gather.Set(i, transforms.get<TransformComponent>(levelBatch[begin + i]));
+
+                DirectX::XMFLOAT4X4 localMatrices[kComposeChunk];
+                ComposeTransforms(gather.GetStreams(), count, localMatrices);
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    const entt::entity entt = levelBatch[begin + i];
+                    auto& transform = transforms.get<TransformComponent>(entt);
+                    transform.modelMatrix = localMatrices[i];
+
+                    if (!hierarchy.contains(entt))
+                        continue;
+
+                    const entt::entity parent = hierarchy.get<HierarchyComponent>(entt).parent;
+                    if (parent != entt::null && transforms.contains(parent))
+                    {
+                        //world = local * parentWorld, so its transpose is the parent's stored matrix times the local stored one.
+                        const auto& parentTransform = transforms.get<TransformComponent>(parent);
+                        DirectX::XMMATRIX world = DirectX::XMMatrixMultiply(
+                            DirectX::XMLoadFloat4x4(&parentTransform.modelMatrix),
+                            DirectX::XMLoadFloat4x4(&localMatrices[i])
+                        );
+                        DirectX::XMStoreFloat4x4(&transform.modelMatrix, world);
+                    }
+                }
+            });
+
+            //Children inherit the change whether or not they were touched themselves.
+            for (entt::entity entt : levelBatch)
+            {
+                if (!hierarchy.contains(entt))
+                    continue;
+
+                entt::entity child = hierarchy.get<HierarchyComponent>(entt).firstChild;
+                while (child != entt::null)
+                {
+                    if (transforms.contains(child))
+                    {
+                        transforms.get<TransformComponent>(child).isDirty = true;
+                        pushToLevel(child, static_cast<uint32_t>(depth + 1));
+                    }
+                    child = hierarchy.get<HierarchyComponent>(child).nextSibling;
+                }
+            }
+
+            changedEntities.insert(changedEntities.end(), levelBatch.begin(), levelBatch.end());
         }
 	}
 }
@@ -1,11 +1,21 @@
 #pragma once
 #include "ISystem.h"
 
+#include "entt.hpp"
+
 #include <memory>
+#include <vector>
+#include <span>
 
 namespace Wiley {
 
 	class Scene;
+
+	/// <summary>
+	///		Rebuilds world matrices for dirty transforms and everything below them in the hierarchy.
+	///		Dirty entities are bucketed by depth and processed one level at a time, so a parent's world matrix is final
+	///		before any child reads it. Entities within a level are independent and are composed in parallel.
+	/// </summary>
 	class TransformSystem : public ISystem {
 	public:
 		TransformSystem(Scene* scene)
@@ -14,7 +24,24 @@ namespace Wiley {
 
 		}
 		virtual void OnUpdate(float dt)override;
+		virtual void DeclareAccess(SystemAccess& access)const override;
+		virtual const char* GetName()const override { return "TransformSystem"; }
+
+		/// <summary>
+		///		One update over the transforms and hierarchy in registry. OnUpdate runs it on the scene's registry,
+		///		benchmarks run it on their own without building a Scene.
+		/// </summary>
+		void Update(entt::registry& registry);
+
+		/// <summary>
+		///		Entities whose world matrix changed in the last OnUpdate, parents before children.
+		///		Valid until the next OnUpdate.
+		/// </summary>
+		std::span<const entt::entity> GetChangedEntities()const { return changedEntities; }
 	private:
+		std::vector<std::vector<entt::entity>> levels;
+		std::vector<entt::entity> levelBatch;
+		std::vector<entt::entity> changedEntities;
 	};
 
-}
\ No newline at end of file
+}
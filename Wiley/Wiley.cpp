@@ -1,5 +1,5 @@
 #include "Engine/Engine.h"
-#include "Tracy/tracy/Tracy.hpp"
+#include "Core/TracyWrapper.h"
 
 #include <crtdbg.h>
 #include "../Core/MemoryLeakDetector.h"
@@ -40,7 +40,12 @@ int main()
 
     //MemoryLeakDetector::SetMemoryAllocBreak(2371);
 
-    tracy::SetThreadName("MainThread");
+    TraceThreadName("MainThread");
+
+    //Headless runs have no Tracy client, so the built-in recorder captures the whole run when a trace file is requested.
+    const char* traceFile = std::getenv("WILEY_TRACE_FILE");
+    if (traceFile)
+        gTraceRecorder.Start();
 
     ShowWindow(GetConsoleWindow(), SW_HIDE);
 
@@ -64,11 +69,17 @@ int main()
     size_t frameCount = 0;
     while (window->Tick([]{}))
     {
-        FrameMarkNamed("MainFrame");
+        TraceFrameMark("MainFrame");
 
         engine.OnUpdate();
         std::cout << frameCount++ << std::endl;
     }
 
+    if (traceFile)
+    {
+        gTraceRecorder.Stop();
+        gTraceRecorder.WriteChromeTrace(traceFile);
+    }
+
     //MemoryLeakDetector::DumpMemoryLeaks();
 }
\ No newline at end of file
@@ -34,6 +34,10 @@ local compute_scene_draw_pass = RenderPass.new()
 	--Input Resources
 
 	--Output Resources
+
+	--The instance lists hold the camera-culled groups followed by one unculled group per mesh for the shadow passes.
+	local max_instance_list_count = max_mesh_count * 2
+
 	compute_scene_draw_pass:create_buffer("UploadMeshFilterBuffer", mesh_filter_size * max_mesh_count, mesh_filter_size, buffer_usage.copy, true, buffer_usage.copy)
 	compute_scene_draw_pass:create_buffer("MeshFilterBuffer", mesh_filter_size * max_mesh_count, mesh_filter_size, buffer_usage.compute_storage, false, buffer_usage.compute_storage)
 
@@ -42,15 +46,15 @@ local compute_scene_draw_pass = RenderPass.new()
 	compute_scene_draw_pass:create_buffer("MeshCountBuffer", uint_size, uint_size, buffer_usage.compute_storage, true, buffer_usage.compute_storage)
 	compute_scene_draw_pass:create_buffer("ReadBackMeshCountBuffer", uint_size, uint_size, buffer_usage.read_back, true, buffer_usage.read_back)
 
-	compute_scene_draw_pass:create_buffer("UploadMeshInstanceBaseBuffer", mesh_instance_base_size * max_mesh_count, mesh_instance_base_size, buffer_usage.copy, true, buffer_usage.copy)
-	compute_scene_draw_pass:create_buffer("MeshInstanceBaseBuffer", mesh_instance_base_size * max_mesh_count, mesh_instance_base_size, buffer_usage.compute_storage, false, buffer_usage.compute_storage)
+	compute_scene_draw_pass:create_buffer("UploadMeshInstanceBaseBuffer", mesh_instance_base_size * max_instance_list_count, mesh_instance_base_size, buffer_usage.copy, true, buffer_usage.copy)
+	compute_scene_draw_pass:create_buffer("MeshInstanceBaseBuffer", mesh_instance_base_size * max_instance_list_count, mesh_instance_base_size, buffer_usage.compute_storage, false, buffer_usage.compute_storage)
 
-	compute_scene_draw_pass:create_buffer("UploadMeshInstanceIndexBuffer_PreOcclusion",uint_size * max_mesh_count, uint_size, buffer_usage.copy, true, buffer_usage.copy)
-	compute_scene_draw_pass:create_buffer("MeshInstanceIndexBuffer_PreOcclusion",uint_size * max_mesh_count,uint_size,buffer_usage.compute_storage,false,buffer_usage.compute_storage)
+	compute_scene_draw_pass:create_buffer("UploadMeshInstanceIndexBuffer_PreOcclusion",uint_size * max_instance_list_count, uint_size, buffer_usage.copy, true, buffer_usage.copy)
+	compute_scene_draw_pass:create_buffer("MeshInstanceIndexBuffer_PreOcclusion",uint_size * max_instance_list_count,uint_size,buffer_usage.compute_storage,false,buffer_usage.compute_storage)
 
-	compute_scene_draw_pass:create_buffer("MeshInstanceIndexBuffer_PostOcclusion",uint_size * max_mesh_count,uint_size,buffer_usage.compute_storage,false,buffer_usage.compute_storage)
-	compute_scene_draw_pass:create_buffer("ReadBackMeshInstanceIndexBuffer_PostOcclusion",uint_size * max_mesh_count,uint_size,buffer_usage.read_back,false,buffer_usage.read_back)
-	compute_scene_draw_pass:create_buffer("ReadBackMeshInstanceBaseBuffer", mesh_instance_base_size * max_mesh_count, mesh_instance_base_size, buffer_usage.read_back, true, buffer_usage.read_back)
+	compute_scene_draw_pass:create_buffer("MeshInstanceIndexBuffer_PostOcclusion",uint_size * max_instance_list_count,uint_size,buffer_usage.compute_storage,false,buffer_usage.compute_storage)
+	compute_scene_draw_pass:create_buffer("ReadBackMeshInstanceIndexBuffer_PostOcclusion",uint_size * max_instance_list_count,uint_size,buffer_usage.read_back,false,buffer_usage.read_back)
+	compute_scene_draw_pass:create_buffer("ReadBackMeshInstanceBaseBuffer", mesh_instance_base_size * max_instance_list_count, mesh_instance_base_size, buffer_usage.read_back, true, buffer_usage.read_back)
 
 
 	compute_scene_draw_pass:execute(compute_scene_draw_pass_function)